@@ -0,0 +1,227 @@
+/**
+ * @file BenchDesign.h
+ * @brief BenchDesign.h generates a synthetic EDA design for the benchmarks:
+ *     cells with a placed location (Composite), a bounding box (External) and pins (CompositeVector),
+ *     each pin with its shape points (nested CompositeVector), and nets connecting the pins.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "edadb.h"
+
+
+namespace bench {
+
+/**
+ * @class Box
+ * @brief The bounding box with private members, stored through edadb::Shadow<Box>.
+ */
+class Box {
+private:
+    int32_t llx_ = 0, lly_ = 0, urx_ = 0, ury_ = 0;
+
+public:
+    int32_t llx() const { return llx_; }
+    int32_t lly() const { return lly_; }
+    int32_t urx() const { return urx_; }
+    int32_t ury() const { return ury_; }
+    void set(int32_t llx, int32_t lly, int32_t urx, int32_t ury) {
+        llx_ = llx; lly_ = lly; urx_ = urx; ury_ = ury;
+    }
+}; // Box
+
+/**
+ * @struct Point
+ * @brief The placed location of the cell.
+ */
+struct Point {
+    int32_t x = 0;
+    int32_t y = 0;
+};
+
+/**
+ * @struct ShapePt
+ * @brief The vertex of the pin shape, the id is unique in the design.
+ */
+struct ShapePt {
+    int64_t id = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+};
+
+/**
+ * @struct Pin
+ * @brief The pin of the cell, the name is "cell/pin".
+ */
+struct Pin {
+    std::string          name;
+    int32_t              layer = 0;
+    bool                 output = false;
+    std::vector<ShapePt> shape;
+};
+
+/**
+ * @struct Cell
+ * @brief The cell instance.
+ */
+struct Cell {
+    std::string      name;
+    std::string      master;
+    int32_t          orient = 0;
+    double           power = 0;
+    Point            loc;
+    Box              bbox;
+    std::vector<Pin> pins;
+};
+
+/**
+ * @struct NetConn
+ * @brief The connection of the net to a pin, the id is unique in the design.
+ */
+struct NetConn {
+    int64_t     id = 0;
+    std::string pin;
+};
+
+/**
+ * @struct Net
+ * @brief The net connecting the pins.
+ */
+struct Net {
+    std::string          name;
+    double               weight = 1.0;
+    std::vector<NetConn> conns;
+};
+
+} // namespace bench
+
+
+namespace edadb {
+
+template<>
+class Shadow<bench::Box> {
+public:
+    int32_t llx = 0, lly = 0, urx = 0, ury = 0;
+
+public:
+    void fromShadow(bench::Box *b) { b->set(llx, lly, urx, ury); }
+    void toShadow(bench::Box *b) {
+        llx = b->llx(); lly = b->lly(); urx = b->urx(); ury = b->ury();
+    }
+};
+
+} // namespace edadb
+
+TABLE4EXTERNALCLASS(bench::Box, "box", (llx, lly, urx, ury));
+TABLE4CLASS(bench::Point, "point", (x, y));
+TABLE4CLASS(bench::ShapePt, "shape_pt", (id, x, y));
+TABLE4CLASS_WVEC(bench::Pin, "pin", (name, layer, output), (shape));
+TABLE4CLASS_WVEC(bench::Cell, "cell", (name, master, orient, power, loc, bbox), (pins));
+TABLE4CLASS(bench::NetConn, "net_conn", (id, pin));
+TABLE4CLASS_WVEC(bench::Net, "net", (name, weight), (conns));
+
+
+namespace bench {
+
+/**
+ * @struct DesignParams
+ * @brief The size of the generated design.
+ */
+struct DesignParams {
+    size_t   cells = 10000;       // number of cells
+    size_t   pins_per_cell = 4;   // pins of each cell
+    size_t   shape_points = 4;    // shape points of each pin
+    size_t   nets = 10000;        // number of nets
+    size_t   fanout = 4;          // pins connected by each net
+    uint64_t seed = 1;            // random seed, the same seed generates the same design
+};
+
+/**
+ * @class Design
+ * @brief The generated design, the objects are owned here and referenced by the pointer vectors.
+ */
+class Design {
+private:
+    std::vector<Cell> cells;
+    std::vector<Net>  nets;
+
+public:
+    /**
+     * @brief generate the design.
+     * @param p The design parameters.
+     */
+    explicit Design(const DesignParams &p) {
+        std::mt19937_64 rng(p.seed);
+        std::uniform_int_distribution<int32_t> coord(0, 1000000);
+        std::uniform_int_distribution<int32_t> small(1, 2000);
+        int64_t next_id = 1;
+
+        cells.resize(p.cells);
+        for (size_t c = 0; c < p.cells; ++c) {
+            Cell &cell = cells[c];
+            cell.name   = "c" + std::to_string(c);
+            cell.master = "M" + std::to_string(rng() % 64);
+            cell.orient = static_cast<int32_t>(rng() % 8);
+            cell.power  = static_cast<double>(rng() % 100000) * 1e-3;
+            cell.loc.x  = coord(rng);
+            cell.loc.y  = coord(rng);
+            cell.bbox.set(cell.loc.x, cell.loc.y,
+                cell.loc.x + small(rng), cell.loc.y + small(rng));
+
+            cell.pins.resize(p.pins_per_cell);
+            for (size_t i = 0; i < p.pins_per_cell; ++i) {
+                Pin &pin = cell.pins[i];
+                pin.name   = cell.name + "/p" + std::to_string(i);
+                pin.layer  = static_cast<int32_t>(rng() % 10);
+                pin.output = (i == 0);
+                pin.shape.resize(p.shape_points);
+                for (auto &pt : pin.shape) {
+                    pt.id = next_id++;
+                    pt.x  = cell.loc.x + small(rng);
+                    pt.y  = cell.loc.y + small(rng);
+                }
+            } // for
+        } // for
+
+        const size_t total_pins = p.cells * p.pins_per_cell;
+        nets.resize(p.nets);
+        for (size_t n = 0; n < p.nets; ++n) {
+            Net &net = nets[n];
+            net.name   = "n" + std::to_string(n);
+            net.weight = 1.0 + static_cast<double>(rng() % 4);
+            if (total_pins == 0) continue;
+
+            net.conns.resize(p.fanout);
+            for (auto &conn : net.conns) {
+                const size_t k = rng() % total_pins;
+                conn.id  = next_id++;
+                conn.pin = cells[k / p.pins_per_cell].pins[k % p.pins_per_cell].name;
+            }
+        } // for
+    } // Design
+
+public:
+    std::vector<Cell> &getCells() { return cells; }
+    std::vector<Net>  &getNets () { return nets;  }
+
+    /**
+     * @brief get the pointers of the objects in [begin, end), as the edadb vector API takes.
+     */
+    template <typename T>
+    static std::vector<T*> pointers(std::vector<T> &objs, size_t begin = 0, size_t end = SIZE_MAX) {
+        end = std::min(end, objs.size());
+        std::vector<T*> ptrs;
+        ptrs.reserve(end > begin ? end - begin : 0);
+        for (size_t i = begin; i < end; ++i) {
+            ptrs.push_back(&objs[i]);
+        }
+        return ptrs;
+    }
+}; // Design
+
+} // namespace bench
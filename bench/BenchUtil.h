@@ -0,0 +1,190 @@
+/**
+ * @file BenchUtil.h
+ * @brief BenchUtil.h provides the timer, the latency percentiles and the JSON report of the benchmarks.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <sys/stat.h>
+
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @class Latency
+ * @brief Record the latency of each operation to get the percentiles.
+ */
+class Latency {
+private:
+    std::vector<double> us; // latency of each operation in microseconds
+    Clock::time_point   start;
+
+public:
+    void begin() { start = Clock::now(); }
+    void end() {
+        us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    size_t count() const { return us.size(); }
+
+    /**
+     * @brief get the percentile by the nearest rank.
+     * @param p The percentile in [0, 100].
+     * @return The latency in microseconds; 0 if no operation.
+     */
+    double percentile(double p) {
+        if (us.empty()) return 0;
+        std::sort(us.begin(), us.end());
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * us.size()));
+        rank = std::min(std::max<size_t>(rank, 1), us.size());
+        return us[rank - 1];
+    }
+}; // Latency
+
+
+/**
+ * @struct Result
+ * @brief The result of a benchmark case.
+ */
+struct Result {
+    std::string name;
+    std::string unit;        // the operation of the latency, such as "batch", "row", "lookup"
+    uint64_t    rows = 0;    // rows (objects) processed
+    double      seconds = 0; // wall time of the case
+    double      p50_us = 0;
+    double      p99_us = 0;
+    uint64_t    ops = 0;     // operations in the latency percentiles
+    bool        ok = true;
+
+    double rowsPerSec() const { return (seconds > 0) ? rows / seconds : 0; }
+}; // Result
+
+
+/**
+ * @brief get the size of the file.
+ * @return The size in bytes; 0 if not exists.
+ */
+inline uint64_t fileSize(const std::string &path) {
+    struct stat st;
+    return (::stat(path.c_str(), &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+
+/**
+ * @class Options
+ * @brief Parse the options "--name=value" or "--name value".
+ */
+class Options {
+private:
+    std::vector<std::pair<std::string, std::string>> opts;
+
+public:
+    Options(int argc, char **argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--", 0) != 0) continue;
+            a = a.substr(2);
+
+            const size_t eq = a.find('=');
+            if (eq != std::string::npos) {
+                opts.emplace_back(a.substr(0, eq), a.substr(eq + 1));
+            } else if ((i + 1 < argc) && (std::string(argv[i + 1]).rfind("--", 0) != 0)) {
+                opts.emplace_back(a, argv[++i]);
+            } else {
+                opts.emplace_back(a, "1");
+            }
+        } // for
+    }
+
+    bool has(const std::string &name) const {
+        for (auto &o : opts) if (o.first == name) return true;
+        return false;
+    }
+
+    std::string get(const std::string &name, const std::string &def) const {
+        for (auto &o : opts) if (o.first == name) return o.second;
+        return def;
+    }
+
+    uint64_t getUint(const std::string &name, uint64_t def) const {
+        return has(name) ? std::strtoull(get(name, "").c_str(), nullptr, 10) : def;
+    }
+}; // Options
+
+
+/**
+ * @class JsonWriter
+ * @brief Write the flat JSON object, the nesting is closed in the reverse order.
+ */
+class JsonWriter {
+private:
+    std::ostream      &os;
+    std::vector<bool> first; // first member of each nesting level
+
+public:
+    explicit JsonWriter(std::ostream &o) : os(o) {}
+
+    JsonWriter &beginObject(const std::string &key = "") { open(key); os << "{"; first.push_back(true); return *this; }
+    JsonWriter &endObject() { first.pop_back(); os << "}"; return *this; }
+    JsonWriter &beginArray(const std::string &key) { open(key); os << "["; first.push_back(true); return *this; }
+    JsonWriter &endArray() { first.pop_back(); os << "]"; return *this; }
+
+    JsonWriter &value(const std::string &key, const std::string &v) {
+        open(key); os << quote(v); return *this;
+    }
+    JsonWriter &value(const std::string &key, const char *v) {
+        return value(key, std::string(v));
+    }
+    JsonWriter &value(const std::string &key, bool v) {
+        open(key); os << (v ? "true" : "false"); return *this;
+    }
+    JsonWriter &value(const std::string &key, uint64_t v) {
+        open(key); os << v; return *this;
+    }
+    JsonWriter &value(const std::string &key, double v) {
+        open(key);
+        if (std::isfinite(v)) os << v; else os << "null";
+        return *this;
+    }
+    JsonWriter &null(const std::string &key) {
+        open(key); os << "null"; return *this;
+    }
+
+private:
+    void open(const std::string &key) {
+        if (!first.empty()) {
+            if (!first.back()) os << ",";
+            first.back() = false;
+        }
+        if (!key.empty()) os << quote(key) << ":";
+    }
+
+    static std::string quote(const std::string &s) {
+        std::ostringstream o;
+        o << '"';
+        for (char c : s) {
+            switch (c) {
+            case '"':  o << "\\\""; break;
+            case '\\': o << "\\\\"; break;
+            case '\n': o << "\\n";  break;
+            case '\t': o << "\\t";  break;
+            default:   o << c;      break;
+            }
+        }
+        o << '"';
+        return o.str();
+    }
+}; // JsonWriter
+
+} // namespace bench
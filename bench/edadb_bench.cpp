@@ -0,0 +1,257 @@
+/**
+ * @file edadb_bench.cpp
+ * @brief edadb_bench.cpp runs the end-to-end benchmarks on a synthetic design
+ *     and reports rows/s, p50/p99 latency and the database size as JSON.
+ *
+ * usage: edadb_bench [--cells N] [--pins N] [--shape N] [--nets N] [--fanout N]
+ *                    [--batch N] [--lookups N] [--seed N] [--db FILE] [--json FILE]
+ *                    [--op_stats]   dump the per-operation statistics to stderr
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+
+#include "edadb.h"
+#include "BenchDesign.h"
+#include "BenchUtil.h"
+
+using namespace bench;
+
+namespace {
+
+const char *backendName() {
+    switch (edadb::Config::backend_type) {
+    case edadb::DbBackendType::SQLITE: return "sqlite";
+    case edadb::DbBackendType::DUCKDB: return "duckdb";
+    case edadb::DbBackendType::MEMORY: return "memory";
+    default:                           return "unknown";
+    }
+}
+
+/**
+ * @brief run the writer in batches of the objects, one transaction per batch.
+ * @param name The case name.
+ * @param objs The objects.
+ * @param batch The batch size.
+ * @param write The writer on the batch pointers, returns false if failed.
+ */
+template <typename T, typename Func>
+Result runBatches(const std::string &name, std::vector<T> &objs, size_t batch, Func write) {
+    Result r;
+    r.name = name;
+    r.unit = "batch";
+
+    Latency lat;
+    const Clock::time_point t0 = Clock::now();
+    for (size_t b = 0; r.ok && (b < objs.size()); b += batch) {
+        std::vector<T*> ptrs = Design::pointers(objs, b, b + batch);
+        lat.begin();
+        r.ok = write(ptrs);
+        lat.end();
+        r.rows += ptrs.size();
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.ops     = lat.count();
+    r.p50_us  = lat.percentile(50);
+    r.p99_us  = lat.percentile(99);
+    return r;
+} // runBatches
+
+/**
+ * @brief scan all objects, the latency is per object.
+ */
+template <typename T>
+Result runScan(const std::string &name, edadb::DbMap<T> &dbmap, uint64_t child_rows) {
+    Result r;
+    r.name = name;
+    r.unit = "row";
+
+    Latency lat;
+    typename edadb::DbMap<T>::Reader *reader = nullptr;
+    T obj;
+    const Clock::time_point t0 = Clock::now();
+    while (true) {
+        lat.begin();
+        const int got = edadb::read2Scan(reader, dbmap, &obj);
+        if (got <= 0) {
+            r.ok = (got == 0);
+            break;
+        }
+        lat.end();
+        ++r.rows;
+        obj = T(); // drop the child objects appended by the reader
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.rows   += r.rows * child_rows;
+    r.ops     = lat.count();
+    r.p50_us  = lat.percentile(50);
+    r.p99_us  = lat.percentile(99);
+    return r;
+} // runScan
+
+/**
+ * @brief read the objects by the primary key in the random order, the latency is per lookup.
+ * @param child_rows The child rows read with each object, counted in the rows.
+ */
+template <typename T>
+Result runLookups(const std::string &name, edadb::DbMap<T> &dbmap, const std::vector<T> &objs,
+        size_t lookups, uint64_t seed, uint64_t child_rows) {
+    Result r;
+    r.name = name;
+    r.unit = "lookup";
+    if (objs.empty()) return r;
+
+    std::mt19937_64 rng(seed);
+    Latency lat;
+    const Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; r.ok && (i < lookups); ++i) {
+        T obj;
+        obj.name = objs[rng() % objs.size()].name;
+        lat.begin();
+        r.ok = (edadb::readByPrimaryKey(dbmap, &obj) > 0);
+        lat.end();
+        r.rows += 1 + child_rows;
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.ops     = lat.count();
+    r.p50_us  = lat.percentile(50);
+    r.p99_us  = lat.percentile(99);
+    return r;
+} // runLookups
+
+void writeResult(JsonWriter &j, const Result &r) {
+    j.beginObject()
+        .value("name", r.name)
+        .value("ok", r.ok)
+        .value("rows", r.rows)
+        .value("seconds", r.seconds)
+        .value("rows_per_sec", r.rowsPerSec())
+        .value("latency_unit", r.unit)
+        .value("ops", r.ops)
+        .value("p50_us", r.p50_us)
+        .value("p99_us", r.p99_us)
+    .endObject();
+}
+
+} // namespace
+
+
+int main(int argc, char **argv) {
+    const Options opt(argc, argv);
+
+    DesignParams p;
+    p.cells         = opt.getUint("cells",  p.cells);
+    p.pins_per_cell = opt.getUint("pins",   p.pins_per_cell);
+    p.shape_points  = opt.getUint("shape",  p.shape_points);
+    p.nets          = opt.getUint("nets",   p.nets);
+    p.fanout        = opt.getUint("fanout", p.fanout);
+    p.seed          = opt.getUint("seed",   p.seed);
+    const size_t batch   = std::max<uint64_t>(opt.getUint("batch", 1000), 1);
+    const size_t lookups = opt.getUint("lookups", 2000);
+    const std::string db_file = opt.get("db", "edadb_bench.db");
+    const std::string json    = opt.get("json", "");
+    const bool op_stats       = opt.has("op_stats");
+
+    std::remove(db_file.c_str());
+    std::remove((db_file + "-wal").c_str());
+    if (!edadb::initDatabase(db_file)) {
+        std::cerr << "edadb_bench: init database " << db_file << " failed" << std::endl;
+        return 1;
+    }
+
+    Design design(p);
+    std::vector<Cell> &cells = design.getCells();
+    std::vector<Net>  &nets  = design.getNets();
+
+    edadb::DbMap<Cell> cell_map;
+    edadb::DbMap<Net>  net_map;
+    if (!edadb::createTable(cell_map) || !edadb::createTable(net_map)) {
+        std::cerr << "edadb_bench: create table failed" << std::endl;
+        return 1;
+    }
+
+    // rows of the child tables read with each object
+    const uint64_t cell_child_rows = p.pins_per_cell * (1 + p.shape_points);
+    const uint64_t net_child_rows  = p.fanout;
+
+    edadb::enableOpStats(op_stats);
+
+    std::vector<Result> results;
+    results.push_back(runBatches("insert_cells", cells, batch,
+        [&](std::vector<Cell*> &v) { return edadb::insertVector(cell_map, v); }));
+    results.back().rows += results.back().rows * cell_child_rows;
+    results.push_back(runBatches("insert_nets", nets, batch,
+        [&](std::vector<Net*> &v) { return edadb::insertVector(net_map, v); }));
+    results.back().rows += results.back().rows * net_child_rows;
+
+    const uint64_t db_size = fileSize(db_file) + fileSize(db_file + "-wal");
+
+    results.push_back(runScan("scan_cells", cell_map, cell_child_rows));
+    results.push_back(runScan("scan_nets", net_map, net_child_rows));
+    results.push_back(runLookups("read_pk_nets", net_map, nets, lookups, p.seed, net_child_rows));
+    results.push_back(runLookups("read_children_cells", cell_map, cells, lookups, p.seed,
+        cell_child_rows));
+
+    for (auto &c : cells) {
+        c.power += 1.0;
+        for (auto &pin : c.pins) pin.layer = (pin.layer + 1) % 10;
+    }
+    results.push_back(runBatches("update_cells", cells, batch,
+        [&](std::vector<Cell*> &v) { return edadb::updateVector(cell_map, v); }));
+    results.back().rows += results.back().rows * cell_child_rows;
+
+    results.push_back(runBatches("delete_cells", cells, batch,
+        [&](std::vector<Cell*> &v) {
+            edadb::DbMap<Cell>::Writer writer(cell_map);
+            return edadb::beginTransaction() && writer.deleteVector(v)
+                && edadb::commitTransaction();
+        }));
+    results.back().rows += results.back().rows * cell_child_rows;
+
+
+    // report
+    std::ofstream file;
+    if (!json.empty()) {
+        file.open(json);
+        if (!file) {
+            std::cerr << "edadb_bench: open " << json << " failed" << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &os = json.empty() ? std::cout : file;
+
+    JsonWriter j(os);
+    j.beginObject()
+        .value("backend", backendName())
+        .beginObject("params")
+            .value("cells", static_cast<uint64_t>(p.cells))
+            .value("pins_per_cell", static_cast<uint64_t>(p.pins_per_cell))
+            .value("shape_points", static_cast<uint64_t>(p.shape_points))
+            .value("nets", static_cast<uint64_t>(p.nets))
+            .value("fanout", static_cast<uint64_t>(p.fanout))
+            .value("batch", static_cast<uint64_t>(batch))
+            .value("lookups", static_cast<uint64_t>(lookups))
+            .value("seed", p.seed)
+        .endObject();
+    if (edadb::Config::backend_type == edadb::DbBackendType::MEMORY) {
+        j.null("db_size_bytes");
+    } else {
+        j.value("db_size_bytes", db_size);
+    }
+
+    bool ok = true;
+    j.beginArray("results");
+    for (auto &r : results) {
+        writeResult(j, r);
+        ok = ok && r.ok;
+    }
+    j.endArray().endObject();
+    os << std::endl;
+
+    if (op_stats) {
+        edadb::dumpOpStats(std::cerr);
+    }
+
+    return ok ? 0 : 1;
+} // main
@@ -0,0 +1,36 @@
+# explicit instantiation of the mapped types, see include/edadb/ExternTemplate.h
+#
+# edadb_add_instantiations(<name> HEADER <header> TYPES <type>...)
+#   add the object library <name> instantiating DbMap<type> once for each type,
+#   one source file per type so the types are compiled in parallel.
+#   The header maps the types by TABLE4CLASS and declares EDADB_EXTERN_TEMPLATE(type) for each,
+#   the targets including the header link <name> to get the instantiations:
+#
+#     edadb_add_instantiations(design_types HEADER ${CMAKE_CURRENT_SOURCE_DIR}/Design.h
+#         TYPES design::Cell design::Pin design::Net)
+#     target_link_libraries(flow PRIVATE design_types)
+function(edadb_add_instantiations name)
+    cmake_parse_arguments(ARG "" "HEADER" "TYPES" ${ARGN})
+    if(NOT ARG_HEADER OR NOT ARG_TYPES)
+        message(FATAL_ERROR "edadb_add_instantiations: HEADER and TYPES are required")
+    endif()
+    get_filename_component(header ${ARG_HEADER} ABSOLUTE)
+
+    set(sources)
+    set(index 0)
+    foreach(type ${ARG_TYPES})
+        # written to .in first, copied only if changed to keep the objects up to date
+        set(src ${CMAKE_CURRENT_BINARY_DIR}/${name}/instantiate_${index}.cpp)
+        file(WRITE ${src}.in
+            "// generated by edadb_add_instantiations, do not edit\n"
+            "#include \"edadb.h\"\n"
+            "#include \"${header}\"\n\n"
+            "EDADB_INSTANTIATE_TEMPLATE(${type});\n")
+        configure_file(${src}.in ${src} COPYONLY)
+        list(APPEND sources ${src})
+        math(EXPR index "${index} + 1")
+    endforeach()
+
+    add_library(${name} OBJECT ${sources})
+    target_link_libraries(${name} PUBLIC edadb)
+endfunction()
@@ -8,6 +8,9 @@
 #include <cstddef>
 #include <memory>
 #include <bitset>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
 
 #include <boost/mpl/bool.hpp>
 #include <boost/mpl/range_c.hpp>
@@ -36,7 +39,19 @@
 #include "edadb/backend/sqlite/DbStatement4Sqlite.h"
 #include "edadb/DbManager.h"
 #include "edadb/backend/sqlite/DbManager4Sqlite.h"
+#if defined(EDADB_BACKEND_DUCKDB) && EDADB_BACKEND_DUCKDB
+#include "edadb/backend/duckdb/SqlStatement4Duckdb.h"
+#include "edadb/backend/duckdb/DbStatement4Duckdb.h"
+#include "edadb/backend/duckdb/DbManager4Duckdb.h"
+#endif
+#if defined(EDADB_BACKEND_MEMORY) && EDADB_BACKEND_MEMORY
+#include "edadb/backend/memory/SqlStatement4Memory.h"
+#include "edadb/backend/memory/DbStatement4Memory.h"
+#include "edadb/backend/memory/DbManager4Memory.h"
+#endif
 #include "edadb/DbMapAll.h"
+#include "edadb/AsyncReadPool.h"
+#include "edadb/ExternTemplate.h"
 
 
 namespace edadb {
@@ -57,6 +72,81 @@ bool initDatabase(const std::string& dbName) {
     return res;
 }
 
+/**
+ * @brief Initialize the in-memory database loaded from the file,
+ *     the changes are persisted to the file by saveDatabase or the auto save timer only.
+ * @param dbName The database file name.
+ * @return true if success; otherwise, false.
+ */
+inline
+bool initDatabaseInMemory(const std::string& dbName) {
+    bool res = false;
+    if ((res = DbMapBase::i().initInMemory(dbName)) == false) {
+        std::cerr << "DbMap::initInMemory failed" << std::endl;
+        return res;
+    }
+    return res;
+}
+
+/**
+ * @brief Initialize the database in WAL mode: one writer connection and the pool of read connections,
+ *     the reads go on while writing and the WAL is checkpointed by the background thread.
+ * @param dbName The database file name.
+ * @param readers The number of the read connections kept in the pool.
+ * @return true if success; otherwise, false.
+ */
+inline
+bool initDatabaseWal(const std::string& dbName, size_t readers = Config::wal_reader_connections) {
+    bool res = false;
+    if ((res = DbMapBase::i().initWal(dbName, readers)) == false) {
+        std::cerr << "DbMap::initWal failed" << std::endl;
+        return res;
+    }
+    return res;
+}
+
+/**
+ * @brief Checkpoint the WAL now without waiting for the readers.
+ * @return true if success; otherwise, false.
+ */
+inline
+bool checkpointDatabase() {
+    return DbMapBase::i().getManager().checkpoint();
+}
+
+/**
+ * @brief Save the in-memory database back to the file step by step.
+ * @return true if success; otherwise, false.
+ */
+inline
+bool saveDatabase() {
+    return DbMapBase::i().save();
+}
+
+/**
+ * @brief Save the in-memory database in the background thread.
+ * @return The future of the save result.
+ */
+inline
+std::future<bool> saveDatabaseAsync() {
+    return DbMapBase::i().getManager().saveAsync();
+}
+
+/**
+ * @brief Save the in-memory database periodically in the timer thread.
+ * @param interval The interval between the saves.
+ * @return true if started; otherwise, false.
+ */
+inline
+bool startAutoSave(std::chrono::milliseconds interval) {
+    return DbMapBase::i().getManager().startAutoSave(interval);
+}
+
+inline
+void stopAutoSave() {
+    DbMapBase::i().getManager().stopAutoSave();
+}
+
 inline
 bool executeSql(const std::string& sql) {
     return DbMapBase::i().executeSql(sql);
@@ -72,15 +162,180 @@ bool commitTransaction() {
     return DbMapBase::i().commitTransaction();
 }
 
+inline
+bool rollbackTransaction() {
+    return DbMapBase::i().rollbackTransaction();
+}
+
+/**
+ * @brief Run the function in a transaction, rolled back if the function or the commit fails,
+ *     so the caller can retry the whole transaction when lastError().retryable().
+ * @param db The Database handle or the DbMap whose database runs the transaction.
+ * @param func The function returning true if success.
+ * @return true if committed; otherwise, false with the error of the failed call kept.
+ */
+template <typename Db, typename Func>
+bool runInTransaction(Db &db, Func func) {
+    if (!db.beginTransaction()) {
+        return false;
+    }
+    if (func() && db.commitTransaction()) {
+        return true;
+    }
+
+    const DbError err = lastError();
+    db.rollbackTransaction();
+    setLastError(err.code, err.backend_code, err.message);
+    return false;
+} // runInTransaction
+
+/**
+ * @brief Run the function in a transaction of the default database.
+ */
+template <typename Func>
+bool runInTransaction(Func func) {
+    return runInTransaction(DbMapBase::i(), func);
+} // runInTransaction
+
 inline
 bool tableExists(const std::string& table_name) {
     return DbMapBase::i().tableExists(table_name);
 }
 
+/**
+ * @brief Enable or disable the per-operation statistics,
+ *     the statements prepared afterwards are recorded.
+ */
+inline
+void enableOpStats(bool on) {
+    OpStats::enable(on);
+}
+
+/**
+ * @brief Get the counters and the latency percentiles of the operations per table.
+ */
+inline
+std::vector<OpStatsSnapshot> snapshotOpStats() {
+    return OpStats::i().snapshot();
+}
+
+inline
+void resetOpStats() {
+    OpStats::i().reset();
+}
+
+/**
+ * @brief Dump the operation statistics as a text table or a JSON array.
+ */
+inline
+void dumpOpStats(std::ostream &os, bool json = false) {
+    if (json) {
+        OpStats::i().dumpJson(os);
+    } else {
+        OpStats::i().dumpText(os);
+    }
+}
+
+/**
+ * @brief Enable or disable the SQL trace at runtime.
+ * @param on true to trace the statements.
+ * @param sample_every Trace 1 of every sample_every statements.
+ */
+inline
+void enableSqlTrace(bool on, uint32_t sample_every = 1) {
+    SqlTrace::setSampleEvery(sample_every);
+    SqlTrace::enable(on);
+}
+
+/**
+ * @brief Set the sink called with each traced statement, such as SqlTrace::stdoutSink(),
+ *     nullptr to keep the recent statements in the ring buffer only.
+ */
+inline
+void setSqlTraceSink(SqlTrace::Sink sink) {
+    SqlTrace::i().setSink(std::move(sink));
+}
+
+/**
+ * @brief Get the recent traced statements from the oldest to the newest.
+ */
+inline
+std::vector<SqlTraceRecord> recentSqlTrace(size_t n = SqlTrace::s_ring_size) {
+    return SqlTrace::i().recent(n);
+}
+
+/**
+ * @brief Enable or disable the slow query log, the statements prepared afterwards
+ *     are labeled with the table and the DbMap operation.
+ * @param on true to record the slow queries.
+ * @param threshold The default threshold; the current one if negative.
+ */
+inline
+void enableSlowQueryLog(bool on,
+        std::chrono::nanoseconds threshold = std::chrono::nanoseconds(-1)) {
+    if (threshold.count() >= 0) {
+        SlowQueryLog::i().setThreshold(threshold);
+    }
+    SlowQueryLog::enable(on);
+}
+
+/**
+ * @brief Set the threshold of the DbMap operation, such as "QueryForeignKey",
+ *     overriding the default threshold; negative to remove the override.
+ */
+inline
+void setSlowQueryThreshold(const std::string &op, std::chrono::nanoseconds threshold) {
+    SlowQueryLog::i().setThreshold(op, threshold);
+}
+
+/**
+ * @brief Set the sink called with each slow query, such as SlowQueryLog::stderrSink().
+ */
+inline
+void setSlowQuerySink(SlowQueryLog::Sink sink) {
+    SlowQueryLog::i().setSink(std::move(sink));
+}
+
+/**
+ * @brief Get the recent slow queries from the oldest to the newest.
+ */
+inline
+std::vector<SlowQueryRecord> recentSlowQueries() {
+    return SlowQueryLog::i().recent();
+}
+
+/**
+ * @brief Set the wait for the database lock before a call fails with DbErrorCode::BUSY.
+ * @param timeout The total wait of a lock event, 0 to fail at once.
+ * @param initial The first backoff, doubled on each retry up to max.
+ * @param max The max backoff.
+ */
+inline
+void setBusyPolicy(std::chrono::milliseconds timeout,
+        std::chrono::microseconds initial = std::chrono::microseconds(Config::busy_backoff_initial_us),
+        std::chrono::microseconds max = std::chrono::microseconds(Config::busy_backoff_max_us)) {
+    BusyRetry::i().setPolicy(timeout, initial, max);
+}
+
+/**
+ * @brief Get the number of the busy events, retries and timeouts, and the time waiting for the locks.
+ */
+inline
+LockWaitStats lockWaitStats() {
+    return BusyRetry::i().snapshot();
+}
+
+inline
+void resetLockWaitStats() {
+    BusyRetry::i().reset();
+}
+
 
 
 /**
  * @brief Create the table for the class. Otherwise, need to call initDbMap first.
+ *     The statements are skipped if the schema fingerprint stored is unchanged,
+ *     the existing tables are altered in place or rebuilt to the generated columns.
  * @param dbmap The database map to create the table.
  * @param self_txn If true, the function will begin a transaction and commit it after the creation.
  * @return true if success; otherwise, false.
@@ -88,12 +343,85 @@ bool tableExists(const std::string& table_name) {
 template<typename T>
 bool createTable(DbMap<T> &dbmap, bool self_txn = true) {
     if (self_txn) {
-        return beginTransaction() && dbmap.createTable() && commitTransaction();
+        return runInTransaction(dbmap, [&] { return dbmap.createSchema(); });
     } else {
-        return dbmap.createTable();
+        return dbmap.createSchema();
     }
 } // createTable
 
+/**
+ * @brief Diff the columns generated for the table and its child tables with the tables on disk,
+ *     nothing is changed; createTable applies the changes.
+ * @param dbmap The database map of the root table.
+ * @return The changed tables; empty if the schema is up to date.
+ */
+template<typename T>
+std::vector<SchemaDiff> diffSchema(DbMap<T> &dbmap) {
+    std::vector<SchemaDiff> diffs;
+    if (!dbmap.init() || !dbmap.evolveSchema(diffs, false)) {
+        std::cerr << "edadb::diffSchema: failed" << std::endl;
+        diffs.clear();
+    }
+    return diffs;
+} // diffSchema
+
+/**
+ * @brief Create the index on the member column to serve ordered scan and pagination.
+ * @param dbmap The database map of the table.
+ * @param member The scalar member variable name.
+ * @return true if success; otherwise, false.
+ */
+template<typename T>
+bool createIndex(DbMap<T> &dbmap, const std::string &member) {
+    return dbmap.createIndex(member);
+} // createIndex
+
+/**
+ * @brief Explain the query plans of the statements generated for the table and its child tables.
+ * @param dbmap The database map of the root table, the table must be created.
+ * @return The reports, one per statement; empty if the backend cannot explain.
+ */
+template<typename T>
+std::vector<QueryPlanReport> explainQueryPlans(DbMap<T> &dbmap) {
+    std::vector<QueryPlanReport> reports;
+    if (!dbmap.explainQueryPlans(reports)) {
+        reports.clear();
+    }
+    return reports;
+} // explainQueryPlans
+
+/**
+ * @brief Check the hot operations are served by the index, as a startup self-check.
+ *     Warn for each hot operation with a full scan, an automatic index or a temporary sort.
+ * @param dbmap The database map of the root table.
+ * @param fail true to return false on any warning; otherwise, only warn.
+ * @param hot_ops The operation names to check, such as DbMapOpTrait<T, OP>::name().
+ * @param os The stream of the warnings.
+ * @return false if the plans cannot be explained, or fail is true and any warning; otherwise, true.
+ */
+template<typename T>
+bool checkQueryPlans(DbMap<T> &dbmap, bool fail = false,
+        const std::vector<std::string> &hot_ops =
+            {"QueryForeignKey", "QueryPrimaryKey", "QueryPrimaryKeys", "Update", "Delete"},
+        std::ostream &os = std::cerr) {
+    std::vector<QueryPlanReport> reports;
+    if (!dbmap.explainQueryPlans(reports)) {
+        return false;
+    }
+
+    size_t warnings = 0;
+    for (const auto &r : reports) {
+        const bool hot = std::find(hot_ops.begin(), hot_ops.end(), r.op) != hot_ops.end();
+        if (hot && (!r.indexBacked() || r.temp_btree)) {
+            os << "edadb::checkQueryPlans: warning: " << r.table << " [" << r.op << "] "
+               << (r.indexBacked() ? "sorts by a temporary b-tree" : "is not index-backed") << "\n";
+            r.print(os);
+            ++warnings;
+        }
+    }
+    return !(fail && (warnings > 0));
+} // checkQueryPlans
+
 /**
  * @brief Drop the table for the class.
  * @tparam T The class type.
@@ -113,9 +441,7 @@ template <typename T>
 bool insertObject(DbMap<T> &dbmap, T* obj, bool self_txn = true) {
     typename DbMap<T>::Writer writer(dbmap);
     if (self_txn) {
-        return beginTransaction() 
-            && writer.insertOne(obj) 
-            && commitTransaction();
+        return runInTransaction(dbmap, [&] { return writer.insertOne(obj); });
     } else {
         return writer.insertOne(obj);
     }
@@ -130,14 +456,30 @@ template <typename T>
 bool insertVector(DbMap<T> &dbmap, std::vector<T*>& obj_vec, bool self_txn = true) {
     typename DbMap<T>::Writer writer(dbmap); 
     if (self_txn) {
-        return beginTransaction() 
-            && writer.insertVector(obj_vec) 
-            && commitTransaction();
+        return runInTransaction(dbmap, [&] { return writer.insertVector(obj_vec); });
     } else {
         return writer.insertVector(obj_vec);
     }
 } // insertVector
 
+/**
+ * @brief Insert the object vector by the pipeline: the worker threads encode the objects
+ *     into rows in parallel, the calling thread binds the rows and steps in the input order.
+ * @param obj_vec The object pointer vector to insert, not modified until returned.
+ * @param num_threads The number of the encoding threads, 0 for hardware concurrency - 1.
+ * @return true if success; otherwise, false.
+ */
+template <typename T>
+bool insertVectorPipelined(DbMap<T> &dbmap, std::vector<T*>& obj_vec, size_t num_threads = 0,
+        bool self_txn = true) {
+    typename DbMap<T>::Writer writer(dbmap);
+    if (self_txn) {
+        return runInTransaction(dbmap, [&] { return writer.insertVectorPipelined(obj_vec, num_threads); });
+    } else {
+        return writer.insertVectorPipelined(obj_vec, num_threads);
+    }
+} // insertVectorPipelined
+
 
 /**
  * @brief DbMapWriter: This is a type alias for the DbMap Writer class.
@@ -158,9 +500,7 @@ template <typename T>
 int updateObject(DbMap<T> &dbmap, T* obj, bool self_txn = true) { 
     typename DbMap<T>::Writer writer(dbmap);
     if (self_txn) {
-        return beginTransaction() 
-            && writer.updateOne(obj) 
-            && commitTransaction();
+        return runInTransaction(dbmap, [&] { return writer.updateOne(obj); });
     } else {
         return writer.updateOne(obj);
     }
@@ -170,9 +510,7 @@ template <typename T>
 bool updateVector(DbMap<T> &dbmap, std::vector<T*>& objs, bool self_txn = true) {
     typename DbMap<T>::Writer writer(dbmap);
     if (self_txn) {
-        return beginTransaction() 
-            && writer.updateVector(objs) 
-            && commitTransaction();
+        return runInTransaction(dbmap, [&] { return writer.updateVector(objs); });
     } else {
         return writer.updateVector(objs);
     } 
@@ -188,9 +526,7 @@ template <typename T>
 bool deleteObject(DbMap<T> &dbmap, T* obj, bool self_txn = true) {
     typename DbMap<T>::Writer writer(dbmap);
     if (self_txn) {
-        return beginTransaction() 
-            && writer.deleteOne(obj) 
-            && commitTransaction();
+        return runInTransaction(dbmap, [&] { return writer.deleteOne(obj); });
     } else {
         return writer.deleteOne(obj);
     }
@@ -230,12 +566,14 @@ int readGeneric( typename edadb::DbMap<T>::Reader*& reader, DbMap<T>& dbmap, T*
 
     // read until no more row
     bool ok = reader->read(obj);
+    bool failed = false;
     if (!ok) {
+        failed = reader->fetchFailed();
         reader->finalize();
         delete reader;
         reader = nullptr;
     }
-    return ok ? 1 : 0;
+    return ok ? 1 : (failed ? -1 : 0);
 } // readGeneric
 
 
@@ -271,6 +609,245 @@ int readByPredicate(typename edadb::DbMap<T>::Reader*& reader, DbMap<T>& dbmap,
 }
 
 
+/**
+ * @fn read2OrderedScan
+ * @brief read the object from the database ordered by the member column.
+ * @param reader The reader to read the object.
+ * @param obj The object to read.
+ * @param member The scalar member to order by, empty to order by primary key,
+ *     the NULL member columns come last in both orders.
+ * @param order The sort order.
+ * @return int Returns 1 if read successfully, 0 if no more row, -1 if error.
+ */
+template <typename T>
+int read2OrderedScan(typename edadb::DbMap<T>::Reader*& reader, DbMap<T>& dbmap, T* obj,
+            const std::string& member, SortOrder order = SortOrder::ASC) {
+    return readGeneric(reader, dbmap, obj,
+        [&](auto& r) { return r.prepareOrderedScan(member, order); }
+    );
+}
+
+
+/**
+ * @fn readVectorGeneric
+ * @brief generic read function to read all the objects of the prepared reader.
+ * @param dbmap The database map to read the objects.
+ * @param objs The objects read, which are allocated by new and owned by the caller.
+ * @param prepare The prepare function to prepare the reader.
+ * @param conn The connection to read on, nullptr for the default of the Reader.
+ * @return int Returns the number of objects read, -1 if error.
+ */
+template <typename T, typename PrepareFunc>
+int readVectorGeneric(DbMap<T>& dbmap, std::vector<T*>& objs, PrepareFunc prepare,
+        typename DbManager::Connection conn = nullptr) {
+    typename edadb::DbMap<T>::Reader reader(dbmap, conn);
+    if (!prepare(reader)) {
+        std::cerr << "DbMap::Reader::prepare failed" << std::endl;
+        reader.finalize();
+        return -1;
+    }
+
+    int count = 0;
+    T *obj = new T();
+    while (reader.read(obj)) {
+        objs.push_back(obj);
+        obj = new T();
+        ++count;
+    }
+    delete obj;
+
+    const bool failed = reader.fetchFailed();
+    reader.finalize();
+    return failed ? -1 : count;
+} // readVectorGeneric
+
+
+/**
+ * @fn readVectorOnSnapshot
+ * @brief read all the objects of the table on a connection of the snapshot,
+ *     the tables loaded in parallel on the connections of one snapshot read the same commit.
+ * @param dbmap The database map to read the objects.
+ * @param objs The objects read, which are allocated by new and owned by the caller.
+ * @param snap The snapshot pinning the read connections.
+ * @param i The connection index used by the calling thread only.
+ * @return int Returns the number of objects read, -1 if error.
+ */
+template <typename T>
+int readVectorOnSnapshot(DbMap<T>& dbmap, std::vector<T*>& objs, const ReadSnapshot& snap, size_t i) {
+    if (!snap.valid() || (i >= snap.size())) {
+        std::cerr << "readVectorOnSnapshot: invalid snapshot connection" << std::endl;
+        return -1;
+    }
+    return readVectorGeneric(dbmap, objs,
+        [](auto& r) { return r.prepare2Scan(); }, snap.connection(i)
+    );
+}
+
+
+/**
+ * @fn readPage
+ * @brief read the next page of objects using keyset pagination.
+ * @param dbmap The database map to read the objects.
+ * @param after The last object of the previous page, nullptr for the first page.
+ * @param limit The page size.
+ * @param objs The objects read, which are allocated by new and owned by the caller.
+ * @param member The scalar member to order by, empty to order by primary key,
+ *     the NULL member columns come last in both orders.
+ * @param order The sort order.
+ * @return int Returns the number of objects read, 0 if no more page, -1 if error.
+ */
+template <typename T>
+int readPage(DbMap<T>& dbmap, T* after, uint64_t limit, std::vector<T*>& objs,
+            const std::string& member = "", SortOrder order = SortOrder::ASC) {
+    bool nulls_next = false;
+    const int n = readVectorGeneric(dbmap, objs,
+        [&](auto& r) { return r.prepareKeysetPage(after, limit, member, order, &nulls_next); }
+    );
+    if ((n < 0) || !nulls_next || (static_cast<uint64_t>(n) == limit)) {
+        return n;
+    }
+
+    // the NULL member columns come last: fill the short page from the start of the NULL run
+    const int m = readVectorGeneric(dbmap, objs,
+        [&](auto& r) { return r.prepareKeysetNullRun(limit - n, member, order); }
+    );
+    return (m < 0) ? -1 : (n + m);
+}
+
+
+/**
+ * @fn readTopK
+ * @brief read the top K objects ordered by the member column.
+ * @param dbmap The database map to read the objects.
+ * @param member The scalar member to order by, the NULL member columns come last in both orders.
+ * @param k The number of objects to read.
+ * @param objs The objects read, which are allocated by new and owned by the caller.
+ * @param order The sort order, default is DESC to get the largest K objects.
+ * @return int Returns the number of objects read, -1 if error.
+ */
+template <typename T>
+int readTopK(DbMap<T>& dbmap, const std::string& member, uint64_t k, std::vector<T*>& objs,
+            SortOrder order = SortOrder::DESC) {
+    return readVectorGeneric(dbmap, objs,
+        [&](auto& r) { return r.prepareTopK(member, k, order); }
+    );
+}
+
+
+/**
+ * @fn parallelScan
+ * @brief scan the table in parallel, partitioned by rowid ranges.
+ *     Each worker thread reads on its own read connection, all pinned to the same commit.
+ *     The private in-memory database, such as ":memory:", is scanned serially on the main connection.
+ * @param dbmap The database map to scan.
+ * @param func The callback bool(size_t worker, T *obj) called in the worker thread,
+ *     the obj is only valid during the call; return false to stop the scan.
+ * @param num_threads The number of worker threads, 0 for hardware concurrency.
+ * @return int64_t Returns the number of objects scanned, -1 if error.
+ */
+template <typename T, typename Func>
+int64_t parallelScan(DbMap<T> &dbmap, Func func, size_t num_threads = 0) {
+    ParallelScanner<T> scanner(dbmap, num_threads);
+    return scanner.scan(func);
+}
+
+/**
+ * @brief scan the table in parallel on the snapshot shared with the other scans,
+ *     one worker thread per connection of the snapshot.
+ */
+template <typename T, typename Func>
+int64_t parallelScan(DbMap<T> &dbmap, ReadSnapshot &snap, Func func) {
+    ParallelScanner<T> scanner(dbmap, snap);
+    return scanner.scan(func);
+}
+
+
+/**
+ * @fn exportColumns
+ * @brief export the member columns of all rows to struct-of-arrays buffers,
+ *     without constructing the objects.
+ * @param dbmap The database map to export.
+ * @param bufs The buffers, one per member.
+ * @param members The scalar member pointers, such as &T::x, &T::y.
+ * @return int64_t Returns the number of rows exported, -1 if error.
+ */
+template <typename T, typename... Vs>
+int64_t exportColumns(DbMap<T> &dbmap, std::tuple<ColumnBuffer<Vs>...> &bufs, Vs T::*... members) {
+    return dbmap.exportColumns(bufs, members...);
+}
+
+
+/**
+ * @fn importCsv
+ * @brief import the CSV or delimited file in a streaming way,
+ *     parsed in a producer thread and inserted in batches with bounded memory.
+ * @param dbmap The database map to import.
+ * @param path The delimited file path, the header names the columns by default.
+ * @param opts The delimiter, batch and commit options.
+ * @param self_txn If true, commit every opts.commit_rows rows; otherwise, the caller owns the transaction.
+ * @return int64_t Returns the number of rows imported, -1 if error.
+ */
+template <typename T>
+int64_t importCsv(DbMap<T> &dbmap, const std::string &path,
+        const CsvOptions &opts = CsvOptions(), bool self_txn = true) {
+    CsvImporter<T> importer(dbmap, opts);
+    return importer.importFile(path, self_txn);
+}
+
+
+/**
+ * @fn exportSnapshot
+ * @brief export the table and all the child tables to the memory-mappable snapshot file.
+ *     The tables are read in one savepoint to get a consistent snapshot,
+ *     or in one transaction if the backend has no savepoint, so DuckDB cannot export in a transaction.
+ * @param dbmap The database map to export.
+ * @param path The snapshot file path, replaced only if the export succeeds.
+ * @return bool Returns true if exported, false if error.
+ */
+template <typename T>
+bool exportSnapshot(DbMap<T> &dbmap, const std::string &path) {
+    SnapshotWriter writer;
+    if (!writer.open(path)) {
+        return false;
+    }
+
+    const bool savepoint = DbManager::s_has_savepoint;
+    if (!dbmap.executeSql(savepoint ? "SAVEPOINT edadb_snapshot;" : "BEGIN TRANSACTION;")) {
+        writer.abort();
+        return false;
+    }
+
+    bool ok = dbmap.writeSnapshot(writer);
+    ok = dbmap.executeSql(savepoint ? "RELEASE edadb_snapshot;" : "COMMIT;") && ok;
+    if (!ok) {
+        std::cerr << "exportSnapshot: export " << path << " failed" << std::endl;
+        writer.abort();
+        return false;
+    }
+    return writer.close();
+}
+
+
+/**
+ * @fn loadSnapshot
+ * @brief materialize all the objects of the table from the snapshot file,
+ *     the child vectors are filled from the child tables in the snapshot.
+ *     Use Snapshot directly to access the columns in place without materialization.
+ * @param dbmap The database map to load.
+ * @param path The snapshot file path written by exportSnapshot.
+ * @param objs The objects read, allocated by new and owned by the caller.
+ * @return int64_t Returns the number of objects read, -1 if error.
+ */
+template <typename T>
+int64_t loadSnapshot(DbMap<T> &dbmap, const std::string &path, std::vector<T*> &objs) {
+    Snapshot snap;
+    if (!snap.open(path)) {
+        return -1;
+    }
+    return dbmap.readSnapshot(snap, objs);
+}
+
+
 /**
  * @fn readByPrimaryKey
  * @brief read the object from the database by primary key.
@@ -296,4 +873,157 @@ int readByPrimaryKey(DbMap<T> &dbmap, T* obj) {
     return ok ? 1 : -1;
 }
 
+
+/**
+ * @fn readByPrimaryKeys
+ * @brief read the objects by a batch of primary keys.
+ *     The keys are bound in chunks of Config::pk_batch_size using "pk IN (?, ...)",
+ *     so one statement is prepared for all the keys instead of one per key.
+ * @param dbmap The database map to read the objects.
+ * @param keys The primary keys to read, duplicated keys are allowed and read once per occurrence.
+ * @param objs The objects read in the input order, objs[i] is nullptr if keys[i] is missing.
+ *     The objects are allocated by new and owned by the caller, one distinct object per position.
+ * @param missing If not nullptr, the indexes of the missing keys in the input order.
+ * @return int Returns the number of keys found, -1 if error.
+ */
+template <typename T>
+int readByPrimaryKeys(DbMap<T> &dbmap, const std::vector<typename DbMap<T>::PkType> &keys,
+        std::vector<T*> &objs, std::vector<size_t> *missing = nullptr) {
+    using PkType = typename DbMap<T>::PkType;
+
+    // group the input positions by the unique keys
+    std::unordered_map<PkType, std::vector<size_t>> key_pos;
+    std::vector<PkType> uniq_keys;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto &pos = key_pos[keys[i]];
+        if (pos.empty())
+            uniq_keys.push_back(keys[i]);
+        pos.push_back(i);
+    }
+
+    objs.assign(keys.size(), nullptr);
+    if (missing != nullptr) missing->clear();
+    if (uniq_keys.empty()) return 0;
+
+    typename edadb::DbMap<T>::Reader reader(dbmap);
+    const size_t batch = std::min(uniq_keys.size(), Config::pk_batch_size);
+    if (!reader.prepareByPrimaryKeys(batch)) {
+        std::cerr << "DbMap::Reader::prepareByPrimaryKeys: prepare failed" << std::endl;
+        return -1;
+    }
+
+    // the duplicated keys are read again in the next round,
+    // so each position owns its own object instead of a shallow copy
+    int found = 0;
+    bool ok = true;
+    std::vector<PkType> round_keys = std::move(uniq_keys);
+    while (ok && !round_keys.empty()) {
+        std::vector<PkType> again;
+        for (size_t b = 0; ok && (b < round_keys.size()); b += batch) {
+            const size_t n = std::min(batch, round_keys.size() - b);
+            if (!(ok = reader.bindPrimaryKeys(&round_keys[b], n))) {
+                std::cerr << "DbMap::Reader::bindPrimaryKeys: bind failed" << std::endl;
+                break;
+            }
+
+            // rows come back in index order, place them by the key positions
+            T *obj = new T();
+            while (reader.read(obj)) {
+                auto it = key_pos.find(*DbMap<T>::getPrimaryKey(obj));
+                if ((it != key_pos.end()) && !it->second.empty()) {
+                    objs[it->second.back()] = obj;
+                    it->second.pop_back();
+                    ++found;
+                    if (!it->second.empty())
+                        again.push_back(it->first);
+                    obj = new T();
+                }
+            } // while
+            delete obj;
+            ok = !reader.fetchFailed();
+        } // for
+        round_keys.swap(again);
+    } // while
+
+    reader.finalize();
+
+    if (missing != nullptr) {
+        for (size_t i = 0; i < objs.size(); ++i) {
+            if (objs[i] == nullptr) missing->push_back(i);
+        }
+    }
+    return ok ? found : -1;
+}
+
+
+/**
+ * @fn readByPrimaryKeyAsync
+ * @brief read the object by primary key on the async read pool without blocking the caller.
+ * @param pool The pool of the database of dbmap.
+ * @param dbmap The database map to read the object, must outlive the read.
+ * @param key The object with the primary key set, copied.
+ * @return The handle of the object read, the value is empty if not found.
+ */
+template <typename T>
+AsyncHandle<std::optional<T>> readByPrimaryKeyAsync(AsyncReadPool &pool, DbMap<T> &dbmap, const T &key) {
+    if (&pool.getManager() != &dbmap.getManager()) {
+        std::cerr << "readByPrimaryKeyAsync: the pool is not of the database of the DbMap" << std::endl;
+        return AsyncHandle<std::optional<T>>::rejected();
+    }
+    return pool.readByPrimaryKey(dbmap, key);
+}
+
+template <typename T>
+AsyncHandle<std::optional<T>> readByPrimaryKeyAsync(DbMap<T> &dbmap, const T &key) {
+    return readByPrimaryKeyAsync(AsyncReadPool::defaultPool(), dbmap, key);
+}
+
+
+/**
+ * @fn scanAsync
+ * @brief scan the table on the async read pool, the objects are handed to the callback
+ *     on the worker thread.
+ * @param pool The pool of the database of dbmap.
+ * @param dbmap The database map to scan, must outlive the scan.
+ * @param func The callback bool(T *obj), the obj is only valid during the call;
+ *     return false to stop the scan.
+ * @return The handle of the number of objects scanned.
+ */
+template <typename T, typename Func>
+AsyncHandle<int64_t> scanAsync(AsyncReadPool &pool, DbMap<T> &dbmap, Func func) {
+    if (&pool.getManager() != &dbmap.getManager()) {
+        std::cerr << "scanAsync: the pool is not of the database of the DbMap" << std::endl;
+        return AsyncHandle<int64_t>::rejected();
+    }
+    return pool.scan(dbmap, func);
+}
+
+template <typename T, typename Func>
+AsyncHandle<int64_t> scanAsync(DbMap<T> &dbmap, Func func) {
+    return scanAsync(AsyncReadPool::defaultPool(), dbmap, func);
+}
+
+
+/**
+ * @fn queryAsync
+ * @brief read the objects matching the predicate on the async read pool.
+ * @param pool The pool of the database of dbmap.
+ * @param dbmap The database map to read, must outlive the read.
+ * @param predicate The WHERE clause without WHERE, such as "power > 1".
+ * @return The handle of the objects read.
+ */
+template <typename T>
+AsyncHandle<std::vector<T>> queryAsync(AsyncReadPool &pool, DbMap<T> &dbmap, const std::string &predicate) {
+    if (&pool.getManager() != &dbmap.getManager()) {
+        std::cerr << "queryAsync: the pool is not of the database of the DbMap" << std::endl;
+        return AsyncHandle<std::vector<T>>::rejected();
+    }
+    return pool.query(dbmap, predicate);
+}
+
+template <typename T>
+AsyncHandle<std::vector<T>> queryAsync(DbMap<T> &dbmap, const std::string &predicate) {
+    return queryAsync(AsyncReadPool::defaultPool(), dbmap, predicate);
+}
+
 } // namespace edadb
\ No newline at end of file
@@ -0,0 +1,379 @@
+/**
+ * @file AsyncReadPool.h
+ * @brief AsyncReadPool.h provides the asynchronous reads returning std::future,
+ *     so the event loop of a UI or script front-end is not blocked by the database.
+ * @note The reads are queued to the worker threads, each reads on its own read connection.
+ *     The queue is bounded, the read submitted to the full queue is rejected at once instead of waiting.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <algorithm>
+
+#include <boost/noncopyable.hpp>
+
+#include "DbError.h"
+#include "DbManager.h"
+#include "Database.h"
+#include "BoundedQueue.h"
+#include "DbMap.h"
+#include "DbMapReader.h"
+
+
+namespace edadb {
+
+
+/**
+ * @enum AsyncStatus
+ * @brief The completion status of the asynchronous read.
+ */
+enum class AsyncStatus : uint8_t {
+    OK = 0,
+    CANCELLED,  // cancelled before or while running, the value is empty
+    REJECTED,   // the queue is full or the pool is stopped, not run
+    FAILED      // the read failed, see the error
+}; // AsyncStatus
+
+
+/**
+ * @struct AsyncResult
+ * @brief The value and the status of the asynchronous read.
+ * @tparam R The value type.
+ */
+template <typename R>
+struct AsyncResult {
+    AsyncStatus status = AsyncStatus::OK;
+    R           value{};
+    DbError     error;    // the last error of the worker if failed
+
+    bool ok() const { return status == AsyncStatus::OK; }
+}; // AsyncResult
+
+
+/**
+ * @class AsyncHandle
+ * @brief The future of the asynchronous read, which can be cancelled.
+ *     The read not started yet completes as CANCELLED without running,
+ *     the running scan stops at the next row.
+ * @tparam R The value type.
+ */
+template <typename R>
+class AsyncHandle {
+private:
+    std::future<AsyncResult<R>>        fut;
+    std::shared_ptr<std::atomic<bool>> cancel_flag;
+
+public:
+    AsyncHandle() = default;
+    AsyncHandle(std::future<AsyncResult<R>> &&f, std::shared_ptr<std::atomic<bool>> c)
+        : fut(std::move(f)), cancel_flag(std::move(c)) {}
+
+    /**
+     * @brief The handle completed as REJECTED, such as the read not submitted.
+     */
+    static AsyncHandle rejected() {
+        std::promise<AsyncResult<R>> promise;
+        AsyncResult<R> res;
+        res.status = AsyncStatus::REJECTED;
+        promise.set_value(std::move(res));
+        return AsyncHandle(promise.get_future(), nullptr);
+    }
+
+public:
+    void cancel() {
+        if (cancel_flag) {
+            cancel_flag->store(true);
+        }
+    }
+
+    bool valid() const {
+        return fut.valid();
+    }
+
+    /**
+     * @brief Check if completed without blocking, such as polled by the event loop.
+     */
+    bool ready() const {
+        return fut.valid() &&
+            (fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    }
+
+    void wait() const {
+        fut.wait();
+    }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period> &d) const {
+        return fut.wait_for(d);
+    }
+
+    /**
+     * @brief Wait and get the result, once only.
+     */
+    AsyncResult<R> get() {
+        return fut.get();
+    }
+
+    std::future<AsyncResult<R>> &future() {
+        return fut;
+    }
+}; // AsyncHandle
+
+
+/**
+ * @class AsyncReadPool
+ * @brief The worker threads reading the database on their own read connections.
+ *     The DbMap read by the pool must outlive the reads submitted,
+ *     and the pool must be destroyed before its database.
+ *     The database may be closed and reopened, such as another file, while no read is running:
+ *     the workers reopen their read connections on the next read.
+ */
+class AsyncReadPool : public boost::noncopyable {
+private:
+    using Connection = DbManager::Connection;
+
+    // the task runs on the read connection of the worker, or completes as REJECTED if nullptr
+    using Task = std::function<void(Connection)>;
+
+    DbManager                &manager;
+    BoundedQueue<Task>        queue;
+    std::vector<std::thread>  workers;
+    std::atomic<size_t>       in_flight{0}; // queued and running
+
+public:
+    /**
+     * @brief ctor starts the workers.
+     * @param m The database.
+     * @param num_threads The number of the worker threads, 0 for hardware concurrency.
+     * @param capacity The max reads queued, the reads submitted beyond are rejected.
+     */
+    AsyncReadPool(DbManager &m, size_t num_threads = 0, size_t capacity = 256)
+        : manager(m), queue(capacity)
+    {
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    AsyncReadPool(Database &db, size_t num_threads = 0, size_t capacity = 256)
+        : AsyncReadPool(db.getManager(), num_threads, capacity) {}
+
+    /**
+     * @brief dtor stops accepting the reads, runs the reads queued and joins the workers,
+     *     cancel the reads before to return quickly.
+     */
+    ~AsyncReadPool() {
+        queue.close();
+        for (auto &t : workers) {
+            t.join();
+        }
+    }
+
+    /**
+     * @brief The pool of the default database, created on the first use.
+     */
+    static AsyncReadPool &defaultPool() {
+        static AsyncReadPool pool(DbManager::i());
+        return pool;
+    }
+
+    DbManager &getManager() { return manager; }
+
+    /**
+     * @brief The number of the reads queued and running.
+     */
+    size_t inFlight() const {
+        return in_flight.load();
+    }
+
+
+public:
+    /**
+     * @brief Submit the read running on a read connection of the pool.
+     * @param func The read void(Connection, const std::atomic<bool> &cancelled, AsyncResult<R> &res),
+     *     which sets the value of res, or the status if cancelled or failed.
+     * @return The handle of the read, completed as REJECTED at once if the queue is full,
+     *     the database is not connected, or it cannot be opened by the read connections, such as ":memory:".
+     *     The read queued is also REJECTED if the database is closed before it runs.
+     */
+    template <typename R, typename Func>
+    AsyncHandle<R> submit(Func func) {
+        if (!manager.isConnected()) {
+            std::cerr << "AsyncReadPool::submit: the database is not connected" << std::endl;
+            return AsyncHandle<R>::rejected();
+        }
+        if (!manager.canOpenReadConnection()) {
+            std::cerr << "AsyncReadPool::submit: the private in-memory database "
+                "cannot be read by the read connections" << std::endl;
+            return AsyncHandle<R>::rejected();
+        }
+
+        auto flag = std::make_shared<std::atomic<bool>>(false);
+        auto promise = std::make_shared<std::promise<AsyncResult<R>>>();
+        AsyncHandle<R> handle(promise->get_future(), flag);
+
+        Task task = [this, func, flag, promise](Connection conn) mutable {
+            AsyncResult<R> res;
+            if (conn == nullptr) {
+                res.status = AsyncStatus::REJECTED;
+            }
+            else if (flag->load()) {
+                res.status = AsyncStatus::CANCELLED;
+            }
+            else {
+                clearLastError();
+                func(conn, *flag, res);
+                if (res.status == AsyncStatus::FAILED) {
+                    res.error = lastError();
+                }
+            }
+            --in_flight;
+            promise->set_value(std::move(res));
+        };
+
+        ++in_flight;
+        if (!queue.tryPush(std::move(task))) {
+            --in_flight;
+            return AsyncHandle<R>::rejected();
+        }
+        return handle;
+    } // submit
+
+
+    /**
+     * @brief Read the object by the primary key.
+     * @param dbmap The database map to read.
+     * @param key The object with the primary key set.
+     * @return The handle of the object read, the value is empty if not found.
+     */
+    template <typename T>
+    AsyncHandle<std::optional<T>> readByPrimaryKey(DbMap<T> &dbmap, const T &key) {
+        return submit<std::optional<T>>(
+            [&dbmap, key](Connection conn, const std::atomic<bool> &, AsyncResult<std::optional<T>> &res) {
+                typename DbMap<T>::Reader reader(dbmap, conn);
+                T obj(key);
+                if (!reader.prepareByPrimaryKey(&obj)) {
+                    res.status = AsyncStatus::FAILED;
+                    return;
+                }
+                if (reader.read(&obj)) {
+                    res.value = std::move(obj);
+                } else if (reader.fetchFailed()) {
+                    res.status = AsyncStatus::FAILED;
+                }
+                reader.finalize();
+            });
+    } // readByPrimaryKey
+
+    /**
+     * @brief Scan the table and hand each object to the callback on the worker thread.
+     * @param dbmap The database map to scan.
+     * @param func The callback bool(T *obj), the obj is only valid during the call;
+     *     return false to stop the scan.
+     * @return The handle of the number of objects scanned.
+     */
+    template <typename T, typename Func>
+    AsyncHandle<int64_t> scan(DbMap<T> &dbmap, Func func) {
+        return submit<int64_t>(
+            [&dbmap, func](Connection conn, const std::atomic<bool> &cancelled, AsyncResult<int64_t> &res) mutable {
+                typename DbMap<T>::Reader reader(dbmap, conn);
+                if (!reader.prepare2Scan()) {
+                    res.status = AsyncStatus::FAILED;
+                    return;
+                }
+
+                T obj{};
+                while (reader.read(&obj)) {
+                    if (cancelled.load()) {
+                        res.status = AsyncStatus::CANCELLED;
+                        break;
+                    }
+                    ++res.value;
+                    if (!func(&obj)) break;
+                    obj = T{};
+                }
+                if (reader.fetchFailed()) {
+                    res.status = AsyncStatus::FAILED;
+                }
+                reader.finalize();
+            });
+    } // scan
+
+    /**
+     * @brief Read the objects matching the predicate.
+     * @param dbmap The database map to read.
+     * @param predicate The WHERE clause without WHERE, such as "power > 1".
+     * @return The handle of the objects read, empty if cancelled or failed.
+     */
+    template <typename T>
+    AsyncHandle<std::vector<T>> query(DbMap<T> &dbmap, const std::string &predicate) {
+        return submit<std::vector<T>>(
+            [&dbmap, predicate](Connection conn, const std::atomic<bool> &cancelled,
+                    AsyncResult<std::vector<T>> &res) {
+                typename DbMap<T>::Reader reader(dbmap, conn);
+                if (!reader.prepareByPredicate(predicate)) {
+                    res.status = AsyncStatus::FAILED;
+                    return;
+                }
+
+                T obj{};
+                while (reader.read(&obj)) {
+                    if (cancelled.load()) {
+                        res.status = AsyncStatus::CANCELLED;
+                        res.value.clear();
+                        break;
+                    }
+                    res.value.push_back(std::move(obj));
+                    obj = T{};
+                }
+                if (reader.fetchFailed()) {
+                    res.status = AsyncStatus::FAILED;
+                    res.value.clear();
+                }
+                reader.finalize();
+            });
+    } // query
+
+
+private:
+    /**
+     * @brief worker loop: run the reads on its own read connection until the queue is closed,
+     *     the connection is opened by the first read after the database is connected,
+     *     and dropped once the database is closed, then reopened by the next read if reconnected.
+     */
+    void work() {
+        Connection conn = nullptr;
+        uint64_t   conn_gen = 0; // the connect generation of conn
+        Task task;
+        while (queue.pop(task)) {
+            const uint64_t gen = manager.connectGeneration();
+            if ((conn != nullptr) && (conn_gen != gen)) {
+                manager.closeReadConnection(conn);
+                conn = nullptr;
+            }
+            if ((conn == nullptr) && manager.isConnected()) {
+                conn = manager.openReadConnection();
+                conn_gen = gen;
+            }
+            task(conn);
+            task = nullptr;
+        }
+        manager.closeReadConnection(conn);
+    } // work
+}; // AsyncReadPool
+
+
+} // namespace edadb
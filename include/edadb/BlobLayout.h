@@ -0,0 +1,73 @@
+/**
+ * @file BlobLayout.h
+ * @brief BlobLayout.h provides the byte layout of the blob column for vector/array of POD.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <algorithm>
+
+#include "Config.h"
+
+
+namespace edadb {
+
+/**
+ * @struct BlobLayout
+ * @brief The blob stores the elements contiguously:
+ *     On little-endian host, or Config::blob_portable_layout is false, the memory layout is stored as is;
+ *     Otherwise, each element is byte swapped to little-endian layout.
+ */
+struct BlobLayout {
+public:
+    static constexpr bool host_little_endian =
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        false;
+#else
+        true;
+#endif
+
+    // swap the bytes of each element to store/load the blob
+    static constexpr bool need_swap =
+        Config::blob_portable_layout && !host_little_endian;
+
+public:
+    /**
+     * @brief encode the elements to the blob bytes.
+     * @param src The elements.
+     * @param n The number of elements.
+     * @param dst The blob bytes, size is n * sizeof(E).
+     */
+    template <typename E>
+    static void encode(const E *src, size_t n, unsigned char *dst) {
+        std::memcpy(dst, src, n * sizeof(E));
+        if constexpr (need_swap && (sizeof(E) > 1)) {
+            swapEach(dst, n, sizeof(E));
+        }
+    } // encode
+
+    /**
+     * @brief decode the blob bytes to the elements.
+     * @param src The blob bytes, size is n * sizeof(E).
+     * @param n The number of elements.
+     * @param dst The elements.
+     */
+    template <typename E>
+    static void decode(const unsigned char *src, size_t n, E *dst) {
+        std::memcpy(dst, src, n * sizeof(E));
+        if constexpr (need_swap && (sizeof(E) > 1)) {
+            swapEach(reinterpret_cast<unsigned char *>(dst), n, sizeof(E));
+        }
+    } // decode
+
+private:
+    static void swapEach(unsigned char *bytes, size_t n, size_t width) {
+        for (size_t i = 0; i < n; ++i) {
+            std::reverse(bytes + i * width, bytes + (i + 1) * width);
+        }
+    } // swapEach
+}; // BlobLayout
+
+} // namespace edadb
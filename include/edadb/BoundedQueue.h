@@ -0,0 +1,97 @@
+/**
+ * @file BoundedQueue.h
+ * @brief BoundedQueue.h provides the blocking queue of bounded capacity between threads.
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+
+namespace edadb {
+
+/**
+ * @class BoundedQueue
+ * @brief The producer blocks when the queue is full, the consumer blocks when it is empty,
+ *     so the memory of the items in flight is bounded by the capacity.
+ * @tparam V The item type.
+ */
+template <typename V>
+class BoundedQueue {
+private:
+    std::mutex mtx;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::deque<V> items;
+    size_t capacity;
+    bool closed = false;
+
+public:
+    BoundedQueue(size_t cap) : capacity(std::max<size_t>(cap, 1)) {}
+    ~BoundedQueue() = default;
+
+public:
+    /**
+     * @brief push the item, wait if the queue is full.
+     * @return true if pushed; false if the queue is closed, the item is not moved.
+     */
+    bool push(V &&v) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [this] { return closed || (items.size() < capacity); });
+        if (closed) {
+            return false;
+        }
+
+        items.push_back(std::move(v));
+        not_empty.notify_one();
+        return true;
+    } // push
+
+    /**
+     * @brief push the item without waiting.
+     * @return true if pushed; false if the queue is full or closed, the item is not moved.
+     */
+    bool tryPush(V &&v) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (closed || (items.size() >= capacity)) {
+            return false;
+        }
+
+        items.push_back(std::move(v));
+        not_empty.notify_one();
+        return true;
+    } // tryPush
+
+    /**
+     * @brief pop the item, wait if the queue is empty.
+     * @return true if popped; false if the queue is closed and empty.
+     */
+    bool pop(V &v) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+
+        v = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    } // pop
+
+    /**
+     * @brief close the queue, wake up all the waiting threads.
+     *     The items left can still be popped.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    } // close
+}; // BoundedQueue
+
+} // namespace edadb
@@ -0,0 +1,148 @@
+/**
+ * @file BusyRetry.h
+ * @brief BusyRetry.h provides the retry policy when the database is busy or locked,
+ *     the exponential backoff between the retries, and the metrics of the lock waits.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+#include "Config.h"
+#include "Singleton.h"
+
+
+namespace edadb {
+
+/**
+ * @struct LockWaitStats
+ * @brief The snapshot of the lock wait metrics.
+ */
+struct LockWaitStats {
+    uint64_t busy_events = 0; // busy or locked results and busy handler calls
+    uint64_t retries = 0;     // waits followed by a retry
+    uint64_t timeouts = 0;    // gave up after the timeout
+    uint64_t wait_ns = 0;     // time spent sleeping for the locks
+}; // LockWaitStats
+
+
+/**
+ * @class BusyRetry
+ * @brief The busy policy shared by the connections.
+ *     The n-th wait of a lock event sleeps min(initial * 2^n, max),
+ *     the event gives up once the sleeps reach the timeout.
+ */
+class BusyRetry : public Singleton<BusyRetry> {
+private:
+    friend class Singleton<BusyRetry>;
+
+    std::atomic<uint32_t> timeout_ms{Config::busy_timeout_ms};
+    std::atomic<uint32_t> initial_us{Config::busy_backoff_initial_us};
+    std::atomic<uint32_t> max_us{Config::busy_backoff_max_us};
+
+    std::atomic<uint64_t> busy_events{0};
+    std::atomic<uint64_t> retries{0};
+    std::atomic<uint64_t> timeouts{0};
+    std::atomic<uint64_t> wait_ns{0};
+
+protected:
+    BusyRetry() = default;
+    ~BusyRetry() = default;
+
+public: // policy
+    /**
+     * @brief set the busy policy.
+     * @param timeout The total wait of a lock event, 0 to fail at once.
+     * @param initial The first backoff.
+     * @param max The max backoff.
+     */
+    void setPolicy(std::chrono::milliseconds timeout,
+            std::chrono::microseconds initial = std::chrono::microseconds(Config::busy_backoff_initial_us),
+            std::chrono::microseconds max = std::chrono::microseconds(Config::busy_backoff_max_us)) {
+        timeout_ms.store(static_cast<uint32_t>(std::max<int64_t>(timeout.count(), 0)), std::memory_order_relaxed);
+        initial_us.store(static_cast<uint32_t>(std::max<int64_t>(initial.count(), 1)), std::memory_order_relaxed);
+        max_us.store(static_cast<uint32_t>(std::max<int64_t>(max.count(), initial.count())),
+            std::memory_order_relaxed);
+    }
+
+    std::chrono::milliseconds getTimeout() const {
+        return std::chrono::milliseconds(timeout_ms.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief get the backoff of the n-th wait.
+     */
+    uint64_t backoffUs(int n) const {
+        const uint64_t init = initial_us.load(std::memory_order_relaxed);
+        const uint64_t cap  = max_us.load(std::memory_order_relaxed);
+        return (n >= 32) ? cap : std::min<uint64_t>(init << n, cap);
+    }
+
+    /**
+     * @brief get the total backoff of the waits before the n-th.
+     */
+    uint64_t waitedUs(int n) const {
+        uint64_t sum = 0;
+        for (int k = 0; k < n; ++k) sum += backoffUs(k);
+        return sum;
+    }
+
+    /**
+     * @brief wait before the n-th retry of a lock event.
+     * @param n The number of waits before in the event, starts from 0.
+     * @return true if waited and the caller should retry; false if timed out.
+     */
+    bool wait(int n) {
+        busy_events.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t delay  = backoffUs(n);
+        const uint64_t budget = static_cast<uint64_t>(timeout_ms.load(std::memory_order_relaxed)) * 1000;
+        if (waitedUs(n) + delay > budget) {
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::microseconds(delay));
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        wait_ns.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+        retries.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    } // wait
+
+
+    /**
+     * @brief the flag set on this thread when the busy handler of the backend timed out,
+     *     so the caller does not wait again for the same lock event.
+     */
+    static bool &handlerTimedOut() {
+        static thread_local bool timed_out = false;
+        return timed_out;
+    }
+
+
+public: // metrics
+    LockWaitStats snapshot() const {
+        LockWaitStats s;
+        s.busy_events = busy_events.load(std::memory_order_relaxed);
+        s.retries     = retries.load(std::memory_order_relaxed);
+        s.timeouts    = timeouts.load(std::memory_order_relaxed);
+        s.wait_ns     = wait_ns.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void reset() {
+        busy_events.store(0, std::memory_order_relaxed);
+        retries.store(0, std::memory_order_relaxed);
+        timeouts.store(0, std::memory_order_relaxed);
+        wait_ns.store(0, std::memory_order_relaxed);
+    }
+}; // BusyRetry
+
+} // namespace edadb
@@ -0,0 +1,81 @@
+/**
+ * @file ColumnBuffer.h
+ * @brief ColumnBuffer.h defines the struct-of-arrays buffers for column export.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace edadb {
+
+/**
+ * @struct ColumnBuffer
+ * @brief ColumnBuffer holds one exported column in contiguous memory.
+ * @tparam V The member value type.
+ */
+template <typename V>
+struct ColumnBuffer {
+    std::vector<V>       values;      // value of each row, V() if null
+    std::vector<uint8_t> null_bitmap; // bit i is set if row i is null
+
+public:
+    size_t size () const { return values.size(); }
+    bool   empty() const { return values.empty(); }
+
+    bool isNull(size_t i) const {
+        return (null_bitmap[i >> 3] >> (i & 7)) & 1;
+    }
+
+    void clear() {
+        values.clear();
+        null_bitmap.clear();
+    }
+
+    /**
+     * @brief append a slot for the next row.
+     * @return the pointer to fill the value of the row.
+     */
+    V *append() {
+        if ((values.size() & 7) == 0)
+            null_bitmap.push_back(0);
+        values.emplace_back();
+        return &values.back();
+    }
+
+    void setNull(size_t i) {
+        null_bitmap[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+    }
+}; // ColumnBuffer
+
+
+/**
+ * @struct ColumnSpan
+ * @brief ColumnSpan is the caller provided memory to export one column.
+ * @tparam V The member value type.
+ */
+template <typename V>
+struct ColumnSpan {
+    V       *data        = nullptr; // value array of capacity elements
+    uint8_t *null_bitmap = nullptr; // optional, (capacity + 7) / 8 bytes, zeroed by the exporter
+    size_t   capacity    = 0;
+
+public:
+    ColumnSpan() = default;
+    ColumnSpan(V *d, size_t cap, uint8_t *nb = nullptr) :
+        data(d), null_bitmap(nb), capacity(cap) {}
+
+public:
+    bool isNull(size_t i) const {
+        return (null_bitmap != nullptr) && ((null_bitmap[i >> 3] >> (i & 7)) & 1);
+    }
+
+    void setNull(size_t i) {
+        if (null_bitmap != nullptr)
+            null_bitmap[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+    }
+}; // ColumnSpan
+
+} // namespace edadb
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "DbBackendType.h"
 
 namespace edadb {
@@ -14,13 +17,80 @@ namespace edadb {
  */
 class Config {
 public:
+    /**
+     * @brief database backend, define EDADB_BACKEND_DUCKDB=1 to use DuckDB,
+     *     or EDADB_BACKEND_MEMORY=1 to use the in-process hash tables without persistence
+     */
+#if defined(EDADB_BACKEND_DUCKDB) && EDADB_BACKEND_DUCKDB
+    static constexpr DbBackendType backend_type = DbBackendType::DUCKDB;
+#elif defined(EDADB_BACKEND_MEMORY) && EDADB_BACKEND_MEMORY
+    static constexpr DbBackendType backend_type = DbBackendType::MEMORY;
+#else
     static constexpr DbBackendType backend_type = DbBackendType::SQLITE; 
+#endif
 
 public:
     /**
      * @brief foreign key reference primary key column index
      */
     static constexpr const size_t fk_ref_pk_col_index = 0;
+
+    /**
+     * @brief max number of primary keys bound in one batched lookup "IN (?, ...)"
+     *     keep it below the default SQLITE_MAX_VARIABLE_NUMBER (999) of old sqlite3
+     */
+    static constexpr const size_t pk_batch_size = 500;
+
+    /**
+     * @brief store the blob of vector/array of POD in little-endian layout,
+     *     so the database file is portable between hosts of different endianness.
+     *     No cost on little-endian hosts, where the memory layout is stored as is.
+     */
+    static constexpr const bool blob_portable_layout = true;
+
+    /**
+     * @brief alignment of the column sections in the snapshot file,
+     *     so each column can be mapped and accessed in place.
+     */
+    static constexpr const size_t snapshot_page_size = 4096;
+
+    /**
+     * @brief number of pages copied per step when saving the in-memory database,
+     *     and the sleep between the steps to let the other threads use the database.
+     */
+    static constexpr const int backup_pages_per_step = 256;
+    static constexpr const int backup_step_sleep_ms = 1;
+
+    /**
+     * @brief default wait for the database lock before a step fails with busy,
+     *     the retries sleep from the initial to the max backoff, doubled each time.
+     *     Changed at runtime by BusyRetry::setPolicy.
+     */
+    static constexpr const uint32_t busy_timeout_ms = 5000;
+    static constexpr const uint32_t busy_backoff_initial_us = 100;
+    static constexpr const uint32_t busy_backoff_max_us = 20000;
+
+    /**
+     * @brief metadata table keeping the fingerprint of the generated schema per root table,
+     *     createTable skips the DDL when the fingerprint is unchanged.
+     */
+    static constexpr const char *schema_table_name = "_edadb_schema";
+
+    /**
+     * @brief WAL mode of connectWal: the read only connections kept for the Readers,
+     *     the interval of the background passive checkpoint, and the pages in the WAL
+     *     before a commit checkpoints, raised from 1000 so the commits leave it to the background.
+     */
+    static constexpr const size_t wal_reader_connections = 4;
+    static constexpr const uint32_t wal_checkpoint_interval_ms = 1000;
+    static constexpr const int wal_autocheckpoint_pages = 16384;
+
+    /**
+     * @brief pipelined insertVector: the objects encoded per chunk by the worker threads,
+     *     and the smaller vectors inserted by the calling thread only.
+     */
+    static constexpr const size_t insert_pipeline_chunk_rows = 256;
+    static constexpr const size_t insert_pipeline_min_rows = 1024;
 };
 
 } // namespace edadb
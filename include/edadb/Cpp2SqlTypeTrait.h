@@ -10,6 +10,8 @@
 #include <stdlib.h>
 #include <string>
 #include <vector>
+#include <array>
+#include <type_traits>
 
 #include "SqlType.h"
 #include "TraitUtils.h"
@@ -32,6 +34,14 @@ public: // static variable vars
 //    static void setHasPrimKey(bool value) { hasPrimKey = value; }
 };
 
+/**
+ * @struct RowidKeyTrait
+ * @brief The first member of the class is the integer surrogate key assigned by the database
+ *     on insert if left 0, such as the rowid alias of sqlite3; specialized by TABLE4CLASS_ROWID.
+ */
+template<typename T>
+struct RowidKeyTrait : std::false_type {};
+
 // template specialization mapping from C++ types to SQL types
 // Note:
 // For the std c++ type pointer, we also map it to the same SQL type as the non-pointer type.
@@ -74,6 +84,25 @@ MAP_CPP_TO_SQL_TYPE(long double   , SqlType::Double)
 MAP_CPP_TO_SQL_TYPE(bool          , SqlType::Boolean)
 
 
+/**
+ * @brief vector of POD and std::array of POD are mapped to a single blob column,
+ *     @see is_blob for the supported element types.
+ */
+template<typename E, typename Alloc>
+struct Cpp2SqlTypeTrait<std::vector<E, Alloc>> {
+    static constexpr SqlType sqlType =
+        is_blob<std::vector<E, Alloc>>::value ? SqlType::Blob : SqlType::Unknown;
+    static inline bool hasPrimKey = false;
+};
+
+template<typename E, std::size_t N>
+struct Cpp2SqlTypeTrait<std::array<E, N>> {
+    static constexpr SqlType sqlType =
+        is_blob<std::array<E, N>>::value ? SqlType::Blob : SqlType::Unknown;
+    static inline bool hasPrimKey = false;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
  
 
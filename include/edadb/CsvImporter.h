@@ -0,0 +1,462 @@
+/**
+ * @file CsvImporter.h
+ * @brief CsvImporter.h provides the streaming bulk import from CSV and delimited files.
+ * @note The file is read in chunks and parsed into objects in a producer thread,
+ *     the calling thread inserts the batches in periodic transactions,
+ *     and at most CsvOptions::queue_batches batches are in flight to bound the memory.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <charconv>
+#include <type_traits>
+
+#include "DbMap.h"
+#include "DbMapWriter.h"
+#include "BoundedQueue.h"
+
+
+namespace edadb {
+
+
+/**
+ * @struct CsvOptions
+ * @brief The options of the CSV importer.
+ */
+struct CsvOptions {
+    char   delimiter     = ',';       // field delimiter, such as ',' '\t' '|'
+    char   quote         = '"';       // quote char, doubled to escape inside the quoted field
+    bool   header        = true;      // first record names the columns; otherwise in column_names() order
+    size_t chunk_bytes   = 1 << 20;   // bytes of each buffered read
+    size_t batch_rows    = 10000;     // rows of each insert batch
+    size_t queue_batches = 4;         // max parsed batches in flight
+    size_t commit_rows   = 100000;    // commit the transaction every commit_rows rows
+}; // CsvOptions
+
+
+
+/**
+ * @class CsvParser
+ * @brief Incremental parser of the delimited records (RFC 4180):
+ *     the chunks are fed in order and a record may span the chunk boundary,
+ *     the quoted field may contain the delimiter, the newline and the doubled quote.
+ */
+class CsvParser {
+private:
+    enum class State { FIELD_START, UNQUOTED, QUOTED, QUOTE_IN_QUOTED };
+
+    char delimiter;
+    char quote;
+    State state = State::FIELD_START;
+
+    std::vector<std::string> fields; // reused between records to avoid allocation
+    size_t num_fields = 0;           // number of fields ended in the current record
+    bool   in_record  = false;       // the current record has any char
+
+public:
+    CsvParser(char d = ',', char q = '"') : delimiter(d), quote(q) {
+        fields.resize(1);
+    }
+
+public:
+    /**
+     * @brief feed the next chunk.
+     * @param p The chunk bytes.
+     * @param n The number of bytes.
+     * @param on_record The callback bool(const std::string *fields, size_t n) for each record,
+     *     return false to stop parsing.
+     * @return true if success; false if stopped by the callback.
+     */
+    template <typename OnRecord>
+    bool feed(const char *p, size_t n, OnRecord &on_record) {
+        const char *end = p + n;
+        while (p < end) {
+            const char c = *p;
+            switch (state) {
+            case State::FIELD_START:
+                in_record = true;
+                if (c == quote) {
+                    state = State::QUOTED;
+                    ++p;
+                    continue;
+                }
+                state = State::UNQUOTED;
+                continue; // parse c in UNQUOTED
+
+            case State::UNQUOTED: {
+                // append the run of plain chars at once
+                const char *q = p;
+                while ((q < end) && (*q != delimiter) && (*q != '\n') && (*q != '\r')) ++q;
+                fields[num_fields].append(p, q);
+                p = q;
+                if (p == end) continue;
+
+                if (*p == delimiter) {
+                    endField();
+                } else if (*p == '\n') {
+                    if (!endRecord(on_record)) return false;
+                } // else '\r' is skipped
+                ++p;
+                continue;
+            }
+
+            case State::QUOTED: {
+                const char *q = p;
+                while ((q < end) && (*q != quote)) ++q;
+                fields[num_fields].append(p, q);
+                p = q;
+                if (p == end) continue;
+
+                state = State::QUOTE_IN_QUOTED;
+                ++p;
+                continue;
+            }
+
+            case State::QUOTE_IN_QUOTED:
+                if (c == quote) {
+                    fields[num_fields].push_back(quote); // escaped quote
+                    state = State::QUOTED;
+                    ++p;
+                    continue;
+                }
+                state = State::UNQUOTED; // closing quote, parse c in UNQUOTED
+                continue;
+            } // switch
+        } // while
+
+        return true;
+    } // feed
+
+    /**
+     * @brief finish the last record without the trailing newline.
+     * @return true if success; false if the quote is not closed or stopped by the callback.
+     */
+    template <typename OnRecord>
+    bool finish(OnRecord &on_record) {
+        if (state == State::QUOTED) {
+            std::cerr << "CsvParser::finish: unterminated quoted field" << std::endl;
+            return false;
+        }
+        return in_record ? endRecord(on_record) : true;
+    } // finish
+
+private:
+    void endField() {
+        if (++num_fields == fields.size())
+            fields.emplace_back();
+        fields[num_fields].clear();
+        state = State::FIELD_START;
+    } // endField
+
+    template <typename OnRecord>
+    bool endRecord(OnRecord &on_record) {
+        bool ok = on_record(fields.data(), num_fields + 1);
+        num_fields = 0;
+        fields[0].clear();
+        in_record = false;
+        state = State::FIELD_START;
+        return ok;
+    } // endRecord
+}; // CsvParser
+
+
+
+/**
+ * @class CsvImporter
+ * @brief Import the delimited file to the DbMap table in a streaming way.
+ *     The CSV columns are mapped to the scalar members by TypeMetaData<T>::column_names()
+ *     (or member_names()), the unmapped members keep the default value.
+ *     An empty field is null: nullptr for the pointer member; otherwise the default value.
+ *     The non-null pointer member is allocated by new and released with the object,
+ *     so T should delete its pointer members in the destructor.
+ * @tparam T The class type.
+ */
+template <typename T>
+class CsvImporter {
+private:
+    using Batch = std::vector<T *>;
+
+    DbMap<T>  &dbmap;
+    CsvOptions opts;
+    std::vector<int> member_col; // member index -> CSV column index; -1 if not mapped
+
+public:
+    CsvImporter(DbMap<T> &m, const CsvOptions &o = CsvOptions()) : dbmap(m), opts(o) {
+        // without header, the CSV columns are in column_names() order
+        const size_t n = TypeMetaData<T>::member_names().size();
+        const std::vector<bool> ok = importableMembers();
+        member_col.assign(n, -1);
+        for (size_t i = 0; i < n; ++i) {
+            if (ok[i]) member_col[i] = static_cast<int>(i);
+        }
+    }
+    ~CsvImporter() = default;
+
+public:
+    /**
+     * @brief import the file.
+     * @param path The delimited file path.
+     * @param self_txn If true, insert in the transactions committed every commit_rows rows;
+     *     otherwise, the caller owns the transaction.
+     * @return The number of rows imported; -1 if error,
+     *     the rows in the committed transactions are kept.
+     */
+    int64_t importFile(const std::string &path, bool self_txn = true) {
+        FILE *fp = std::fopen(path.c_str(), "rb");
+        if (fp == nullptr) {
+            std::cerr << "CsvImporter::importFile: cannot open " << path << std::endl;
+            return -1;
+        }
+
+        BoundedQueue<Batch> queue(opts.queue_batches);
+        std::atomic<bool> parsed{false};
+        std::thread producer([&]() {
+            parsed = produce(fp, queue);
+            queue.close();
+        });
+
+        // consume the batches in this thread, which owns the database connection
+        bool in_txn = self_txn && dbmap.beginTransaction();
+        bool ok = !self_txn || in_txn;
+        int64_t rows = 0;
+        size_t uncommitted = 0;
+        Batch batch;
+        while (queue.pop(batch)) {
+            if (ok) {
+                typename DbMap<T>::Writer writer(dbmap);
+                ok = writer.insertVector(batch);
+                rows += ok ? batch.size() : 0;
+                uncommitted += batch.size();
+            }
+
+            if (ok && self_txn && (uncommitted >= opts.commit_rows)) {
+                in_txn = false;
+                ok = dbmap.commitTransaction() && (in_txn = dbmap.beginTransaction());
+                uncommitted = 0;
+            }
+
+            freeBatch(batch);
+            if (!ok) queue.close(); // stop the producer
+        } // while
+
+        producer.join();
+        std::fclose(fp);
+
+        ok = ok && parsed;
+        if (in_txn) {
+            if (ok) ok = dbmap.commitTransaction();
+            else dbmap.executeSql("ROLLBACK;");
+        }
+
+        if (!ok) {
+            std::cerr << "CsvImporter::importFile: import " << path << " failed" << std::endl;
+            return -1;
+        }
+        return rows;
+    } // importFile
+
+private:
+    /**
+     * @brief read the file in chunks and parse the records into batches, in the producer thread.
+     * @return true if parsed all; otherwise, false.
+     */
+    bool produce(FILE *fp, BoundedQueue<Batch> &queue) {
+        CsvParser parser(opts.delimiter, opts.quote);
+        bool header_done = !opts.header;
+        uint64_t line = 0;
+        Batch batch;
+        batch.reserve(opts.batch_rows);
+
+        auto on_record = [&](const std::string *fields, size_t n) -> bool {
+            ++line;
+            if (!header_done) {
+                header_done = true;
+                return mapHeader(fields, n);
+            }
+            if ((n == 1) && fields[0].empty()) {
+                return true; // blank line
+            }
+
+            std::unique_ptr<T> obj(new T());
+            if (!parseRecord(fields, n, obj.get())) {
+                std::cerr << "CsvImporter::produce: invalid record " << line << std::endl;
+                return false;
+            }
+
+            batch.push_back(obj.release());
+            if (batch.size() >= opts.batch_rows) {
+                if (!queue.push(std::move(batch))) return false; // stopped by the consumer
+                batch = Batch();
+                batch.reserve(opts.batch_rows);
+            }
+            return true;
+        }; // on_record
+
+        std::vector<char> buf(std::max<size_t>(opts.chunk_bytes, 1));
+        bool ok = true;
+        size_t n = 0;
+        while (ok && ((n = std::fread(buf.data(), 1, buf.size(), fp)) > 0)) {
+            ok = parser.feed(buf.data(), n, on_record);
+        }
+        if (ok && std::ferror(fp)) {
+            std::cerr << "CsvImporter::produce: read failed" << std::endl;
+            ok = false;
+        }
+        ok = ok && parser.finish(on_record);
+
+        if (ok && !batch.empty()) {
+            ok = queue.push(std::move(batch));
+        }
+        freeBatch(batch);
+        return ok;
+    } // produce
+
+    /**
+     * @brief map the CSV columns to the members by the header names.
+     * @return true if any column is mapped; otherwise, false.
+     */
+    bool mapHeader(const std::string *fields, size_t n) {
+        const auto &cols = TypeMetaData<T>::column_names();
+        const auto &mems = TypeMetaData<T>::member_names();
+        const std::vector<bool> ok = importableMembers();
+
+        member_col.assign(mems.size(), -1);
+        bool mapped = false;
+        for (size_t c = 0; c < n; ++c) {
+            std::string name = trim(fields[c]);
+            if ((c == 0) && (name.compare(0, 3, "\xEF\xBB\xBF") == 0))
+                name.erase(0, 3); // UTF-8 BOM
+
+            size_t i = 0;
+            while ((i < mems.size()) && (cols[i] != name) && (mems[i] != name)) ++i;
+            if ((i < mems.size()) && ok[i]) {
+                member_col[i] = static_cast<int>(c);
+                mapped = true;
+            } else {
+                std::cerr << "CsvImporter::mapHeader: ignore column " << name << std::endl;
+            }
+        } // for
+
+        if (!mapped) {
+            std::cerr << "CsvImporter::mapHeader: no column mapped to "
+                << TypeMetaData<T>::class_name() << std::endl;
+        }
+        return mapped;
+    } // mapHeader
+
+    /**
+     * @brief parse the fields of the record to the members.
+     * @return true if parsed; otherwise, false.
+     */
+    bool parseRecord(const std::string *fields, size_t n, T *obj) {
+        static const std::string empty;
+        bool ok = true;
+        size_t i = 0;
+        auto values = TypeMetaData<T>::getVal(obj);
+        boost::fusion::for_each(values, [&](auto const &ne) {
+            const int c = member_col[i++];
+            if (!ok || (c < 0)) return;
+            ok = parseField((static_cast<size_t>(c) < n) ? fields[c] : empty, ne);
+        });
+        return ok;
+    } // parseRecord
+
+    template <typename ElemType>
+    static bool parseField(const std::string &s, ElemType &elem) {
+        using DefType = typename remove_const_and_pointer<ElemType>::type;
+        using TypeTrait = TypeInfoTrait<DefType>;
+        using CppType = typename TypeTrait::CppType;
+
+        if constexpr (!importable<DefType>()) {
+            return true; // never mapped
+        } else {
+            if (s.empty()) {
+                if constexpr (TypeTrait::is_pointer) *elem = nullptr;
+                else *elem = CppType();
+                return true;
+            }
+
+            CppType *cpp_val_ptr = TypeTrait::getCppPtr2Fetch(elem);
+            if (!parseValue(s, cpp_val_ptr)) {
+                std::cerr << "CsvImporter::parseField: invalid value \"" << s << "\"" << std::endl;
+                return false;
+            }
+            return true;
+        }
+    } // parseField
+
+    template <typename V>
+    static bool parseValue(const std::string &s, V *v) {
+        if constexpr (std::is_same_v<V, std::string>) {
+            *v = s;
+            return true;
+        }
+        else if constexpr (std::is_same_v<V, bool>) {
+            const std::string t = trim(s);
+            if (t == "1" || t == "true" || t == "TRUE" || t == "True") { *v = true; return true; }
+            if (t == "0" || t == "false" || t == "FALSE" || t == "False") { *v = false; return true; }
+            return false;
+        }
+        else if constexpr (std::is_enum_v<V>) {
+            std::underlying_type_t<V> u{};
+            if (!parseValue(s, &u)) return false;
+            *v = static_cast<V>(u);
+            return true;
+        }
+        else {
+            static_assert(std::is_arithmetic_v<V>, "CsvImporter::parseValue: unsupported type");
+            const std::string t = trim(s);
+            const char *end = t.data() + t.size();
+            auto res = std::from_chars(t.data(), end, *v);
+            return (res.ec == std::errc()) && (res.ptr == end);
+        }
+    } // parseValue
+
+    /**
+     * @brief the member is importable if it maps to one column of string/number/enum.
+     */
+    template <typename DefType>
+    static constexpr bool importable() {
+        using TypeTrait = TypeInfoTrait<DefType>;
+        using CppType = typename TypeTrait::CppType;
+        constexpr SqlType sqlType = TypeTrait::sqlType;
+        return (!TypeTrait::is_vector) && (!is_blob<CppType>::value) &&
+            (sqlType != SqlType::Composite) && (sqlType != SqlType::CompositeVector) &&
+            (sqlType != SqlType::External) &&
+            (std::is_same_v<CppType, std::string> || std::is_arithmetic_v<CppType> ||
+             std::is_enum_v<CppType>);
+    } // importable
+
+    static std::vector<bool> importableMembers() {
+        std::vector<bool> ok;
+        auto seq = TypeMetaData<T>::tuple_type_pair();
+        boost::fusion::for_each(seq, [&](auto elem) {
+            using DefPtrType = typename decltype(elem)::first_type;
+            using DefType = typename remove_const_and_pointer<DefPtrType>::type;
+            ok.push_back(importable<DefType>());
+        });
+        return ok;
+    } // importableMembers
+
+    static std::string trim(const std::string &s) {
+        size_t b = s.find_first_not_of(" \t");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t");
+        return s.substr(b, e - b + 1);
+    } // trim
+
+    static void freeBatch(Batch &batch) {
+        for (auto obj : batch) delete obj;
+        batch.clear();
+    } // freeBatch
+}; // CsvImporter
+
+
+} // namespace edadb
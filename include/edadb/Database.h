@@ -0,0 +1,136 @@
+/**
+ * @file Database.h
+ * @brief Database.h defines the handle of a database, so several databases can be open at once,
+ *     such as the golden and the revised designs compared side by side.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <future>
+#include <chrono>
+
+#include <boost/noncopyable.hpp>
+
+#include "DbManager.h"
+
+
+namespace edadb {
+
+/**
+ * @class Database
+ * @brief The handle owning a database connection, its read connections and its prepared statements.
+ *     DbMap<T> is bound to a handle by DbMap<T>(db); the DbMap constructed without a handle
+ *     and the edadb:: free functions use Database::defaultDatabase(), which is DbManager::i().
+ * @note The DbMap bound to the handle must be destroyed before the handle.
+ */
+class Database : public boost::noncopyable {
+private:
+    std::unique_ptr<DbManager> owned;   // nullptr for the default database
+    DbManager                 *manager; // the database managed
+
+private:
+    explicit Database(DbManager &m) : manager(&m) {}
+
+public:
+    Database() : owned(new DbManager()), manager(owned.get()) {}
+
+    /**
+     * @brief Construct and open the database.
+     * @param c The database connection string, check isOpen() after.
+     */
+    explicit Database(const std::string &c) : Database() {
+        open(c);
+    }
+
+    /**
+     * @brief The default database of the process, shared with the singleton API.
+     */
+    static Database &defaultDatabase() {
+        static Database db(DbManager::i());
+        return db;
+    }
+
+    DbManager &getManager() { return *manager; }
+
+public:
+    /**
+     * @brief Open the database.
+     * @param c The database connection string.
+     * @return true if success; otherwise, false.
+     */
+    bool open(const std::string &c) {
+        return manager->connect(c);
+    }
+
+    /**
+     * @brief Open the in-memory database loaded from the file.
+     * @param file The database file saved back by save().
+     * @return true if success; otherwise, false.
+     */
+    bool openInMemory(const std::string &file) {
+        return manager->connectInMemory(file);
+    }
+
+    /**
+     * @brief Open the database in WAL mode, the Readers run on the pooled read connections.
+     * @param c The database file.
+     * @param readers The number of the read connections kept in the pool.
+     * @return true if success; otherwise, false.
+     */
+    bool openWal(const std::string &c, size_t readers = Config::wal_reader_connections) {
+        return manager->connectWal(c, readers);
+    }
+
+    bool checkpoint() {
+        return manager->checkpoint();
+    }
+
+    bool isOpen() const {
+        return manager->isConnected();
+    }
+
+    /**
+     * @brief Close the database, the prepared statements are finalized.
+     * @return true if success; otherwise, false.
+     */
+    bool close() {
+        return manager->close();
+    }
+
+    /**
+     * @brief Save the in-memory database back to the file.
+     * @return true if success; otherwise, false.
+     */
+    bool save() {
+        return manager->save();
+    }
+
+    std::future<bool> saveAsync() {
+        return manager->saveAsync();
+    }
+
+public:
+    bool executeSql(const std::string &sql) {
+        return manager->exec(sql);
+    }
+
+    bool beginTransaction() {
+        return manager->exec("BEGIN TRANSACTION;");
+    }
+
+    bool commitTransaction() {
+        return manager->exec("COMMIT;");
+    }
+
+    bool rollbackTransaction() {
+        return manager->exec("ROLLBACK;");
+    }
+
+    bool tableExists(const std::string &name) {
+        return manager->tableExists(name);
+    }
+}; // Database
+
+} // namespace edadb
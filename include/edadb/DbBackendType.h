@@ -15,6 +15,7 @@
      UNKNOWN = 0,
      SQLITE,
      DUCKDB, 
+     MEMORY,
      MAX
  };
  
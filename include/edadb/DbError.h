@@ -0,0 +1,88 @@
+/**
+ * @file DbError.h
+ * @brief DbError.h defines the structured error of the backends.
+ *     The APIs return bool, the error of the last failure is kept per thread and read by lastError().
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+
+namespace edadb {
+
+/**
+ * @enum DbErrorCode
+ * @brief The backend independent error code.
+ */
+enum class DbErrorCode : uint8_t {
+    OK = 0,
+    BUSY,        // the database is locked by another connection, retry later
+    LOCKED,      // the table is locked by the same connection or shared cache
+    CONSTRAINT,  // unique, primary key, foreign key or not null constraint violated
+    MISUSE,      // the API is used in a wrong order, such as step a finalized statement
+    RANGE,       // the bind or column index is out of range
+    IO,          // disk I/O error, full disk or corrupted file
+    NOT_FOUND,   // no such table or column
+    ERROR        // other errors
+}; // DbErrorCode
+
+inline const char *dbErrorCodeName(DbErrorCode c) {
+    switch (c) {
+    case DbErrorCode::OK:         return "OK";
+    case DbErrorCode::BUSY:       return "BUSY";
+    case DbErrorCode::LOCKED:     return "LOCKED";
+    case DbErrorCode::CONSTRAINT: return "CONSTRAINT";
+    case DbErrorCode::MISUSE:     return "MISUSE";
+    case DbErrorCode::RANGE:      return "RANGE";
+    case DbErrorCode::IO:         return "IO";
+    case DbErrorCode::NOT_FOUND:  return "NOT_FOUND";
+    default:                      return "ERROR";
+    }
+}
+
+
+/**
+ * @struct DbError
+ * @brief The error of the last failed backend call on the thread.
+ */
+struct DbError {
+    DbErrorCode code = DbErrorCode::OK;
+    int         backend_code = 0; // the extended code of the backend, such as SQLITE_BUSY_SNAPSHOT
+    std::string message;
+
+    bool ok() const { return code == DbErrorCode::OK; }
+
+    /**
+     * @brief check if the error is transient and the operation can be retried.
+     */
+    bool retryable() const {
+        return (code == DbErrorCode::BUSY) || (code == DbErrorCode::LOCKED);
+    }
+}; // DbError
+
+
+namespace detail {
+    inline thread_local DbError t_last_error;
+}
+
+/**
+ * @brief get the error of the last failed backend call on this thread.
+ */
+inline const DbError &lastError() {
+    return detail::t_last_error;
+}
+
+inline void setLastError(DbErrorCode code, int backend_code, std::string message) {
+    DbError &e = detail::t_last_error;
+    e.code = code;
+    e.backend_code = backend_code;
+    e.message = std::move(message);
+}
+
+inline void clearLastError() {
+    setLastError(DbErrorCode::OK, 0, std::string());
+}
+
+} // namespace edadb
@@ -33,9 +33,9 @@ class DbManagerImpl : public Singleton< DbManagerImpl<DBType> > {
 };
 
 /**
- * DbManager is defined in backend, such as backend/DbBackendType/DbManager4Sqlite.h:
- *   using DbManager = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE,
- *        DbManagerImpl<DbBackendType::SQLITE>>;
+ * DbManager of Config::backend_type,
+ * DbManagerImpl is specialized in backend, such as backend/sqlite/DbManager4Sqlite.h
  */
+using DbManager = DbManagerImpl<Config::backend_type>;
 
 } // namespace edadb
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <typeindex>
+#include <tuple>
 
 #include <boost/fusion/include/pair.hpp> 
 #include <boost/fusion/include/at_c.hpp> 
@@ -17,11 +18,14 @@
 #include "TypeStack.h"
 #include "TraitUtils.h"
 #include "DbMapBase.h"
+#include "Database.h"
 #include "SqlStatement.h"
 #include "backend/sqlite/SqlStatement4Sqlite.h"
 #include "TypeMetaData.h"
 #include "VecMetaData.h"
 #include "Table4Class.h"
+#include "ColumnBuffer.h"
+#include "Snapshot.h"
 
 
 namespace edadb {
@@ -36,6 +40,17 @@ public:
     class DbStmtOp; // DB statement operation 
     class Writer; // write object to database
     class Reader; // read object from database
+    class ColumnExporter; // export columns to struct-of-arrays buffers
+    class SnapshotDumper; // dump table to snapshot file
+
+public:
+    // primary key (1st member) defined type and cpp type
+    using PkDefType = typename remove_const_and_pointer< typename boost::fusion::result_of::value_at_c<
+            typename TypeMetaData<T>::TupType, Config::fk_ref_pk_col_index >::type >::type;
+    using PkType = typename TypeInfoTrait<PkDefType>::CppType;
+
+    static_assert(!RowidKeyTrait<T>::value || std::is_integral_v<PkType>,
+        "DbMap: the rowid key defined by TABLE4CLASS_ROWID must be an integer member");
 
 protected:
     FKC this_fkc; // FKC for this table, this is the child table containing foreign key
@@ -43,7 +58,21 @@ protected:
     std::vector<DbMapBase *> child_dbmap_vec; // vector of child DbMap
 
 public:
-    DbMap(const ForeignKeyConstraint& fkc = ForeignKeyConstraint()) : this_fkc(fkc), work_fkc() {
+    /**
+     * @brief DbMap on the default database.
+     * @param fkc The foreign key constraint of the child table; empty for the root table.
+     */
+    DbMap(const ForeignKeyConstraint& fkc = ForeignKeyConstraint()) : DbMap(DbManager::i(), fkc) {}
+
+    /**
+     * @brief DbMap on the database of the handle, the handle must outlive the DbMap.
+     * @param db The database handle.
+     * @param fkc The foreign key constraint of the child table; empty for the root table.
+     */
+    explicit DbMap(Database &db, const ForeignKeyConstraint& fkc = ForeignKeyConstraint())
+        : DbMap(db.getManager(), fkc) {}
+
+    DbMap(DbManager &m, const ForeignKeyConstraint& fkc) : DbMapBase(m), this_fkc(fkc), work_fkc() {
         // call by edadb api
         if (this_fkc.prim_tab_name.empty()) {
             this_fkc.prim_tab_name = TypeMetaData<T>::table_name();
@@ -92,6 +121,13 @@ public:
                 std::cerr << "DbMap::createTable: create table failed" << std::endl;
                 return false;
             } // if
+
+            for (const auto &idx : indexStatements()) {
+                if (!manager.exec(idx)) {
+                    std::cerr << "DbMap::createTable: create index failed" << std::endl;
+                    return false;
+                }
+            }
         } 
         else if (!child_dbmap_vec.empty()) {
             // child dbmap already created,
@@ -135,6 +171,29 @@ public:
     bool init(void) {
         return createTable(false);
     }
+
+
+    /**
+     * @brief Create the tables of the class and its child tables unless the schema is unchanged,
+     *     the existing tables are evolved to the generated columns, defined in DbMapSchema.h
+     * @return true if success; otherwise, false.
+     */
+    bool createSchema();
+
+    /**
+     * @brief Append the table names and the schema statements of this table and its child tables,
+     *     the child DbMap must be created by init(). Defined in DbMapSchema.h
+     */
+    void appendSchema(std::vector<std::string> &tables, std::vector<std::string> &ddl) override;
+
+    /**
+     * @brief Diff the generated columns of this table and the child tables with the tables on disk,
+     *     and apply the changes if asked. Defined in DbMapSchema.h
+     * @param out The changed tables appended.
+     * @param apply true to create, alter or rebuild the tables and create the indexes.
+     * @return true if success; otherwise, false.
+     */
+    bool evolveSchema(std::vector<SchemaDiff> &out, bool apply) override;
         
 
     /**
@@ -153,6 +212,188 @@ public:
     }
 
 
+    /**
+     * @brief Delete the rows of this table and the child tables whose parent row is deleted,
+     *     called after deleting the parent rows if the backend has no ON DELETE CASCADE.
+     * @return true if success; otherwise, false.
+     */
+    bool deleteOrphanRows() override {
+        bool ok = true;
+        if constexpr (!SqlStatement<T>::cascade_foreign_key) {
+            if (this_fkc.valid()) {
+                ok = manager.exec(SqlStatement<T>::deleteOrphanStatement(this_fkc));
+            }
+            for (auto &child : child_dbmap_vec) {
+                ok = ok && child->deleteOrphanRows();
+            }
+        }
+        return ok;
+    } // deleteOrphanRows
+
+
+    /**
+     * @brief Create an index on the member column, the primary key is appended
+     *     as the last index column to serve ordered scan and keyset pagination.
+     * @param member The scalar member variable name defined in TABLE4CLASS.
+     * @return true if success; otherwise, false.
+     */
+    bool createIndex(const std::string &member) {
+        if (!manager.isConnected()) {
+            std::cerr << "DbMap::createIndex: not inited" << std::endl;
+            return false;
+        }
+
+        const std::string col = getMemberColumnName(member);
+        if (col.empty()) {
+            std::cerr << "DbMap::createIndex: invalid member " << member << std::endl;
+            return false;
+        }
+
+        std::vector<std::string> cols{col};
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        if (col != pk_name) {
+            cols.push_back(pk_name);
+        }
+
+        const std::string sql = SqlStatement<T>::createIndexStatement(getTableName(), cols);
+        return manager.exec(sql);
+    } // createIndex
+
+
+    /**
+     * @brief Get the index statements of the generated schema,
+     *     the foreign key column is indexed to serve QUERY_FOREIGN_KEY.
+     */
+    std::vector<std::string> indexStatements() {
+        std::vector<std::string> sqls;
+        if (this_fkc.valid()) {
+            sqls.push_back(SqlStatement<T>::createIndexStatement(
+                getTableName(), std::vector<std::string>{this_fkc.fore_col_name}));
+        }
+        return sqls;
+    } // indexStatements
+
+
+public:
+    /**
+     * @brief Export the member columns of all rows to struct-of-arrays buffers,
+     *     scan the table once without constructing any T object.
+     * @param bufs The buffers, one per member, appended in the scan order.
+     * @param members The scalar member pointers, such as &T::x, &T::y.
+     * @return The number of rows exported; -1 if error.
+     */
+    template <typename... Vs>
+    int64_t exportColumns(std::tuple<ColumnBuffer<Vs>...> &bufs, Vs T::*... members) {
+        ColumnExporter exporter(*this);
+        return exporter.exportTo(bufs, members...);
+    } // exportColumns
+
+    /**
+     * @brief Export the member columns to the caller provided memory,
+     *     stop when any span is full.
+     * @param spans The caller provided memory, one per member.
+     * @param members The scalar member pointers, such as &T::x, &T::y.
+     * @return The number of rows exported; -1 if error.
+     */
+    template <typename... Vs>
+    int64_t exportColumns(std::tuple<ColumnSpan<Vs>...> spans, Vs T::*... members) {
+        ColumnExporter exporter(*this);
+        return exporter.exportTo(spans, members...);
+    } // exportColumns
+
+    /**
+     * @brief Write this table and the child tables to the snapshot, defined in DbMapSnapshot.h
+     * @param w The snapshot writer.
+     * @return true if success; otherwise, false.
+     */
+    bool writeSnapshot(SnapshotWriter &w) override;
+
+    /**
+     * @brief Materialize all the objects of this table from the snapshot, defined in DbMapSnapshot.h
+     * @param snap The mapped snapshot.
+     * @param objs The objects read in the table order, allocated by new and owned by the caller.
+     * @return The number of objects read; -1 if error.
+     */
+    int64_t readSnapshot(const Snapshot &snap, std::vector<T*> &objs);
+
+    /**
+     * @brief Check the snapshot has this table and the child tables of the same schema.
+     * @return true if matched; otherwise, false.
+     */
+    bool checkSnapshot(const Snapshot &snap);
+
+    /**
+     * @brief Explain the query plans of the generated statements of this table and the child tables,
+     *     defined in DbMapQueryPlan.h
+     * @param out The reports appended, one per statement.
+     * @return true if success; otherwise, false.
+     */
+    bool explainQueryPlans(std::vector<QueryPlanReport> &out) override;
+
+    /**
+     * @brief Materialize the objects of the rows [begin, end) from the snapshot table,
+     *     call checkSnapshot before.
+     * @param emit The callback void(T &obj) for each object.
+     * @return true if success; otherwise, false.
+     */
+    template <typename Emit>
+    bool readSnapshotRows(const Snapshot &snap, const SnapshotTable &tab,
+            size_t begin, size_t end, Emit emit);
+
+    /**
+     * @brief Get the primary key value pointer of the object.
+     * @param obj The object.
+     * @return The primary key value pointer; nullptr if the pointer member is nullptr.
+     */
+    static PkType *getPrimaryKey(T *obj) {
+        auto pk_def_ptr = boost::fusion::at_c<Config::fk_ref_pk_col_index>(
+            TypeMetaData<T>::getVal(obj));
+        return TypeInfoTrait<PkDefType>::getCppPtr2Bind(pk_def_ptr);
+    } // getPrimaryKey
+
+    /**
+     * @brief Get the index of the member variable defined in TABLE4CLASS.
+     * @param member The member variable name.
+     * @return The member index; -1 if not found.
+     */
+    static int getMemberIndex(const std::string &member) {
+        const auto &names = TypeMetaData<T>::member_names();
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == member)
+                return static_cast<int>(i);
+        }
+        return -1;
+    } // getMemberIndex
+
+    /**
+     * @brief Get the column name of the scalar member, which maps to one column.
+     * @param member The member variable name.
+     * @return The column name; empty if not found or not a scalar member.
+     */
+    static std::string getMemberColumnName(const std::string &member) {
+        int idx = getMemberIndex(member);
+        if (idx < 0) return "";
+
+        bool scalar = false;
+        int i = 0;
+        auto seq = TypeMetaData<T>::tuple_type_pair();
+        boost::fusion::for_each(seq, [&](auto elem) {
+            using DefPtrType = typename decltype(elem)::first_type;
+            using DefType = typename remove_const_and_pointer<DefPtrType>::type;
+            constexpr SqlType sqlType = TypeInfoTrait<DefType>::sqlType;
+            if (i++ == idx) {
+                scalar = (!TypeInfoTrait<DefType>::is_vector) &&
+                    (sqlType != SqlType::Composite) &&
+                    (sqlType != SqlType::CompositeVector) &&
+                    (sqlType != SqlType::External);
+            }
+        }); // for_each
+
+        return scalar ? TypeMetaData<T>::column_names().at(idx) : "";
+    } // getMemberColumnName
+
+
 private:
     /**
      * @brief Create the child table for the vector member variable.
@@ -212,7 +453,7 @@ private:
 
         // create child dbmap and table
         // NOTE: child dbmap for vector element points to root of Composite/CompositeVector type
-        DbMap<ChildType> *child_dbmap = new DbMap<ChildType>(fkc);
+        DbMap<ChildType> *child_dbmap = new DbMap<ChildType>(manager, fkc);
         child_dbmap_vec.push_back(child_dbmap);
         return child_dbmap->createTable(run_sql);
     } // createChildTable
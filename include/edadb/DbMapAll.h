@@ -17,4 +17,10 @@
 #include "DbMap.h"
 #include "DbMapDbStmtOp.h"
 #include "DbMapWriter.h"
-#include "DbMapReader.h"
\ No newline at end of file
+#include "DbMapReader.h"
+#include "DbMapParallelScan.h"
+#include "DbMapColumnExporter.h"
+#include "DbMapSnapshot.h"
+#include "DbMapQueryPlan.h"
+#include "DbMapSchema.h"
+#include "CsvImporter.h"
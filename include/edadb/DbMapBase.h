@@ -6,17 +6,35 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
 
 #include "Singleton.h"
+#include "QueryPlan.h"
+#include "SchemaDiff.h"
 #include "DbManager.h"
 #include "edadb/backend/sqlite/DbManager4Sqlite.h"
+#if defined(EDADB_BACKEND_DUCKDB) && EDADB_BACKEND_DUCKDB
+#include "edadb/backend/duckdb/SqlStatement4Duckdb.h"
+#include "edadb/backend/duckdb/DbManager4Duckdb.h"
+#endif
+#if defined(EDADB_BACKEND_MEMORY) && EDADB_BACKEND_MEMORY
+#include "edadb/backend/memory/SqlStatement4Memory.h"
+#include "edadb/backend/memory/DbManager4Memory.h"
+#endif
 
 
 namespace edadb {
 
 
+class SnapshotWriter;
+
+
 /**
  * @brief DbMapBase class is the base class for all DbMap classes and manages the database connection.
+ *     DbMapBase::i() manages the default database DbManager::i().
  */
 class DbMapBase : public Singleton<DbMapBase> {
 private:
@@ -26,11 +44,11 @@ private:
     friend class Singleton<DbMapBase>;
 
 protected:
-    // Singleton DbManager ins to connect to database
-    inline static DbManager &manager = DbManager::i();
+    // the database bound, DbManager::i() by default or the one owned by a Database handle
+    DbManager &manager;
 
 protected:
-    DbMapBase() = default;
+    explicit DbMapBase(DbManager &m = DbManager::i()) : manager(m) {}
 
 public:
     virtual ~DbMapBase() = default;
@@ -49,6 +67,33 @@ public:
         return manager.connect(c);
     }
 
+    /**
+     * @brief Initialize the in-memory database loaded from the file.
+     * @param file The database file saved back by save().
+     * @return true if success; otherwise, false.
+     */
+    bool initInMemory(const std::string &file) {
+        return manager.connectInMemory(file);
+    }
+
+    /**
+     * @brief Initialize the database in WAL mode, the Readers run on the pooled read connections.
+     * @param c The database file.
+     * @param readers The number of the read connections kept in the pool.
+     * @return true if success; otherwise, false.
+     */
+    bool initWal(const std::string &c, size_t readers = Config::wal_reader_connections) {
+        return manager.connectWal(c, readers);
+    }
+
+    /**
+     * @brief Save the in-memory database back to the file.
+     * @return true if success; otherwise, false.
+     */
+    bool save() {
+        return manager.save();
+    }
+
     /**
      * @brief Execute the SQL statement directly.
      * @param sql The SQL statement.
@@ -74,6 +119,14 @@ public:
         return manager.exec("COMMIT;");
     }
 
+    /**
+     * @brief Rollback a transaction.
+     * @return true if success; otherwise, false.
+     */
+    bool rollbackTransaction() {
+        return manager.exec("ROLLBACK;");
+    }
+
     /**
      * @brief check if the table exists in the database.
      * @param name The table name.
@@ -82,6 +135,83 @@ public:
     bool tableExists(const std::string &name) {
         return manager.tableExists(name);
     }   
+
+    /**
+     * @brief Append the table names and the create table statements of the table and its child tables.
+     * @param tables The table names appended.
+     * @param ddl The statements appended in the creation order.
+     * @see DbMap<T>::appendSchema
+     */
+    virtual void appendSchema(std::vector<std::string> &tables, std::vector<std::string> &ddl) {
+        (void)tables;
+        (void)ddl;
+    }
+
+    /**
+     * @brief Diff the generated columns with the tables on disk and apply the changes if asked.
+     * @param out The changed tables appended.
+     * @param apply true to apply the changes.
+     * @return true if success; otherwise, false.
+     * @see DbMap<T>::evolveSchema
+     */
+    virtual bool evolveSchema(std::vector<SchemaDiff> &out, bool apply) {
+        (void)out;
+        (void)apply;
+        std::cerr << "DbMapBase::evolveSchema: not implemented" << std::endl;
+        return false;
+    }
+
+    /**
+     * @brief Get the fingerprint of the schema, the 64-bit FNV-1a hash of the statements in hex.
+     * @param ddl The create table statements.
+     * @return The fingerprint.
+     */
+    static std::string schemaFingerprint(const std::vector<std::string> &ddl) {
+        uint64_t h = 14695981039346656037ULL;
+        auto mix = [&h](unsigned char c) { h ^= c; h *= 1099511628211ULL; };
+        for (const auto &sql : ddl) {
+            for (unsigned char c : sql) mix(c);
+            mix('\n');
+        }
+
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+        return std::string(buf);
+    } // schemaFingerprint
+
+    /**
+     * @brief Write the table and its child tables to the snapshot.
+     * @param w The snapshot writer.
+     * @return true if success; otherwise, false.
+     * @see DbMap<T>::writeSnapshot
+     */
+    virtual bool writeSnapshot(SnapshotWriter &w) {
+        (void)w;
+        std::cerr << "DbMapBase::writeSnapshot: not implemented" << std::endl;
+        return false;
+    }
+
+    /**
+     * @brief Delete the rows of the child tables whose parent row is deleted,
+     *     for the backend without ON DELETE CASCADE.
+     * @return true if success; otherwise, false.
+     * @see DbMap<T>::deleteOrphanRows
+     */
+    virtual bool deleteOrphanRows() {
+        return true;
+    }
+
+    /**
+     * @brief Explain the query plans of the statements generated for the table and its child tables.
+     * @param out The reports appended.
+     * @return true if success; otherwise, false.
+     * @see DbMap<T>::explainQueryPlans
+     */
+    virtual bool explainQueryPlans(std::vector<QueryPlanReport> &out) {
+        (void)out;
+        std::cerr << "DbMapBase::explainQueryPlans: not implemented" << std::endl;
+        return false;
+    }
 }; // DbMapBase
 
 
@@ -0,0 +1,180 @@
+/**
+ * @file DbMapColumnExporter.h
+ * @brief DbMapColumnExporter.h defines the DbMap::ColumnExporter class for exporting columns.
+ * @note This file is part of the edadb project, which provides a way to map objects to relations in the database.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <cstring>
+
+#include "DbMap.h"
+#include "DbMapOperation.h"
+#include "DbMapDbStmtOp.h"
+#include "ColumnBuffer.h"
+
+
+namespace edadb {
+
+
+// DbMap ColumnExporter: read the selected member columns of all rows
+// into struct-of-arrays buffers, without constructing T objects
+template <typename T>
+class DbMap<T>::ColumnExporter : public DbStmtOp {
+public:
+    ~ColumnExporter() = default;
+    ColumnExporter(DbMap &m, typename DbManager::Connection c = nullptr) : DbStmtOp(m, c) {}
+
+public:
+    /**
+     * @brief export the member columns to the buffers.
+     * @param bufs The buffers, cleared before export.
+     * @param members The scalar member pointers.
+     * @return The number of rows exported; -1 if error.
+     */
+    template <typename... Vs>
+    int64_t exportTo(std::tuple<ColumnBuffer<Vs>...> &bufs, Vs T::*... members) {
+        if (!prepareColumns(members...)) {
+            return -1;
+        }
+
+        std::apply([](auto &...b) { (b.clear(), ...); }, bufs);
+
+        int64_t rows = 0;
+        while (this->dbstmt.fetchStep()) {
+            fetchRow(bufs, rows++, std::index_sequence_for<Vs...>{});
+        }
+
+        return this->finalize() ? rows : -1;
+    } // exportTo
+
+    /**
+     * @brief export the member columns to the caller provided memory.
+     * @param spans The caller provided memory, stop when any span is full.
+     * @param members The scalar member pointers.
+     * @return The number of rows exported; -1 if error.
+     */
+    template <typename... Vs>
+    int64_t exportTo(std::tuple<ColumnSpan<Vs>...> &spans, Vs T::*... members) {
+        size_t capacity = SIZE_MAX;
+        std::apply([&capacity](auto &...s) {
+            ((capacity = std::min(capacity, s.capacity)), ...);
+        }, spans);
+
+        if (!prepareColumns(members...)) {
+            return -1;
+        }
+
+        std::apply([capacity](auto &...s) {
+            ((s.null_bitmap ? (void)std::memset(s.null_bitmap, 0, (capacity + 7) / 8) : (void)0), ...);
+        }, spans);
+
+        int64_t rows = 0;
+        while ((static_cast<size_t>(rows) < capacity) && this->dbstmt.fetchStep()) {
+            fetchRow(spans, rows++, std::index_sequence_for<Vs...>{});
+        }
+
+        return this->finalize() ? rows : -1;
+    } // exportTo
+
+private:
+    /**
+     * @brief prepare the statement selecting the member columns.
+     * @return true if prepared; otherwise, false.
+     */
+    template <typename... Vs>
+    bool prepareColumns(Vs T::*... members) {
+        std::vector<std::string> cols;
+        bool ok = true;
+        ((ok = ok && appendColumn(cols, members)), ...);
+        if (!ok) {
+            return false;
+        }
+
+        return this->template prepareImpl<DbMapOperation::SCAN_COLUMNS>(
+            [&]() {
+                return DbMapOpTrait<T, DbMapOperation::SCAN_COLUMNS>::getSQL(this->dbmap, cols);
+            }
+        );
+    } // prepareColumns
+
+    /**
+     * @brief append the column name of the member.
+     * @return true if the member is a scalar member; otherwise, false.
+     */
+    template <typename V>
+    bool appendColumn(std::vector<std::string> &cols, V T::*member) {
+        static_assert(!std::is_pointer_v<V>,
+            "DbMap::ColumnExporter: pointer member is not supported");
+
+        // locate the member in TypeMetaData<T>::getVal by address and type
+        T probe{};
+        const void *addr = &(probe.*member);
+        int idx = -1, i = 0;
+        auto values = TypeMetaData<T>::getVal(&probe);
+        boost::fusion::for_each(values, [&](auto const &ne) {
+            using ElemPtr = std::remove_cv_t<std::remove_reference_t<decltype(ne)>>;
+            if constexpr (std::is_same_v<ElemPtr, V *>) {
+                if (static_cast<const void *>(ne) == addr) idx = i;
+            }
+            ++i;
+        });
+
+        std::string col = (idx < 0) ? "" :
+            DbMap<T>::getMemberColumnName(TypeMetaData<T>::member_names().at(idx));
+        if (col.empty()) {
+            std::cerr << "DbMap::ColumnExporter: member is not a scalar column of "
+                << TypeMetaData<T>::class_name() << std::endl;
+            return false;
+        }
+
+        cols.push_back(col);
+        return true;
+    } // appendColumn
+
+    template <typename Tuple, size_t... Is>
+    void fetchRow(Tuple &dst, int64_t row, std::index_sequence<Is...>) {
+        (fetchCell(std::get<Is>(dst), this->manager.s_read_column_begin_index + Is, row), ...);
+    } // fetchRow
+
+    template <typename V>
+    void fetchCell(ColumnBuffer<V> &buf, int idx, int64_t row) {
+        if (!fetchValue(idx, buf.append()))
+            buf.setNull(row);
+    } // fetchCell
+
+    template <typename V>
+    void fetchCell(ColumnSpan<V> &span, int idx, int64_t row) {
+        if (!fetchValue(idx, span.data + row))
+            span.setNull(row);
+    } // fetchCell
+
+    /**
+     * @brief fetch the column value.
+     * @return true if the value is not null; otherwise, false and set to V().
+     */
+    template <typename V>
+    bool fetchValue(int idx, V *v) {
+        if (this->dbstmt.fetchNull(idx)) {
+            *v = V();
+            return false;
+        }
+
+        if constexpr (std::is_enum_v<V>) {
+            std::underlying_type_t<V> tmp{};
+            this->dbstmt.fetchColumn(idx, &tmp);
+            *v = static_cast<V>(tmp);
+        } else {
+            this->dbstmt.fetchColumn(idx, v);
+        }
+        return true;
+    } // fetchValue
+}; // DbMap::ColumnExporter
+
+
+} // namespace edadb
@@ -11,6 +11,8 @@
 #include "DbManager.h"
 #include "DbMap.h"
 #include "DbMapOperation.h"
+#include "OpStats.h"
+#include "EncodedRow.h"
 #include "SqlStatement.h"
 #include "backend/sqlite/SqlStatement4Sqlite.h"
 
@@ -32,6 +34,12 @@ protected:
     DbMap     &dbmap;
     DbManager &manager;
 
+    /**
+     * The connection to run the statement, nullptr for the main connection.
+     * Child statements run on the same connection as the parent statement.
+     */
+    typename DbManager::Connection conn = nullptr;
+
     /**
      * The writer needs to insert the objects into different tables,
      * otherwise maybe use inline static thread_local variables:
@@ -43,10 +51,22 @@ protected:
 
     DbMapOperation op = DbMapOperation::NONE;
 
+    /**
+     * The statistics entry of the prepared operation on the table,
+     * nullptr if OpStats is disabled when prepared.
+     */
+    OpStatsEntry *stats = nullptr;
+
+    /**
+     * The row recording the values instead of dbstmt, set by encodeObject only.
+     */
+    EncodedRow *encode_row = nullptr;
+
 
 protected:
     virtual ~DbStmtOp(void) = default;
-    DbStmtOp(DbMap &m) : dbmap(m), manager(m.getManager()),
+    DbStmtOp(DbMap &m, typename DbManager::Connection c = nullptr) :
+        dbmap(m), manager(m.getManager()), conn(c),
         bind_idx(manager.s_bind_column_begin_index)
     {
         resetBindIndex();
@@ -90,19 +110,35 @@ public: // utility
             return false;
         }
 
-        if (!manager.initStatement(dbstmt)) {
+        OpStatsEntry *entry = OpStats::enabled() ?
+            OpStats::i().entry(dbmap.getTableName(), DbMapOpTrait<T, OP>::name()) : nullptr;
+        OpStatsTimer timer(entry, OpPhase::PREPARE);
+
+        if (!manager.initStatement(dbstmt, conn)) {
             std::cerr << "DbMap::DbStmtOp::prepareImpl ["
                 << DbMapOpTrait<T, OP>::name() << "]: init statement failed" << std::endl;
+            timer.stop(false);
             return false;
         }
 
-        const std::string sql = buildSql();
-        if (!dbstmt.prepare(sql)) {
+        // insert by the appender in bulk if the backend has, 
+        // the columns are bound in the same order as the table columns
+        bool prepared = false;
+        if constexpr ((OP == DbMapOperation::INSERT) && DbStatement::has_appender) {
+            prepared = dbstmt.prepareAppend(dbmap.getTableName());
+        } else {
+            prepared = dbstmt.prepare(buildSql());
+        }
+        if (!prepared) {
             std::cerr << "DbMap::DbStmtOp::prepareImpl ["
                 << DbMapOpTrait<T, OP>::name() << "]: prepare failed" << std::endl;
+            timer.stop(false);
             return false;
         }
+        timer.stop(true);
+        dbstmt.setLabel(dbmap.getTableName(), DbMapOpTrait<T, OP>::name());
 
+        stats = entry;
         op = DbMapOpTrait<T, OP>::op();
         return true;
     } // prepareImpl
@@ -129,19 +165,24 @@ public: // utility
             return false;
         }
 
+        OpStatsTimer timer(stats, OpPhase::EXECUTE);
+
         /**
          * lamda function to bind the object and communicate with the database 
          */
         if (func() < 0) {
             std::cerr << "DbMap::" << DbMapOpTrait<T, OP>::name()
                 << "::executeImpl: bind failed" << std::endl;
+            timer.stop(false);
             return false;
         }
 
         if (!dbstmt.reset()) {
+            timer.stop(false);
             return false;
         }
 
+        timer.stop(true, 1);
         return true;
     } // executeImpl
 
@@ -155,8 +196,13 @@ public: // utility
             return false;
         }
 
+        OpStatsTimer timer(stats, OpPhase::FINALIZE);
         op = DbMapOperation::NONE;
-        return dbstmt.finalize();
+        stats = nullptr;
+
+        const bool ok = dbstmt.finalize();
+        timer.stop(ok);
+        return ok;
     } // finalize
 
 
@@ -311,7 +357,7 @@ protected:
         else if constexpr (std::is_enum_v<CppType>) {
             if (is_nullptr) {
                 // bind nullptr to the column
-                int got = dbstmt.bindNull(bind_idx++);
+                int got = bindNullValue();
                 ok = got < 0 ? got : ok;
             } else {
                 // bind the enum member to underlying type:
@@ -320,7 +366,7 @@ protected:
             
                 // type safe cast during compile time
                 U tmp = static_cast<U>(*cpp_val_ptr); 
-                int got = dbstmt.bindColumn(bind_idx++, &tmp);
+                int got = bindValue(&tmp);
                 ok = got < 0 ? got : ok + got;
             }
         }
@@ -329,11 +375,11 @@ protected:
             // only base type needs to be bound
             if (is_nullptr) {
                 // bind nullptr to the column
-                int got = dbstmt.bindNull(bind_idx++);
+                int got = bindNullValue();
                 ok = got < 0 ? got : ok;
             } else {
                 // bind the value to the column
-                int got = dbstmt.bindColumn(bind_idx++, cpp_val_ptr);
+                int got = bindValue(cpp_val_ptr);
                 ok = got < 0 ? got : ok + got;
             }
         } // if constexpr SQLType::Composite
@@ -342,6 +388,27 @@ protected:
     } // bindToColumn
 
 
+    /**
+     * @brief bind the member of the object to the next place holder.
+     * @param obj The object to bind.
+     * @param idx The member index defined in TABLE4CLASS, must be a scalar member.
+     * @return >0 if success; 0 if the member is nullptr; -1 if error.
+     */
+    int bindMember(T *obj, int idx) {
+        int ok = -1;
+        int i = 0;
+        auto values = TypeMetaData<T>::getVal(obj);
+        boost::fusion::for_each(
+            values,
+            [this, &ok, &i, idx](auto const &ne) {
+                if (i++ == idx)
+                    ok = this->bindToColumn(ne, nullptr);
+            }
+        );
+        return ok;
+    } // bindMember
+
+
     /**
      * @brief bind the object to the database.
      * @tparam ParentType The parent type, default is void.
@@ -358,14 +425,29 @@ protected:
         // reset bind_idx to begin to bind
         resetBindIndex();
 
+        // the rowid key left 0: inserted as NULL and written back after the step,
+        // or assigned before the bind if the backend cannot assign it
+        bool null_key = rowidKeyUnset(obj);
+        if (null_key && !DbManager::s_assign_rowid_key) {
+            if (!assignRowidKey(obj)) {
+                return -1;
+            }
+            null_key = false;
+        }
+
         // iterate through the non-vector members and bind them
         // @see DbMap<T>::Writer::bindToColumn for the recursive calling
+        int midx = 0;
         auto values = TypeMetaData<T>::getVal(obj);
         boost::fusion::for_each(
             values,
-            [this, &ok, &all_nullptr](auto const &ne) {
+            [this, &ok, &all_nullptr, &midx, null_key](auto const &ne) {
                 int got = 0; 
-                if (ok >= 0)
+                if ((ok >= 0) && null_key && (midx++ == 0)) {
+                    all_nullptr = false;
+                    got = this->bindNullValue() ? 1 : -1;
+                }
+                else if (ok >= 0)
                     got = this->bindToColumn(ne, &all_nullptr);
 
                 // got < 0 means bind failed, skip the rest binding
@@ -377,6 +459,10 @@ protected:
         // all members are nullptr, nothing to bind
         // vector<ElemT>* members are also skipped since no primary key available
         if (all_nullptr) {
+            if (encode_row != nullptr) {
+                encode_row->clear();
+                return 0;
+            }
             dbstmt.clearBindings();
             dbstmt.reset();
             return 0; 
@@ -406,7 +492,7 @@ protected:
                         assert(pk_val_ptr2bind != nullptr &&
                             "DbMap::Writer::bindObject: primary key value pointer is null");
                         
-                        int got = dbstmt.bindColumn(bind_idx++, pk_val_ptr2bind);
+                        int got = bindValue(pk_val_ptr2bind);
                         ok = got < 0 ? got : ok + got;
                     }
                } // lambda function
@@ -417,7 +503,7 @@ protected:
         // ignore no ParentType (= void) during compile time
         // Otherwise, bind DbMap<T> foreign key value from ParentType p
         if constexpr (!std::is_same_v<ParentType, void>) {
-            assert(this->dbmap.getForeignKey().valid());
+            assert(this->dbmap.getThisForeignKey().valid());
 
             // bind the foreign key value (1st column in parent)
             auto fk_def_ptr = boost::fusion::at_c<Config::fk_ref_pk_col_index>
@@ -427,18 +513,106 @@ protected:
             auto fk_val_ptr = TypeInfoTrait<DefType>::getCppPtr2Bind(fk_def_ptr);
             assert(fk_val_ptr != nullptr &&
                 "DbMap::Writer::bindObject: foreign key value pointer is null");
-            int got = dbstmt.bindColumn(bind_idx++, fk_val_ptr);
+            int got = bindValue(fk_val_ptr);
             ok = got < 0 ? got : ok + got;
         } // if 
 
 
+        // encoding: the row is stepped and the children are inserted by the writer thread
+        if (encode_row != nullptr) {
+            return ok;
+        }
+
         // autoStep: run backend db step statement automatically
         // bind the this tuple before bind the child tuple referencing this primary key
-        if (autoStep && !(ok = dbstmt.bindStep())) {
+        if (autoStep && !dbstmt.bindStep()) {
             std::cerr << "DbMap::Writer::bindObject: bind step failed" << std::endl;
-            return ok;
+            return -1;
+        }
+
+        // the children reference the rowid key written back
+        if (null_key && autoStep) {
+            writeBackRowidKey(obj);
+        }
+        bindChildren(obj);
+        return ok;
+    } // bindObject
+
+
+    /**
+     * @brief encode the columns of the object into the row instead of binding them,
+     *     the DbStmtOp is not prepared and used by one thread only.
+     * @param obj The object to encode.
+     * @param row The row of the values, cleared first.
+     * @param p The parent object, if any, to encode the foreign key value.
+     * @return > 0 if encoded; 0 if all members are nullptr; -1 if failed.
+     */
+    template <typename ParentType = void>
+    int encodeObject(T *obj, EncodedRow &row, ParentType *p = nullptr) {
+        row.clear();
+        encode_row = &row;
+        const int ok = bindObject(obj, p, false);
+        encode_row = nullptr;
+        return ok;
+    } // encodeObject
+
+
+    /**
+     * @brief check if the rowid key of the object to insert is left 0 to be assigned,
+     *     see TABLE4CLASS_ROWID.
+     * @param obj The object.
+     * @return true if the key is assigned on insert; otherwise, false.
+     */
+    bool rowidKeyUnset(T *obj) const {
+        if constexpr (RowidKeyTrait<T>::value) {
+            const PkType *key = DbMap<T>::getPrimaryKey(obj);
+            return ((op == DbMapOperation::INSERT) || (encode_row != nullptr)) &&
+                (key != nullptr) && (*key == 0);
+        } else {
+            (void)obj;
+            return false;
+        }
+    } // rowidKeyUnset
+
+    /**
+     * @brief write the rowid assigned by the last insert on the connection back to the key.
+     * @param obj The object inserted.
+     */
+    void writeBackRowidKey(T *obj) {
+        if constexpr (RowidKeyTrait<T>::value) {
+            *DbMap<T>::getPrimaryKey(obj) = static_cast<PkType>(manager.lastInsertRowid(conn));
+        } else {
+            (void)obj;
+        }
+    } // writeBackRowidKey
+
+    /**
+     * @brief assign the rowid key before insert if the backend cannot assign it on insert.
+     * @param obj The object to insert.
+     * @return true if assigned; otherwise, false.
+     */
+    bool assignRowidKey(T *obj) {
+        if constexpr (RowidKeyTrait<T>::value) {
+            int64_t key = 0;
+            if (!manager.nextRowidKey(dbmap.getTableName(),
+                    TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index], key)) {
+                std::cerr << "DbMap::DbStmtOp::assignRowidKey: assign key failed" << std::endl;
+                return false;
+            }
+            *DbMap<T>::getPrimaryKey(obj) = static_cast<PkType>(key);
+        } else {
+            (void)obj;
         }
+        return true;
+    } // assignRowidKey
+
 
+    /**
+     * @brief insert the child vectors of the object referencing its primary key,
+     *     after the row of the object is stepped.
+     * @param obj The object.
+     */
+    void bindChildren(T *obj) {
         // CompositeVector type: use obj as primary key to bind the child
         // constexpr to avoid compile time error
         if constexpr (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector) {
@@ -448,14 +622,27 @@ protected:
                 ve,
                 [&](auto ptr) { // boost::fusion::vector<ElemT>* pointer
                     // if ptr pointing to nullptr pointer, skip binding
-                    int got = this->bindChildVector(obj, vidx, ptr);
-                    got = got < 0 ? got : ok + got;
+                    this->bindChildVector(obj, vidx, ptr);
                 } // lambda function
             ); // boost::fusion::for_each
         } // if constexpr SqlType::CompositeVector
+    } // bindChildren
 
-        return ok;
-    } // bindObject
+
+    /**
+     * @brief bind the value to the next place holder, or record it if encoding.
+     * @return true if bound; otherwise, false.
+     */
+    template <typename V>
+    bool bindValue(V *v) {
+        return (encode_row != nullptr) ?
+            encode_row->bindColumn(bind_idx++, v) : dbstmt.bindColumn(bind_idx++, v);
+    }
+
+    bool bindNullValue() {
+        return (encode_row != nullptr) ?
+            encode_row->bindNull(bind_idx++) : dbstmt.bindNull(bind_idx++);
+    }
 
 
     template <typename DefVecPtr>
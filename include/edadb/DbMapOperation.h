@@ -23,10 +23,16 @@ enum class DbMapOperation {
     UPDATE,
     DELETE,
     SCAN,
+    SCAN_ORDERED,
+    SCAN_RANGE,
+    SCAN_COLUMNS,
+    SCAN_SNAPSHOT,
 
     QUERY_PREDICATE,
     QUERY_PRIMARY_KEY,
+    QUERY_PRIMARY_KEYS,
     QUERY_FOREIGN_KEY, 
+    QUERY_KEYSET_PAGE,
 
     MAX
 }; // DbMapOperation
@@ -103,6 +109,66 @@ struct DbMapOpTrait<T, DbMapOperation::SCAN> {
 };
 
 
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::SCAN_ORDERED> {
+    static constexpr const char *name() {
+        return "ScanOrdered";
+    }
+    static std::string getSQL(DbMap<T> &dbmap, const std::string &col,
+            SortOrder order, bool with_limit) {
+        return SqlStatement<T>::orderedScanStatement(
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey(), col, order, with_limit);
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::SCAN_ORDERED;
+    }
+};
+
+
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::SCAN_RANGE> {
+    static constexpr const char *name() {
+        return "ScanRange";
+    }
+    static std::string getSQL(DbMap<T> &dbmap) {
+        return SqlStatement<T>::rangeScanStatement(
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey());
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::SCAN_RANGE;
+    }
+};
+
+
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::SCAN_COLUMNS> {
+    static constexpr const char *name() {
+        return "ScanColumns";
+    }
+    static std::string getSQL(DbMap<T> &dbmap, const std::vector<std::string> &cols) {
+        return SqlStatement<T>::scanColumnsStatement(dbmap.getTableName(), cols);
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::SCAN_COLUMNS;
+    }
+};
+
+
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::SCAN_SNAPSHOT> {
+    static constexpr const char *name() {
+        return "ScanSnapshot";
+    }
+    static std::string getSQL(DbMap<T> &dbmap) {
+        return SqlStatement<T>::snapshotScanStatement(
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey());
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::SCAN_SNAPSHOT;
+    }
+};
+
+
 template <typename T>
 struct DbMapOpTrait<T, DbMapOperation::QUERY_PREDICATE> {
     static constexpr const char *name() {
@@ -110,7 +176,7 @@ struct DbMapOpTrait<T, DbMapOperation::QUERY_PREDICATE> {
     }
     static std::string getSQL(DbMap<T> &dbmap, const std::string &pred) {
         return SqlStatement<T>::queryPredicateStatement(
-            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey());
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey(), pred);
     }
     static DbMapOperation op() {
         return DbMapOperation::QUERY_PREDICATE;
@@ -133,6 +199,21 @@ struct DbMapOpTrait<T, DbMapOperation::QUERY_PRIMARY_KEY> {
 };
 
 
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::QUERY_PRIMARY_KEYS> {
+    static constexpr const char *name() {
+        return "QueryPrimaryKeys";
+    }
+    static std::string getSQL(DbMap<T> &dbmap, size_t n) {
+        return SqlStatement<T>::queryPrimaryKeysStatement(
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey(), n);
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::QUERY_PRIMARY_KEYS;
+    }
+};
+
+
 template <typename T>
 struct DbMapOpTrait<T, DbMapOperation::QUERY_FOREIGN_KEY> {
     static constexpr const char *name() {
@@ -148,4 +229,20 @@ struct DbMapOpTrait<T, DbMapOperation::QUERY_FOREIGN_KEY> {
 };
 
 
+template <typename T>
+struct DbMapOpTrait<T, DbMapOperation::QUERY_KEYSET_PAGE> {
+    static constexpr const char *name() {
+        return "QueryKeysetPage";
+    }
+    static std::string getSQL(DbMap<T> &dbmap, const std::string &col,
+            SortOrder order, bool has_after, bool null_run) {
+        return SqlStatement<T>::keysetPageStatement(
+            dbmap.getThisForeignKey(), dbmap.getWorkForeignKey(), col, order, has_after, null_run);
+    }
+    static DbMapOperation op() {
+        return DbMapOperation::QUERY_KEYSET_PAGE;
+    }
+};
+
+
 } // namespace edadb
\ No newline at end of file
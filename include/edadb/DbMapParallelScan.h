@@ -0,0 +1,290 @@
+/**
+ * @file DbMapParallelScan.h
+ * @brief DbMapParallelScan.h provides the parallel partitioned scan of the DbMap table.
+ * @note The table is split by rowid ranges, each worker thread scans the ranges
+ *     on its own read connection, and steals ranges from the others when idle.
+ *     The read connections are pinned to one snapshot, so the workers read the same commit.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include "DbMap.h"
+#include "DbMapOperation.h"
+#include "DbMapReader.h"
+#include "ReadSnapshot.h"
+
+
+namespace edadb {
+
+
+/**
+ * @struct ScanRange
+ * @brief The rowid range [begin, last] of one scan partition,
+ *     inclusive so the range ending at the max rowid has no end past it.
+ */
+struct ScanRange {
+    int64_t begin = 0;
+    int64_t last  = 0;
+}; // ScanRange
+
+
+/**
+ * @class RangeScheduler
+ * @brief Work stealing scheduler of the scan ranges:
+ *     each worker owns a deque of ranges and pops from its front,
+ *     an idle worker steals from the back of the other workers,
+ *     so the skewed ranges (dense rowids) are balanced at runtime.
+ */
+class RangeScheduler {
+private:
+    struct WorkerQueue {
+        std::mutex mtx;
+        std::deque<ScanRange> ranges;
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+public:
+    RangeScheduler(size_t num_workers) {
+        for (size_t i = 0; i < std::max<size_t>(num_workers, 1); ++i)
+            queues.emplace_back(new WorkerQueue());
+    }
+    ~RangeScheduler() = default;
+
+public:
+    /**
+     * @brief assign the ranges to the workers in contiguous blocks,
+     *     neighbor ranges stay in the same worker for locality.
+     * @param ranges The ranges to assign.
+     */
+    void assign(const std::vector<ScanRange> &ranges) {
+        const size_t n = queues.size();
+        const size_t block = (ranges.size() + n - 1) / n;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            queues[i / block]->ranges.push_back(ranges[i]);
+        }
+    } // assign
+
+    /**
+     * @brief get the next range for the worker.
+     * @param worker The worker id.
+     * @param r The next range.
+     * @return true if got a range; false if all ranges are done.
+     */
+    bool next(size_t worker, ScanRange &r) {
+        // pop from the front of its own queue
+        {
+            WorkerQueue &q = *queues[worker];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.ranges.empty()) {
+                r = q.ranges.front();
+                q.ranges.pop_front();
+                return true;
+            }
+        }
+
+        // steal from the back of the other queues
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkerQueue &q = *queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.ranges.empty()) {
+                r = q.ranges.back();
+                q.ranges.pop_back();
+                return true;
+            }
+        }
+        return false;
+    } // next
+}; // RangeScheduler
+
+
+
+/**
+ * @class ParallelScanner
+ * @brief Scan the DbMap table in parallel, each worker thread reads its ranges
+ *     on its own read connection of the snapshot and hands the objects to the user callback.
+ * @tparam T The class type.
+ */
+template <typename T>
+class ParallelScanner {
+private:
+    DbMap<T> &dbmap;
+    DbManager &manager;
+
+    size_t num_threads;       // number of worker threads
+    size_t ranges_per_thread; // number of ranges per thread to balance the skew
+
+    ReadSnapshot *snapshot = nullptr; // shared with the other scans; nullptr to pin its own
+
+public:
+    ParallelScanner(DbMap<T> &m, size_t threads = 0, size_t ranges = 8)
+        : dbmap(m), manager(m.getManager()),
+          num_threads(threads), ranges_per_thread(std::max<size_t>(ranges, 1))
+    {
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+    }
+
+    /**
+     * @brief ctor of the scan on the snapshot shared with the other scans,
+     *     one worker thread per connection of the snapshot.
+     */
+    ParallelScanner(DbMap<T> &m, ReadSnapshot &snap, size_t ranges = 8)
+        : dbmap(m), manager(m.getManager()),
+          num_threads(snap.size()), ranges_per_thread(std::max<size_t>(ranges, 1)),
+          snapshot(&snap)
+    {}
+    ~ParallelScanner() = default;
+
+public:
+    /**
+     * @brief scan the table in parallel.
+     * @param func The callback bool(size_t worker, T *obj), called in the worker thread.
+     *     The obj is only valid during the call; return false to stop the scan.
+     * @return The number of objects scanned; -1 if error.
+     */
+    template <typename Func>
+    int64_t scan(Func func) {
+        if (!manager.isConnected()) {
+            std::cerr << "ParallelScanner::scan: not inited" << std::endl;
+            return -1;
+        }
+
+        // the private in-memory database, such as ":memory:", cannot be read by the other connections
+        if ((snapshot == nullptr) && !manager.canOpenReadConnection()) {
+            return scanSerial(func);
+        }
+
+        std::unique_ptr<ReadSnapshot> owned;
+        ReadSnapshot *snap = snapshot;
+        if (snap == nullptr) {
+            owned.reset(new ReadSnapshot(manager, num_threads));
+            snap = owned.get();
+        }
+        if (!snap->valid() || (snap->size() < num_threads)) {
+            std::cerr << "ParallelScanner::scan: pin the read connections failed" << std::endl;
+            return -1;
+        }
+
+        // the range of the snapshot, not of the later commits
+        int64_t lo = 0, hi = 0;
+        if (!manager.rowidRange(dbmap.getTableName(), lo, hi, snap->connection(0))) {
+            return 0; // empty table
+        }
+
+        RangeScheduler scheduler(num_threads);
+        scheduler.assign(split(lo, hi));
+
+        std::atomic<int64_t> rows{0};
+        std::atomic<bool> stop{false};
+        std::atomic<bool> failed{false};
+
+        auto worker = [&](size_t wid) {
+            auto conn = snap->connection(wid);
+
+            ScanRange r;
+            int64_t local_rows = 0;
+            while (!stop && scheduler.next(wid, r)) {
+                typename DbMap<T>::Reader reader(dbmap, conn);
+                if (!reader.prepareRangeScan(r.begin, r.last)) {
+                    failed = true;
+                    stop = true;
+                    break;
+                }
+
+                while (!stop) {
+                    T obj{};
+                    if (!reader.read(&obj)) {
+                        if (reader.fetchFailed()) {
+                            failed = true;
+                            stop = true;
+                        }
+                        break;
+                    }
+                    ++local_rows;
+                    if (!func(wid, &obj)) {
+                        stop = true;
+                    }
+                } // while
+
+                reader.finalize();
+            } // while
+
+            rows += local_rows;
+        }; // worker
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back(worker, i);
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        if (failed) {
+            std::cerr << "ParallelScanner::scan: scan failed" << std::endl;
+            return -1;
+        }
+        return rows;
+    } // scan
+
+private:
+    /**
+     * @brief scan the table on the main connection in the calling thread as worker 0.
+     * @return The number of objects scanned; -1 if error.
+     */
+    template <typename Func>
+    int64_t scanSerial(Func func) {
+        typename DbMap<T>::Reader reader(dbmap);
+        if (!reader.prepare2Scan()) {
+            std::cerr << "ParallelScanner::scanSerial: prepare failed" << std::endl;
+            return -1;
+        }
+
+        int64_t rows = 0;
+        while (true) {
+            T obj{};
+            if (!reader.read(&obj)) break;
+            ++rows;
+            if (!func(size_t(0), &obj)) break;
+        }
+        const bool failed = reader.fetchFailed();
+        reader.finalize();
+        return failed ? -1 : rows;
+    } // scanSerial
+
+    /**
+     * @brief split the rowid range [lo, hi] into ranges,
+     *     the offsets from lo are in uint64_t, hi - lo overflows int64_t for the far apart rowids.
+     */
+    std::vector<ScanRange> split(int64_t lo, int64_t hi) const {
+        // the span is width + 1, which overflows uint64_t for [INT64_MIN, INT64_MAX]
+        const uint64_t width = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+        const uint64_t wanted = num_threads * ranges_per_thread;
+        const uint64_t count = (width < wanted) ? width + 1 : wanted;
+        const uint64_t step  = width / count + 1; // ceil((width + 1) / count)
+
+        std::vector<ScanRange> ranges;
+        for (uint64_t off = 0; ; off += step) {
+            const uint64_t rest  = width - off;
+            const uint64_t begin = static_cast<uint64_t>(lo) + off;
+            const uint64_t last  = begin + std::min<uint64_t>(rest, step - 1);
+            ranges.push_back(ScanRange{static_cast<int64_t>(begin), static_cast<int64_t>(last)});
+            if (rest < step) break;
+        }
+        return ranges;
+    } // split
+}; // ParallelScanner
+
+
+} // namespace edadb
@@ -0,0 +1,75 @@
+/**
+ * @file DbMapQueryPlan.h
+ * @brief DbMapQueryPlan.h explains the query plans of the statements generated by DbMap,
+ *     to find the full table scans and the temporary sorts before they make a flow slow.
+ * @note This file is part of the edadb project, which provides a way to map objects to relations in the database.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "DbMap.h"
+#include "DbMapOperation.h"
+#include "QueryPlan.h"
+
+
+namespace edadb {
+
+
+template <typename T>
+bool DbMap<T>::explainQueryPlans(std::vector<QueryPlanReport> &out) {
+    if (!manager.isConnected()) {
+        std::cerr << "DbMap::explainQueryPlans: not inited" << std::endl;
+        return false;
+    }
+
+    // explain the statement and append the report
+    auto explain = [this, &out](const char *op, const std::string &sql, bool scan_expected) {
+        QueryPlanReport r;
+        r.table = getTableName();
+        r.op    = op;
+        r.sql   = sql;
+        r.scan_expected = scan_expected;
+        if (!manager.explainQueryPlan(sql, r.plan)) {
+            std::cerr << "DbMap::explainQueryPlans: explain " << op
+                << " on " << r.table << " failed" << std::endl;
+            return false;
+        }
+        r.analyze();
+        out.push_back(std::move(r));
+        return true;
+    };
+
+    // the statements built without the caller parameters, the insert has no plan to explain
+    using Op = DbMapOperation;
+    bool ok = true;
+    ok = ok && explain(DbMapOpTrait<T, Op::UPDATE>::name(),
+        DbMapOpTrait<T, Op::UPDATE>::getSQL(*this), false);
+    ok = ok && explain(DbMapOpTrait<T, Op::DELETE>::name(),
+        DbMapOpTrait<T, Op::DELETE>::getSQL(*this), false);
+    ok = ok && explain(DbMapOpTrait<T, Op::QUERY_PRIMARY_KEY>::name(),
+        DbMapOpTrait<T, Op::QUERY_PRIMARY_KEY>::getSQL(*this), false);
+    ok = ok && explain(DbMapOpTrait<T, Op::QUERY_PRIMARY_KEYS>::name(),
+        DbMapOpTrait<T, Op::QUERY_PRIMARY_KEYS>::getSQL(*this, 2), false);
+    if (this_fkc.valid()) {
+        ok = ok && explain(DbMapOpTrait<T, Op::QUERY_FOREIGN_KEY>::name(),
+            DbMapOpTrait<T, Op::QUERY_FOREIGN_KEY>::getSQL(*this), false);
+    }
+    ok = ok && explain(DbMapOpTrait<T, Op::SCAN>::name(),
+        DbMapOpTrait<T, Op::SCAN>::getSQL(*this), true);
+    ok = ok && explain(DbMapOpTrait<T, Op::SCAN_RANGE>::name(),
+        DbMapOpTrait<T, Op::SCAN_RANGE>::getSQL(*this), false);
+    ok = ok && explain(DbMapOpTrait<T, Op::SCAN_SNAPSHOT>::name(),
+        DbMapOpTrait<T, Op::SCAN_SNAPSHOT>::getSQL(*this), true);
+
+    for (auto &child : child_dbmap_vec) {
+        ok = ok && child->explainQueryPlans(out);
+    }
+    return ok;
+} // explainQueryPlans
+
+
+} // namespace edadb
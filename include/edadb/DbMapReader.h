@@ -9,6 +9,7 @@
 #include <iostream>
 #include <string>
 
+#include "DbError.h"
 #include "DbMap.h"
 #include "DbMapOperation.h"
 #include "DbMapDbStmtOp.h"
@@ -25,13 +26,34 @@ template <typename T>
 class DbMap<T>::Reader : public DbStmtOp {
 protected:
     uint32_t read_idx = 0;
+    size_t batch_size = 0; // primary key place holders of QUERY_PRIMARY_KEYS
+    bool pooled = false;   // the connection is acquired from the pool of WAL mode
+    bool fetch_failed = false; // the last read stopped at a row not fetched, not at the end
 
 public:
-    ~Reader() = default;
-    Reader(DbMap &m) : DbStmtOp(m) {
+    /**
+     * @brief ctor of the reader.
+     * @param m The DbMap to read.
+     * @param c The connection to read on; nullptr for a pooled read connection in WAL mode,
+     *     or the main connection otherwise.
+     */
+    Reader(DbMap &m, typename DbManager::Connection c = nullptr) :
+        DbStmtOp(m, (c != nullptr) ? c : m.getManager().acquireReadConnection())
+    {
+        pooled = (c == nullptr) && (this->conn != nullptr);
         resetReadIndex();
     }
 
+    ~Reader() {
+        // the connection is released after the statement on it is finalized
+        if (pooled) {
+            if (this->dbstmt.stmtIsPrepared()) {
+                this->dbstmt.finalize();
+            }
+            this->manager.releaseReadConnection(this->conn);
+        }
+    }
+
 public:
     /**
      * @brief prepare to read the object from the database.
@@ -41,6 +63,24 @@ public:
         return this->template prepareImpl<DbMapOperation::SCAN>();
     } // prepare2Scan
 
+    /**
+     * @brief prepare to read the objects in the rowid range [begin, last]
+     * @param begin The first rowid of the range.
+     * @param last The last rowid of the range.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareRangeScan(int64_t begin, int64_t last) {
+        bool ok = this->template prepareImpl<DbMapOperation::SCAN_RANGE>();
+        if (!ok) {
+            std::cerr << "DbMap::Reader::prepareRangeScan: prepare failed" << std::endl;
+            return false;
+        }
+
+        ok = ok && this->dbstmt.bindColumn(this->bind_idx++, &begin);
+        ok = ok && this->dbstmt.bindColumn(this->bind_idx++, &last);
+        return ok;
+    } // prepareRangeScan
+
     /**
      * @brief prepare to read the object from the database W/WO predicate.
      * @param pred The predicate to filter the object.
@@ -52,8 +92,8 @@ public:
         return this->template prepareImpl<DbMapOperation::QUERY_PREDICATE>(
             [&]() {
                 return SqlStatement<T>::queryPredicateStatement(
-                    this->dbmap.getTableName(),
-                    this->dbmap.getForeignKey(),
+                    this->dbmap.getThisForeignKey(),
+                    this->dbmap.getWorkForeignKey(),
                     pred
                 );
             }
@@ -79,6 +119,62 @@ public:
         return ok;
     } // prepareByPrimaryKey
 
+    /**
+     * @brief prepare to read the objects by a batch of primary keys,
+     *     use bindPrimaryKeys to bind each batch before reading.
+     * @param n The number of primary key place holders.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareByPrimaryKeys(size_t n) {
+        if (n == 0) {
+            std::cerr << "DbMap::Reader::prepareByPrimaryKeys: empty batch" << std::endl;
+            return false;
+        }
+
+        bool ok = this->template prepareImpl<DbMapOperation::QUERY_PRIMARY_KEYS>(
+            [&]() {
+                return DbMapOpTrait<T, DbMapOperation::QUERY_PRIMARY_KEYS>::getSQL(
+                    this->dbmap, n);
+            }
+        );
+        if (!ok) {
+            std::cerr << "DbMap::Reader::prepareByPrimaryKeys: prepare failed" << std::endl;
+            return false;
+        }
+
+        batch_size = n;
+        return true;
+    } // prepareByPrimaryKeys
+
+    /**
+     * @brief bind a batch of primary keys to the prepared statement,
+     *     the place holders after the n keys are bound to NULL, which never match.
+     * @param keys The primary keys, which must be alive until the batch is read.
+     * @param n The number of keys, should be no more than the prepared batch size.
+     * @return true if bound; otherwise, false.
+     */
+    bool bindPrimaryKeys(const typename DbMap<T>::PkType *keys, size_t n) {
+        if ((this->op != DbMapOperation::QUERY_PRIMARY_KEYS) || (n > batch_size)) {
+            std::cerr << "DbMap::Reader::bindPrimaryKeys: not prepared for " << n << " keys" << std::endl;
+            return false;
+        }
+
+        // reset the statement to bind the next batch
+        bool ok = this->dbstmt.reset() && this->dbstmt.clearBindings();
+        this->resetBindIndex();
+
+        for (size_t i = 0; ok && (i < batch_size); ++i) {
+            if (i < n) {
+                // bindColumn never modifies the value
+                auto key = const_cast<typename DbMap<T>::PkType *>(keys + i);
+                ok = this->dbstmt.bindColumn(this->bind_idx++, key);
+            } else {
+                ok = this->dbstmt.bindNull(this->bind_idx++);
+            }
+        }
+        return ok;
+    } // bindPrimaryKeys
+
     /**
      * @brief prepare to read the object from the database by foreign key
      * @param obj The object to read.
@@ -94,7 +190,7 @@ public:
 
         // get the foreign key value from the parent object to query as foreign key
         // read DbMap<T> foreign key value from ParentType p
-        assert(this->dbmap.getForeignKey().valid());
+        assert(this->dbmap.getThisForeignKey().valid());
 
         // get the foreign key from 1st column in parent
 //        auto fk_val_ptr = boost::fusion::at_c<Config::fk_ref_pk_col_index>
@@ -115,6 +211,234 @@ public:
     } // prepareByForeignKey
 
 
+    /**
+     * @brief prepare to scan the objects ordered by the member column,
+     *     the NULL member columns come last in both orders.
+     * @param member The scalar member to order by, empty to order by primary key.
+     * @param order The sort order.
+     * @param limit The max number of objects to read, 0 means no limit.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareOrderedScan(const std::string &member,
+            SortOrder order = SortOrder::ASC, uint64_t limit = 0) {
+        std::string col;
+        if (!member.empty() && (col = DbMap<T>::getMemberColumnName(member)).empty()) {
+            std::cerr << "DbMap::Reader::prepareOrderedScan: invalid member " << member << std::endl;
+            return false;
+        }
+
+        bool ok = this->template prepareImpl<DbMapOperation::SCAN_ORDERED>(
+            [&]() {
+                return DbMapOpTrait<T, DbMapOperation::SCAN_ORDERED>::getSQL(
+                    this->dbmap, col, order, (limit > 0));
+            }
+        );
+        if (!ok) {
+            std::cerr << "DbMap::Reader::prepareOrderedScan: prepare failed" << std::endl;
+            return false;
+        }
+
+        if (limit > 0) {
+            int64_t lim = static_cast<int64_t>(limit);
+            ok = this->dbstmt.bindColumn(this->bind_idx++, &lim);
+        }
+        return ok;
+    } // prepareOrderedScan
+
+    /**
+     * @brief prepare to read the top K objects ordered by the member column
+     * @param member The scalar member to order by.
+     * @param k The number of objects to read.
+     * @param order The sort order, default is DESC to get the largest K objects.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareTopK(const std::string &member, uint64_t k,
+            SortOrder order = SortOrder::DESC) {
+        if (k == 0) {
+            std::cerr << "DbMap::Reader::prepareTopK: k should be positive" << std::endl;
+            return false;
+        }
+        return prepareOrderedScan(member, order, k);
+    } // prepareTopK
+
+    /**
+     * @brief prepare to read the next page using keyset pagination:
+     *     seek after the last object of the previous page instead of OFFSET,
+     *     so the cost of the deep page is the same as the first page.
+     *     The NULL member columns come last in both orders, such as the rows before ALTER TABLE ADD COLUMN,
+     *     and are read in the primary key order by prepareKeysetNullRun when the others run out.
+     * @param after The last object of the previous page, nullptr for the first page.
+     * @param limit The page size.
+     * @param member The scalar member to order by, empty to order by primary key.
+     *     Use DbMap::createIndex(member) to make the seek index-backed.
+     * @param order The sort order.
+     * @param nulls_next Set true if the page seeks the non NULL member columns,
+     *     so the NULL ones follow when the page is short; otherwise, false.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareKeysetPage(T *after, uint64_t limit,
+            const std::string &member = "", SortOrder order = SortOrder::ASC,
+            bool *nulls_next = nullptr) {
+        std::string col;
+        int mem_idx = Config::fk_ref_pk_col_index;
+        if (!keysetColumn(member, col, mem_idx)) {
+            return false;
+        }
+
+        // the seek after a NULL column stays in the NULL run and binds the primary key only
+        const bool by_member = (mem_idx != static_cast<int>(Config::fk_ref_pk_col_index));
+        bool after_null = false;
+        if ((after != nullptr) && by_member &&
+                !pointerMemberIsNull(after, mem_idx, after_null) &&
+                !columnIsNull(after, col, after_null)) {
+            std::cerr << "DbMap::Reader::prepareKeysetPage: check seek key failed" << std::endl;
+            return false;
+        }
+
+        if (nulls_next != nullptr) {
+            *nulls_next = by_member && !after_null;
+        }
+        return prepareKeysetSeek(after, limit, col, mem_idx, order, after_null);
+    } // prepareKeysetPage
+
+    /**
+     * @brief prepare to read the first page of the NULL member columns,
+     *     which come after the non NULL ones in both orders.
+     * @param limit The page size.
+     * @param member The scalar member to order by.
+     * @param order The sort order of the primary key.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareKeysetNullRun(uint64_t limit, const std::string &member,
+            SortOrder order = SortOrder::ASC) {
+        std::string col;
+        int mem_idx = Config::fk_ref_pk_col_index;
+        if (!keysetColumn(member, col, mem_idx)) {
+            return false;
+        }
+        if (mem_idx == static_cast<int>(Config::fk_ref_pk_col_index)) {
+            std::cerr << "DbMap::Reader::prepareKeysetNullRun: primary key is never NULL" << std::endl;
+            return false;
+        }
+        return prepareKeysetSeek(nullptr, limit, col, mem_idx, order, true);
+    } // prepareKeysetNullRun
+
+private:
+    /**
+     * @brief get the column and the member index to order the keyset pages by.
+     * @param member The scalar member, empty for the primary key.
+     * @param col The column name, empty for the primary key.
+     * @param mem_idx The member index defined in TABLE4CLASS.
+     * @return true if the member is valid; otherwise, false.
+     */
+    static bool keysetColumn(const std::string &member, std::string &col, int &mem_idx) {
+        if (member.empty()) {
+            return true;
+        }
+        col = DbMap<T>::getMemberColumnName(member);
+        mem_idx = DbMap<T>::getMemberIndex(member);
+        if (col.empty()) {
+            std::cerr << "DbMap::Reader::keysetColumn: invalid member " << member << std::endl;
+            return false;
+        }
+        return true;
+    } // keysetColumn
+
+    /**
+     * @brief prepare the keyset page statement and bind the seek key and the limit.
+     * @param after The last object of the previous page, nullptr for the first page of the run.
+     * @param limit The page size.
+     * @param col The column name, empty for the primary key.
+     * @param mem_idx The member index of the column.
+     * @param order The sort order.
+     * @param null_run If true, seek in the NULL columns by the primary key only.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareKeysetSeek(T *after, uint64_t limit, const std::string &col, int mem_idx,
+            SortOrder order, bool null_run) {
+        if (limit == 0) {
+            std::cerr << "DbMap::Reader::prepareKeysetPage: limit should be positive" << std::endl;
+            return false;
+        }
+
+        bool ok = this->template prepareImpl<DbMapOperation::QUERY_KEYSET_PAGE>(
+            [&]() {
+                return DbMapOpTrait<T, DbMapOperation::QUERY_KEYSET_PAGE>::getSQL(
+                    this->dbmap, col, order, (after != nullptr), null_run);
+            }
+        );
+        if (!ok) {
+            std::cerr << "DbMap::Reader::prepareKeysetPage: prepare failed" << std::endl;
+            return false;
+        }
+
+        // bind the seek key (member, primary key) of the last object
+        if (after != nullptr) {
+            const bool by_member = (mem_idx != static_cast<int>(Config::fk_ref_pk_col_index));
+            if (by_member && !null_run) {
+                ok = (this->bindMember(after, mem_idx) > 0);
+            }
+            ok = ok && (this->bindMember(after, Config::fk_ref_pk_col_index) > 0);
+            if (!ok) {
+                std::cerr << "DbMap::Reader::prepareKeysetPage: bind seek key failed" << std::endl;
+                return false;
+            }
+        } // if
+
+        int64_t lim = static_cast<int64_t>(limit);
+        return this->dbstmt.bindColumn(this->bind_idx++, &lim);
+    } // prepareKeysetSeek
+
+    /**
+     * @brief check if the column of the row of the object is NULL in the database,
+     *     the NULL column is read as the default value if the member is not a pointer.
+     *     The probe is counted as the keyset page operation in OpStats and the slow log.
+     * @param obj The object to get the primary key value.
+     * @param col The column name of the member.
+     * @param is_null true if the column is NULL, false if not or the row is not found.
+     * @return true if checked; otherwise, false.
+     */
+    bool columnIsNull(T *obj, const std::string &col, bool &is_null) {
+        Reader probe(this->dbmap, this->conn);
+        bool ok = probe.template prepareImpl<DbMapOperation::QUERY_KEYSET_PAGE>(
+            [&]() {
+                return SqlStatement<T>::queryColumnByKeyStatement(this->dbmap.getTableName(), col);
+            }
+        );
+        ok = ok && (probe.bindMember(obj, Config::fk_ref_pk_col_index) > 0);
+        if (ok) {
+            is_null = probe.dbstmt.fetchStep() &&
+                probe.dbstmt.fetchNull(this->manager.s_read_column_begin_index);
+        }
+        probe.finalize();
+        return ok;
+    } // columnIsNull
+
+    /**
+     * @brief check if the pointer member of the object is nullptr,
+     *     the pointer member is nullptr if and only if the column is NULL, so no probe is needed.
+     * @param obj The object.
+     * @param idx The member index defined in TABLE4CLASS.
+     * @param is_null true if the member is nullptr; otherwise, false.
+     * @return true if the member is a pointer; otherwise, false.
+     */
+    static bool pointerMemberIsNull(T *obj, int idx, bool &is_null) {
+        bool is_pointer = false;
+        int i = 0;
+        boost::fusion::for_each(TypeMetaData<T>::getVal(obj),
+            [&is_pointer, &is_null, &i, idx](auto const &ne) {
+                using DefType = typename remove_const_and_pointer<std::decay_t<decltype(ne)>>::type;
+                if (i++ == idx) {
+                    is_pointer = TypeInfoTrait<DefType>::is_pointer;
+                    is_null = is_pointer && (TypeInfoTrait<DefType>::getCppPtr2Bind(ne) == nullptr);
+                }
+            }
+        );
+        return is_pointer;
+    } // pointerMemberIsNull
+
+
+
 public:
     /**
      * @brief read the object from the database.
@@ -122,7 +446,7 @@ public:
      * @return true if read successfully; otherwise, false.
      */
     bool read(T *obj) {
-        if (!manager.isConnected()) {
+        if (!this->manager.isConnected()) {
             std::cerr << "DbMap<" << typeid(T).name() << ">::Reader::"
                       << "read: not inited" << std::endl;
             return false;
@@ -131,10 +455,18 @@ public:
         return readObject(obj);
     } // read
 
+    /**
+     * @brief check if the last read returned false for a row not fetched instead of no more row,
+     *     such as the blob of a vector or array member not matching the member size.
+     */
+    bool fetchFailed() const {
+        return fetch_failed;
+    }
+
 protected:
     /** reset read_idx to begin to read */
     void resetReadIndex() {
-        read_idx = manager.s_read_column_begin_index;
+        read_idx = this->manager.s_read_column_begin_index;
     }
 
     /**
@@ -147,31 +479,76 @@ protected:
 
         // 1. reset read index to read  
         this->resetReadIndex();
+        fetch_failed = false;
 
         // 2. fetch the tuple using prepared statement
+        OpStatsTimer timer(this->stats, OpPhase::FETCH);
         if (!this->dbstmt.fetchStep()) {
-            return false; // no more row
+            return false; // no more row, not recorded
         }
 
-        // 3. iterate to fetch the columns and read to members
+        // 3. fetch the members and the primary key members from the row
+        ok = fetchRow(this->dbstmt, read_idx, obj);
+        timer.stop(ok, ok ? 1 : 0);
+        if (!ok) {
+            std::cerr << "DbMap::Reader::read: fetch the row failed" << std::endl;
+            setLastError(DbErrorCode::ERROR, 0, "DbMap::Reader::read: fetch the row of " +
+                this->dbmap.getTableName() + " failed");
+            fetch_failed = true;
+            return false;
+        }
+
+
+        // 4. CompositeVector type: use this obj as primary key tuple to read the child
+        // constexpr to avoid compile time error
+        if constexpr (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector) {
+            std::size_t vidx = 0;
+            auto ve = VecMetaData<T>::getVecElem(obj);
+            boost::fusion::for_each(
+                ve,
+                [&](auto ptr) {
+                    // fetch the child vector when ok
+                    ok = ok && fetchChildVector(obj, vidx, ptr);
+                } // lambda function
+            ); // for_each
+        } // if 
+
+        return ok;
+    } // readObject
+
+
+public:
+    /**
+     * @brief fetch the members of the object from the current row of the source.
+     * @tparam Source The row source providing fetchNull/fetchColumn, such as DbStatement.
+     * @param src The row source positioned at the row.
+     * @param idx The column index to begin, updated to the next column after the object.
+     * @param obj The object to fill.
+     * @return true if fetched; otherwise, false.
+     */
+    template <typename Source>
+    static bool fetchRow(Source &src, uint32_t &idx, T *obj) {
+        bool ok = true;
+
+        // 1. iterate to fetch the columns and read to members
         // @see DbMap<T>::Writer::fetchFromColumn for the recursive calling
         auto values = TypeMetaData<T>::getVal(obj);
         boost::fusion::for_each(
             values,
-            [this, &ok](auto const &ne) {
-                int got = this->fetchFromColumn(ne);
-                ok = got < 0 ? got : ok + got;
+            [&src, &idx, &ok](auto const &ne) {
+                int got = fetchFromColumn(src, idx, ne);
+                ok = ok && (got >= 0);
             }
         );
         if (!ok) { return false; } // fetch failed
              
 
-        // 4. read the primary key value from the object
+        // 2. read the primary key value from the object
         auto pk_values = TypeMetaData<T>::getPkVal(obj);
         if (!boost::fusion::empty(pk_values)) {
             boost::fusion::for_each(
                 pk_values,
-                [this, &ok](auto const &pk_elem) {
+                [&src, &idx, &ok](auto const &pk_elem) {
                     using PkMemElemType = typename std::remove_reference_t<decltype(pk_elem)>;
                     using PkMemDefType = typename remove_const_and_pointer<PkMemElemType>::type;
                     using PkMemCppType = typename TypeInfoTrait<PkMemDefType>::CppType;
@@ -186,40 +563,28 @@ protected:
                         using PkValCppType = typename TypeInfoTrait<PkValDefType>::CppType;
                         PkValCppType *pk_val_pk = TypeInfoTrait<PkValDefType>::getCppPtr2Fetch(pk_val_pk_ptr);
 
-                        int got = this->fetchFromColumn(pk_val_pk);
-                        ok = got < 0 ? got : ok + got;
+                        int got = fetchFromColumn(src, idx, pk_val_pk);
+                        ok = ok && (got >= 0);
                     } // if
                 } // lambda function
             ); // for_each
         } // if
-        if (!ok) { return false; } // fetch failed
-
-
-        // 5. CompositeVector type: use this obj as primary key tuple to read the child
-        // constexpr to avoid compile time error
-        if constexpr (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector) {
-            std::size_t vidx = 0;
-            auto ve = VecMetaData<T>::getVecElem(obj);
-            boost::fusion::for_each(
-                ve,
-                [&](auto ptr) {
-                    // fetch the child vector when ok
-                    ok = ok && fetchChildVector(obj, vidx, ptr);
-                } // lambda function
-            ); // for_each
-        } // if 
 
         return ok;
-    } // readObject
+    } // fetchRow
 
 
+protected:
     /**
      * @brief read the element from the database.
+     * @param src The row source to fetch the column.
+     * @param idx The column index to fetch, moved to the next column.
      * @param elem The element pointer to read, which is defined as a cpp type pointer.
-     * @return true if the fetched value is not null; otherwise, false.
+     * @return 1 if the fetched value is not null; 0 if null;
+     *         -1 if fetch failed, such as the blob size not matching the member, the member is cleared.
      */
-    template <typename ElemType>
-    bool fetchFromColumn(ElemType &elem) {
+    template <typename Source, typename ElemType>
+    static int fetchFromColumn(Source &src, uint32_t &idx, ElemType &elem) {
         using DefType = typename remove_const_and_pointer<ElemType>::type;
         using TypeTrait = TypeInfoTrait<DefType>;
         using CppType = typename TypeTrait::CppType;
@@ -227,28 +592,33 @@ protected:
         // use this template variable to fetch the value from the database
         CppType *cpp_val_ptr = TypeTrait::getCppPtr2Fetch(elem);
         bool not_null = false;
+        bool fetched = true;
 
         if constexpr (TypeInfoTrait<DefType>::sqlType == SqlType::Composite) {
-            assert((read_idx > 0) &&
+            assert((idx > 0) &&
                    "DbMap<T>::Reader::fetchFromColumn: composite type should not be the first element");
 
             // @see DbMap<T>::Writer::fetchFromColumn for the recursive calling
             auto values = TypeMetaData<CppType>::getVal(cpp_val_ptr);
             boost::fusion::for_each(values,
-                [this, &not_null](auto const &ne) {
-                    not_null |= this->fetchFromColumn(ne);
+                [&src, &idx, &not_null, &fetched](auto const &ne) {
+                    int got = fetchFromColumn(src, idx, ne);
+                    fetched = fetched && (got >= 0);
+                    not_null |= (got > 0);
                 }
             ); // for_each
         }
         else if constexpr (TypeInfoTrait<DefType>::sqlType == SqlType::CompositeVector) {
-            assert((read_idx > 0) &&
+            assert((idx > 0) &&
                    "DbMap<T>::Reader::fetchFromColumn: composite type should not be the first element");
 
             // fetch the composite members from this table 
             auto values = TypeMetaData<CppType>::getVal(cpp_val_ptr);
             boost::fusion::for_each(values,
-                [this, &not_null](auto const &ne) {
-                    not_null |= this->fetchFromColumn(ne);
+                [&src, &idx, &not_null, &fetched](auto const &ne) {
+                    int got = fetchFromColumn(src, idx, ne);
+                    fetched = fetched && (got >= 0);
+                    not_null |= (got > 0);
                 }
             ); // for_each
 
@@ -264,15 +634,17 @@ protected:
 //            ); // for_each
         }
         else if constexpr (TypeInfoTrait<DefType>::sqlType == SqlType::External) {
-            assert((read_idx > 0) &&
+            assert((idx > 0) &&
                    "DbMap<T>::Reader::fetchFromColumn: external type should not be the first element");
 
             Shadow<CppType> shadow;
             auto values = TypeMetaData<Shadow<CppType>>::getVal(&shadow);
             boost::fusion::for_each(
                 values,
-                [this, &not_null](auto const &ne) {
-                    not_null |= this->fetchFromColumn(ne);
+                [&src, &idx, &not_null, &fetched](auto const &ne) {
+                    int got = fetchFromColumn(src, idx, ne);
+                    fetched = fetched && (got >= 0);
+                    not_null |= (got > 0);
                 }
             ); // for_each
 
@@ -280,24 +652,29 @@ protected:
             shadow.fromShadow(cpp_val_ptr);
         }
         else if constexpr (std::is_enum_v<CppType>) {
-            not_null = (!this->dbstmt.fetchNull(read_idx));
+            not_null = (!src.fetchNull(idx));
             if (not_null) {
                 using U = std::underlying_type_t<CppType>; // underlying type of enum
                 U tmp{};
-                this->dbstmt.fetchColumn(read_idx, &tmp);
+                fetched = src.fetchColumn(idx, &tmp);
                 *cpp_val_ptr = static_cast<CppType>(tmp);
             }
-            ++read_idx;
+            ++idx;
         }
         else {
             // if is nullptr, we need to bind the column to nullptr
-            not_null = (!this->dbstmt.fetchNull(read_idx));
+            not_null = (!src.fetchNull(idx));
             if (not_null) {
                 // read the element from the database
                 // only base type needs to be read
-                this->dbstmt.fetchColumn(read_idx, cpp_val_ptr);
+                fetched = src.fetchColumn(idx, cpp_val_ptr);
             }
-            ++read_idx; 
+            ++idx; 
+        }
+
+        // clear the member not fetched instead of keeping the value of the reused object
+        if (!fetched) {
+            not_null = false;
         }
 
         if constexpr (TypeInfoTrait<DefType>::is_pointer) {
@@ -315,7 +692,7 @@ protected:
                 *cpp_val_ptr = CppType();
         }
 
-        return not_null; 
+        return fetched ? not_null : -1;
     } // fetchFromColumn
 
 
@@ -338,7 +715,7 @@ protected:
         assert(child_dbmap != nullptr);
 
         // create reader to read the child object
-        typename DbMap<VecCppType>::Reader child_reader(*child_dbmap);
+        typename DbMap<VecCppType>::Reader child_reader(*child_dbmap, this->conn);
         if (!child_reader.prepareByForeignKey(obj)) {
             std::cerr << "DbMap::Reader::fetchChildVector: prepareByForeignKey failed" << std::endl;
             return false;
@@ -352,8 +729,17 @@ protected:
             else
                 // ptr point to vector<ElemT>
                 vec_ptr->push_back(child_obj); 
+
+            // reset the child vectors of child_obj before reading the next one
+            child_obj = VecCppType();
         } // while
 
+        if (child_reader.fetchFailed()) {
+            std::cerr << "DbMap::Reader::fetchChildVector: read the child failed" << std::endl;
+            child_reader.finalize();
+            return false;
+        }
+
         if (!child_reader.finalize()) {
             std::cerr << "DbMap::Reader::fetchChildVector: finalize failed" << std::endl;
             return false;
@@ -0,0 +1,200 @@
+/**
+ * @file DbMapSchema.h
+ * @brief DbMapSchema.h creates the tables of DbMap and evolves the existing tables
+ *     to the columns generated from TypeMetaData, without exporting and importing the data.
+ * @note This file is part of the edadb project, which provides a way to map objects to relations in the database.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "DbMap.h"
+#include "SchemaDiff.h"
+
+
+namespace edadb {
+
+
+template <typename T>
+bool DbMap<T>::createSchema() {
+    if (!init()) {
+        std::cerr << "DbMap::createSchema: init failed" << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> tables, ddl;
+    appendSchema(tables, ddl);
+    const std::string fp = schemaFingerprint(ddl);
+
+    // unchanged schema: skip the statements if all the tables exist
+    std::string stored;
+    if (manager.readSchemaFingerprint(getTableName(), stored) && (stored == fp)) {
+        bool exists = true;
+        for (const auto &t : tables) {
+            exists = exists && manager.tableExists(t);
+        }
+        if (exists) return true;
+    }
+
+    std::vector<SchemaDiff> diffs;
+    if (!evolveSchema(diffs, true)) {
+        std::cerr << "DbMap::createSchema: evolve schema failed" << std::endl;
+        return false;
+    }
+    return manager.writeSchemaFingerprint(getTableName(), fp);
+} // createSchema
+
+
+/**
+ * @brief The name of the blob layout of the column kept in the schema metadata table,
+ *     the declared type is BLOB for all the layouts.
+ */
+inline std::string blobLayoutKey(const std::string &tab, const std::string &col) {
+    return "layout:" + tab + "." + col;
+}
+
+
+template <typename T>
+void DbMap<T>::appendSchema(std::vector<std::string> &tables, std::vector<std::string> &ddl) {
+    tables.push_back(getTableName());
+    ddl.push_back(SqlStatement<T>::createTableStatement(this_fkc, work_fkc));
+    for (auto &idx : indexStatements()) {
+        ddl.push_back(std::move(idx));
+    }
+
+    // the blob layout changes the fingerprint, such as std::array<double, 2> to 3
+    std::vector<std::string> names, types, layouts;
+    SqlStatement<T>::collectTableColumns(names, types, this_fkc, work_fkc, &layouts);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (!layouts[i].empty()) {
+            ddl.push_back(blobLayoutKey(getTableName(), names[i]) + " " + layouts[i]);
+        }
+    }
+
+    for (auto &child : child_dbmap_vec) {
+        child->appendSchema(tables, ddl);
+    }
+} // appendSchema
+
+
+template <typename T>
+bool DbMap<T>::evolveSchema(std::vector<SchemaDiff> &out, bool apply) {
+    if (!manager.isConnected()) {
+        std::cerr << "DbMap::evolveSchema: not inited" << std::endl;
+        return false;
+    }
+
+    const std::string &tab = getTableName();
+    std::vector<std::string> names, types, layouts;
+    SqlStatement<T>::collectTableColumns(names, types, this_fkc, work_fkc, &layouts);
+
+    SchemaDiff d;
+    d.table = tab;
+    std::vector<std::string> disk_names, disk_types;
+    if (!manager.tableExists(tab) || !manager.tableColumns(tab, disk_names, disk_types)) {
+        d.created = true;
+    }
+    else {
+        auto find = [](const std::vector<std::string> &v, const std::string &n) {
+            return static_cast<size_t>(std::find(v.begin(), v.end(), n) - v.begin());
+        };
+
+        // the blob of another layout cannot be decoded, it is not copied by the rebuild
+        auto sameLayout = [&](size_t i) {
+            std::string stored;
+            return layouts[i].empty() ||
+                !manager.readSchemaFingerprint(blobLayoutKey(tab, names[i]), stored) ||
+                (stored == layouts[i]);
+        };
+
+        std::vector<std::string> common;
+        for (size_t i = 0; i < names.size(); ++i) {
+            const size_t k = find(disk_names, names[i]);
+            if (k == disk_names.size()) {
+                d.added.push_back(names[i]);
+            }
+            else if (!sameLayout(i)) {
+                d.retyped.push_back(names[i]);
+            }
+            else {
+                common.push_back(names[i]);
+                if (!SqlStatement<T>::sameColumnType(disk_types[k], types[i])) {
+                    d.retyped.push_back(names[i]);
+                }
+            }
+        }
+        for (const auto &n : disk_names) {
+            if (find(names, n) == names.size()) {
+                d.removed.push_back(n);
+            }
+        }
+
+        // the primary key and the foreign key constraint cannot be added by ALTER TABLE
+        const bool key_added =
+            (Cpp2SqlTypeTrait<T>::hasPrimKey && (find(d.added, names.front()) < d.added.size())) ||
+            (this_fkc.valid() && (find(d.added, this_fkc.fore_col_name) < d.added.size()));
+        d.rebuild = !d.retyped.empty() || key_added;
+
+        if (apply && d.rebuild) {
+            // create the new table by the temporary name, the foreign key still refers to the parent
+            const std::string tmp = tab + "__edadb_rebuild";
+            ForeignKeyConstraint tmp_this(this_fkc), tmp_work(work_fkc);
+            tmp_this.fore_tab_name = tmp;
+            tmp_work.prim_tab_name = tmp;
+
+            // the retyped columns are converted by the column affinity of the new table
+            const std::string create_sql = SqlStatement<T>::createTableStatement(tmp_this, tmp_work);
+            if (!manager.rebuildTable(tab, tmp, create_sql, common)) {
+                std::cerr << "DbMap::evolveSchema: rebuild table " << tab << " failed" << std::endl;
+                return false;
+            }
+        }
+        else if (apply) {
+            for (size_t i = 0; i < names.size(); ++i) {
+                if ((find(d.added, names[i]) < d.added.size()) &&
+                    !manager.exec(SqlStatement<T>::addColumnStatement(tab, names[i], types[i]))) {
+                    std::cerr << "DbMap::evolveSchema: add column " << names[i]
+                        << " to " << tab << " failed" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (apply) {
+        if (d.created && !manager.exec(SqlStatement<T>::createTableStatement(this_fkc, work_fkc))) {
+            std::cerr << "DbMap::evolveSchema: create table " << tab << " failed" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (!layouts[i].empty() &&
+                !manager.writeSchemaFingerprint(blobLayoutKey(tab, names[i]), layouts[i])) {
+                std::cerr << "DbMap::evolveSchema: store the blob layout of " << names[i]
+                    << " failed" << std::endl;
+                return false;
+            }
+        }
+        for (const auto &idx : indexStatements()) {
+            if (!manager.exec(idx)) {
+                std::cerr << "DbMap::evolveSchema: create index on " << tab << " failed" << std::endl;
+                return false;
+            }
+        }
+    }
+    if (d.changed()) {
+        out.push_back(std::move(d));
+    }
+
+    bool ok = true;
+    for (auto &child : child_dbmap_vec) {
+        ok = ok && child->evolveSchema(out, apply);
+    }
+    return ok;
+} // evolveSchema
+
+
+} // namespace edadb
@@ -0,0 +1,228 @@
+/**
+ * @file DbMapSnapshot.h
+ * @brief DbMapSnapshot.h dumps the DbMap tables to the snapshot file and materializes the objects from it.
+ * @note This file is part of the edadb project, which provides a way to map objects to relations in the database.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "DbMap.h"
+#include "DbMapOperation.h"
+#include "DbMapDbStmtOp.h"
+#include "DbMapReader.h"
+#include "Snapshot.h"
+
+
+namespace edadb {
+
+
+// DbMap SnapshotDumper: dump all the rows of the table to the snapshot writer
+template <typename T>
+class DbMap<T>::SnapshotDumper : public DbStmtOp {
+public:
+    ~SnapshotDumper() = default;
+    SnapshotDumper(DbMap &m) : DbStmtOp(m) {}
+
+public:
+    /**
+     * @brief dump the table to the snapshot writer,
+     *     the rows of the child table are grouped by the foreign key.
+     * @param w The snapshot writer.
+     * @return true if success; otherwise, false.
+     */
+    bool dump(SnapshotWriter &w) {
+        if (!this->template prepareImpl<DbMapOperation::SCAN_SNAPSHOT>()) {
+            return false;
+        }
+
+        std::vector<std::string> names;
+        std::vector<SnapshotColumnKind> kinds;
+        const int n = this->dbstmt.getColumnCount();
+        for (int i = 0; i < n; ++i) {
+            names.push_back(this->dbstmt.getColumnName(i));
+            kinds.push_back(snapshotColumnKind(this->dbstmt.getColumnDeclType(i)));
+        }
+
+        // the foreign key column is the last column of the projection
+        DbMap<T> &m = this->dbmap;
+        const int32_t fk_col = m.getThisForeignKey().valid() ? n - 1 : -1;
+        const std::string schema = SqlStatement<T>::projectAllStatement(
+            m.getThisForeignKey(), m.getWorkForeignKey());
+
+        bool ok = w.beginTable(m.getTableName(), schema, fk_col, names, kinds);
+        while (ok && this->dbstmt.fetchStep()) {
+            w.beginRow();
+            for (int i = 0; i < n; ++i) {
+                const int idx = this->manager.s_read_column_begin_index + i;
+                if (this->dbstmt.fetchNull(idx)) {
+                    w.appendNull(i);
+                    continue;
+                }
+
+                switch (kinds[i]) {
+                case SnapshotColumnKind::INT64: {
+                    int64_t v = 0;
+                    this->dbstmt.fetchColumn(idx, &v);
+                    w.appendInt(i, v);
+                    break;
+                }
+                case SnapshotColumnKind::DOUBLE: {
+                    double v = 0;
+                    this->dbstmt.fetchColumn(idx, &v);
+                    w.appendDouble(i, v);
+                    break;
+                }
+                case SnapshotColumnKind::TEXT: {
+                    const char *p = nullptr; size_t bytes = 0;
+                    this->dbstmt.fetchText(idx, &p, &bytes);
+                    w.appendBytes(i, p, bytes);
+                    break;
+                }
+                case SnapshotColumnKind::BLOB: {
+                    const void *p = nullptr; size_t bytes = 0;
+                    this->dbstmt.fetchBlob(idx, &p, &bytes);
+                    w.appendBytes(i, p, bytes);
+                    break;
+                }
+                } // switch
+            } // for
+            w.endRow();
+        } // while
+
+        ok = ok && w.endTable();
+        return this->finalize() && ok;
+    } // dump
+}; // DbMap::SnapshotDumper
+
+
+
+template <typename T>
+bool DbMap<T>::writeSnapshot(SnapshotWriter &w) {
+    if (!manager.isConnected()) {
+        std::cerr << "DbMap::writeSnapshot: not inited" << std::endl;
+        return false;
+    }
+
+    SnapshotDumper dumper(*this);
+    bool ok = dumper.dump(w);
+    for (auto &child : child_dbmap_vec) {
+        ok = ok && child->writeSnapshot(w);
+    }
+    return ok;
+} // writeSnapshot
+
+
+template <typename T>
+int64_t DbMap<T>::readSnapshot(const Snapshot &snap, std::vector<T*> &objs) {
+    if (!checkSnapshot(snap)) {
+        return -1;
+    }
+
+    const SnapshotTable *tab = snap.table(getTableName());
+    const size_t before = objs.size();
+    bool ok = readSnapshotRows(snap, *tab, 0, tab->rows,
+        [&objs](T &obj) { objs.push_back(new T(std::move(obj))); }
+    );
+    return ok ? static_cast<int64_t>(objs.size() - before) : -1;
+} // readSnapshot
+
+
+template <typename T>
+bool DbMap<T>::checkSnapshot(const Snapshot &snap) {
+    const SnapshotTable *tab = snap.table(getTableName());
+    if (tab == nullptr) {
+        std::cerr << "DbMap::checkSnapshot: table " << getTableName()
+            << " not in snapshot" << std::endl;
+        return false;
+    }
+
+    const std::string schema = SqlStatement<T>::projectAllStatement(this_fkc, work_fkc);
+    if (tab->schema != schema) {
+        std::cerr << "DbMap::checkSnapshot: schema of " << tab->name
+            << " mismatch, snapshot: " << tab->schema << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    if constexpr (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector) {
+        if (child_dbmap_vec.empty() && !init()) {
+            std::cerr << "DbMap::checkSnapshot: init child DbMap failed" << std::endl;
+            return false;
+        }
+
+        std::size_t vidx = 0;
+        auto seq = VecMetaData<T>::tuple_type_pair();
+        boost::fusion::for_each(seq, [&](auto elem) {
+            using ChildVecType = typename remove_const_and_pointer<
+                typename decltype(elem)::first_type>::type;
+            using VecCppType = typename TypeInfoTrait<ChildVecType>::VecCppType;
+
+            auto *child = static_cast<DbMap<VecCppType> *>(child_dbmap_vec.at(vidx++));
+            ok = ok && child->checkSnapshot(snap);
+        }); // for_each
+    } // if
+
+    return ok;
+} // checkSnapshot
+
+
+template <typename T>
+template <typename Emit>
+bool DbMap<T>::readSnapshotRows(const Snapshot &snap, const SnapshotTable &tab,
+        size_t begin, size_t end, Emit emit) {
+    SnapshotCursor cursor(tab);
+    for (size_t r = begin; r < end; ++r) {
+        cursor.seek(r);
+
+        T obj{};
+        uint32_t idx = DbManager::s_read_column_begin_index;
+        if (!Reader::fetchRow(cursor, idx, &obj)) {
+            return false;
+        }
+
+        // CompositeVector type: read the child rows grouped by the primary key of obj
+        // @see DbMap<T>::Reader::fetchChildVector
+        bool ok = true;
+        if constexpr (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector) {
+            const PkType *pk = getPrimaryKey(&obj);
+            std::size_t vidx = 0;
+            auto ve = VecMetaData<T>::getVecElem(&obj);
+            boost::fusion::for_each(ve, [&](auto ptr) {
+                using DefType = typename remove_const_and_pointer<decltype(ptr)>::type;
+                using TypeTrait = TypeInfoTrait<DefType>;
+                using VecCppType = typename TypeTrait::VecCppType;
+
+                auto *vec_ptr = TypeTrait::getCppPtr2Bind(ptr);
+                auto *child = static_cast<DbMap<VecCppType> *>(child_dbmap_vec.at(vidx++));
+                if (!ok || (pk == nullptr)) return;
+
+                // checked by checkSnapshot
+                const SnapshotTable *child_tab = snap.table(child->getTableName());
+                assert(child_tab != nullptr);
+
+                auto range = child_tab->findForeignKeyRows(*pk);
+                ok = child->readSnapshotRows(snap, *child_tab, range.first, range.second,
+                    [vec_ptr](VecCppType &elem) {
+                        if constexpr (TypeTrait::elemIsPointer)
+                            vec_ptr->push_back(new VecCppType(std::move(elem)));
+                        else
+                            vec_ptr->push_back(std::move(elem));
+                    }
+                );
+            }); // for_each
+        } // if
+        if (!ok) { return false; }
+
+        emit(obj);
+    } // for
+
+    return true;
+} // readSnapshotRows
+
+
+} // namespace edadb
@@ -8,6 +8,11 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
 
 #include "DbMap.h"
 #include "DbMapOperation.h"
@@ -61,6 +66,138 @@ public:
         });
     } // insertVector
 
+    /**
+     * @brief insert the objects by the pipeline: the worker threads encode the chunks of objects
+     *     into rows in parallel, the calling thread binds the rows and steps in the input order,
+     *     so the flattening and the conversions, such as Shadow::toShadow, overlap the steps.
+     *     At most 2 chunks per worker are encoded ahead of the steps to bound the memory.
+     * @param objs The objects to insert, not modified until returned.
+     * @param num_threads The number of the encoding threads, 0 for hardware concurrency - 1.
+     * @param p The parent object, if any, to bind the foreign key value.
+     * @return true if success; otherwise, false.
+     */
+    template <typename ParentType = void>
+    bool insertVectorPipelined(std::vector<T *> &objs, size_t num_threads = 0, ParentType *p = nullptr) {
+        // the rowid keys assigned by the encoding threads would not follow the input order
+        if ((objs.size() < Config::insert_pipeline_min_rows) ||
+                (RowidKeyTrait<T>::value && !DbManager::s_assign_rowid_key)) {
+            return insertVector(objs, p);
+        }
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+        }
+
+        struct Chunk {
+            std::vector<EncodedRow> rows;
+            std::vector<int>        got;   // encodeObject result per object
+            bool                    ready = false;
+        };
+        const size_t chunk_rows = Config::insert_pipeline_chunk_rows;
+        const size_t num_chunks = (objs.size() + chunk_rows - 1) / chunk_rows;
+        const size_t window = num_threads * 2;
+        std::vector<Chunk> chunks(num_chunks);
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t next = 0;      // the next chunk to encode
+        size_t consumed = 0;  // the chunks stepped
+        bool stop = false;
+
+        auto encode = [&]() {
+            Writer encoder(this->dbmap);
+            while (true) {
+                size_t c = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [&] { return stop || (next >= num_chunks) || (next < consumed + window); });
+                    if (stop || (next >= num_chunks)) return;
+                    c = next++;
+                }
+
+                Chunk &chunk = chunks[c];
+                const size_t b = c * chunk_rows;
+                const size_t e = std::min(b + chunk_rows, objs.size());
+                chunk.rows.resize(e - b);
+                chunk.got.resize(e - b);
+                for (size_t i = b; i < e; ++i) {
+                    chunk.got[i - b] = encoder.encodeObject(objs[i], chunk.rows[i - b], p);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    chunk.ready = true;
+                }
+                cv.notify_all();
+            }
+        }; // encode
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back(encode);
+        }
+
+        bool ok = this->template prepareImpl<DbMapOperation::INSERT>();
+        if (!ok) {
+            std::cerr << "DbMap::insertVectorPipelined: prepare failed" << std::endl;
+        }
+        for (size_t c = 0; ok && (c < num_chunks); ++c) {
+            Chunk &chunk = chunks[c];
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&] { return chunk.ready; });
+            }
+
+            const size_t b = c * chunk_rows;
+            for (size_t i = 0; ok && (i < chunk.rows.size()); ++i) {
+                // all members nullptr: skipped as insertVector
+                if (chunk.got[i] == 0) continue;
+                ok = (chunk.got[i] > 0) && insertEncoded(objs[b + i], chunk.rows[i]);
+                if (!ok) {
+                    std::cerr << "DbMap::insertVectorPipelined: insert failed" << std::endl;
+                }
+            }
+            std::vector<EncodedRow>().swap(chunk.rows);
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                consumed = c + 1;
+            }
+            cv.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto &t : workers) {
+            t.join();
+        }
+
+        return ok && this->finalize();
+    } // insertVectorPipelined
+
+private:
+    /**
+     * @brief insert the row encoded from the object, then the child vectors of the object.
+     */
+    bool insertEncoded(T *obj, const EncodedRow &row) {
+        return this->template executeImpl<DbMapOperation::INSERT>(
+            [&]() {
+                this->resetBindIndex();
+                if (!row.bindTo(this->dbstmt, this->bind_idx) || !this->dbstmt.bindStep()) {
+                    return -1;
+                }
+                // the rowid key left 0 is encoded as NULL
+                if (this->rowidKeyUnset(obj)) {
+                    this->writeBackRowidKey(obj);
+                }
+                this->bindChildren(obj);
+                return 1;
+            }
+        );
+    } // insertEncoded
+
 private:
     /**
      * @brief process the vector of objects.
@@ -90,7 +227,8 @@ public: // delete API: using place holder delete statement
     bool deleteOne(T *obj) {
         return this->template prepareImpl<DbMapOperation::DELETE>()
             && this->deleteOp(obj)
-            && this->template finalize();
+            && this->template finalize()
+            && deleteChildRows();
     }
 
     bool deleteVector(std::vector<T *> &objs) {
@@ -107,10 +245,22 @@ public: // delete API: using place holder delete statement
                 }
             }
             return true; 
-        });
+        }) && deleteChildRows();
     } // deleteVector
 
 private:
+    /**
+     * @brief delete the child rows of the deleted objects,
+     *     only if the backend has no ON DELETE CASCADE.
+     */
+    bool deleteChildRows() {
+        if constexpr (!SqlStatement<T>::cascade_foreign_key &&
+                (TypeInfoTrait<T>::sqlType == SqlType::CompositeVector)) {
+            return this->dbmap.deleteOrphanRows();
+        }
+        return true;
+    } // deleteChildRows
+
     int deleteOp(T *obj) {
         return this->template executeImpl<DbMapOperation::DELETE>(
             [&]() {
@@ -123,11 +273,13 @@ private:
                 CppType *pk_val_ptr = TypeTrait::getCppPtr2Bind(pk_def_ptr);
                 // primary key value pointer should not be null
                 // if it is null, then the object is not valid for delete 
-                if (pk_val_ptr == nullptr) { return 0; }  
+                if (pk_val_ptr == nullptr) { return 0; }
 
+                // the statement is reused by deleteVector, bind from the first place holder
+                this->resetBindIndex();
                 this->dbstmt.bindColumn(this->bind_idx++, pk_val_ptr);
 
-                return this->dbstmt.bindStep() ? 
+                return this->dbstmt.bindStep() ?
                     1 : -1; // return 1 if bind step success, otherwise -1
             } // lambda function
         ); // executeImpl
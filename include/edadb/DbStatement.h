@@ -26,9 +26,9 @@ struct DbStatementImpl {
 
 
 /**
- * DbStatement is defined in backend, such as backend/DbBackendType/DbStatement4Sqlite.h:
- *   using DbStatement = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE,
- *         DbStatementImpl<DbBackendType::SQLITE>>;
+ * DbStatement of Config::backend_type,
+ * DbStatementImpl is specialized in backend, such as backend/sqlite/DbStatement4Sqlite.h
  */
+using DbStatement = DbStatementImpl<Config::backend_type>;
 
 } // namespace edadb
\ No newline at end of file
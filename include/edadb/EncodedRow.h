@@ -0,0 +1,214 @@
+/**
+ * @file EncodedRow.h
+ * @brief EncodedRow.h provides the row of the column values flattened from an object,
+ *     encoded by the worker threads and bound by the writer thread, see DbMap::Writer::insertVectorPipelined.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <array>
+#include <type_traits>
+
+#include "TraitUtils.h"
+#include "BlobLayout.h"
+
+
+namespace edadb {
+
+/**
+ * @class EncodedRow
+ * @brief The values recorded by the same bindColumn/bindNull calls as the DbStatement,
+ *     so the flattening of DbMap::DbStmtOp::bindObject runs without a statement.
+ *     The text and the blob are copied, the row does not refer to the object,
+ *     such as the Shadow of the external type destroyed after the bind.
+ */
+class EncodedRow {
+public:
+    enum class Kind : uint8_t {
+        NUL = 0,
+        BOOL,
+        INT32,
+        INT64,
+        DOUBLE,
+        TEXT,    // bytes[i]
+        TEXT16,  // bytes[i] of wchar_t terminated by L'\0'
+        BLOB     // bytes[i] in BlobLayout
+    };
+
+private:
+    struct Value {
+        Kind kind = Kind::NUL;
+        union {
+            int64_t i;
+            double  d;
+        };
+        uint32_t bytes_idx = 0;
+
+        Value() : i(0) {}
+    };
+
+    std::vector<Value>       values;
+    std::vector<std::string> bytes;
+
+public:
+    void clear() {
+        values.clear();
+        bytes.clear();
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+
+public: // record, the index is the place holder of the statement, values are appended in order
+    bool bindNull(int) {
+        values.emplace_back();
+        return true;
+    }
+
+    bool bindColumn(int, bool *value) {
+        return addInt(Kind::BOOL, *value);
+    }
+
+    template <typename V>
+    std::enable_if_t<std::is_integral_v<V> && (sizeof(V) <= sizeof(int)), bool>
+        bindColumn(int, V *value) {
+        return addInt(Kind::INT32, static_cast<int32_t>(*value));
+    }
+
+    template <typename V>
+    std::enable_if_t<std::is_integral_v<V> && (sizeof(V) > sizeof(int)), bool>
+        bindColumn(int, V *value) {
+        return addInt(Kind::INT64, static_cast<int64_t>(*value));
+    }
+
+    template <typename V>
+    std::enable_if_t<std::is_floating_point_v<V>, bool>
+        bindColumn(int, V *value) {
+        Value v;
+        v.kind = Kind::DOUBLE;
+        v.d = static_cast<double>(*value);
+        values.push_back(v);
+        return true;
+    }
+
+    bool bindColumn(int, std::string *value) {
+        return addBytes(Kind::TEXT, std::string(*value));
+    }
+
+    bool bindColumn(int, const char *value) {
+        return addBytes(Kind::TEXT, std::string(value));
+    }
+
+    bool bindColumn(int i, std::wstring *value) {
+        return bindColumn(i, value->c_str());
+    }
+
+    bool bindColumn(int, const wchar_t *value) {
+        const std::wstring w(value);
+        return addBytes(Kind::TEXT16,
+            std::string(reinterpret_cast<const char *>(w.c_str()), (w.size() + 1) * sizeof(wchar_t)));
+    }
+
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        bindColumn(int, std::vector<E, Alloc> *value) {
+        return addBlob(value->data(), value->size());
+    }
+
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        bindColumn(int, std::array<E, N> *value) {
+        return addBlob(value->data(), N);
+    }
+
+
+public: // replay
+    /**
+     * @brief bind the values recorded to the statement.
+     * @param stmt The statement, such as DbStatement.
+     * @param begin The place holder index of the first value.
+     * @return true if all bound; otherwise, false.
+     */
+    template <typename Stmt>
+    bool bindTo(Stmt &stmt, int begin) const {
+        bool ok = true;
+        for (size_t k = 0; ok && (k < values.size()); ++k) {
+            const Value &v = values[k];
+            const int idx = begin + static_cast<int>(k);
+            switch (v.kind) {
+            case Kind::BOOL: {
+                bool b = (v.i != 0);
+                ok = stmt.bindColumn(idx, &b);
+                break;
+            }
+            case Kind::INT32: {
+                int32_t n = static_cast<int32_t>(v.i);
+                ok = stmt.bindColumn(idx, &n);
+                break;
+            }
+            case Kind::INT64: {
+                int64_t n = v.i;
+                ok = stmt.bindColumn(idx, &n);
+                break;
+            }
+            case Kind::DOUBLE: {
+                double d = v.d;
+                ok = stmt.bindColumn(idx, &d);
+                break;
+            }
+            case Kind::TEXT:
+                // the text is bound without copy, the row must be alive until the step
+                ok = stmt.bindColumn(idx, const_cast<std::string *>(&bytes[v.bytes_idx]));
+                break;
+            case Kind::TEXT16:
+                ok = stmt.bindColumn(idx, reinterpret_cast<const wchar_t *>(bytes[v.bytes_idx].data()));
+                break;
+            case Kind::BLOB: {
+                // encoded by BlobLayout already, bound as bytes
+                const std::string &b = bytes[v.bytes_idx];
+                ok = stmt.bindBlob(idx, reinterpret_cast<const unsigned char *>(b.data()), b.size());
+                break;
+            }
+            default:
+                ok = stmt.bindNull(idx);
+                break;
+            }
+        }
+        return ok;
+    } // bindTo
+
+
+private:
+    bool addInt(Kind kind, int64_t n) {
+        Value v;
+        v.kind = kind;
+        v.i = n;
+        values.push_back(v);
+        return true;
+    }
+
+    bool addBytes(Kind kind, std::string &&b) {
+        Value v;
+        v.kind = kind;
+        v.bytes_idx = static_cast<uint32_t>(bytes.size());
+        bytes.push_back(std::move(b));
+        values.push_back(v);
+        return true;
+    }
+
+    template <typename E>
+    bool addBlob(const E *data, size_t n) {
+        std::string b(n * sizeof(E), '\0');
+        if (n > 0) {
+            BlobLayout::encode(data, n, reinterpret_cast<unsigned char *>(&b[0]));
+        }
+        return addBytes(Kind::BLOB, std::move(b));
+    }
+}; // EncodedRow
+
+} // namespace edadb
@@ -0,0 +1,53 @@
+/**
+ * @file ExternTemplate.h
+ * @brief ExternTemplate.h declares and instantiates the DbMap of the mapped types explicitly,
+ *     so the Boost.Fusion machinery of each type is compiled once instead of in every translation unit.
+ * @details Usage, at the global namespace after TABLE4CLASS:
+ *     1. in the header mapping the types, declare each type including the vector element types:
+ *            TABLE4CLASS(ns::Cell, "cell", (name, loc));
+ *            EDADB_EXTERN_TEMPLATE(ns::Cell);
+ *     2. instantiate each type once, by edadb_add_instantiations() in cmake/EdadbInstantiate.cmake
+ *        or in a source file:
+ *            EDADB_INSTANTIATE_TEMPLATE(ns::Cell);
+ *     The nested classes, such as DbMap<T>::Writer and DbMap<T>::Reader, are covered by DbMap<T>.
+ *     The member templates, such as the vector writers, are still instantiated where they are used.
+ * @note The type must not contain a comma, use an alias for a template type.
+ */
+
+#pragma once
+
+#include "Config.h"
+
+
+/**
+ * The SqlStatementImpl of DuckDB and memory derive from the one of Sqlite3,
+ * so the base is instantiated together.
+ */
+#if (defined(EDADB_BACKEND_DUCKDB) && EDADB_BACKEND_DUCKDB) || \
+    (defined(EDADB_BACKEND_MEMORY) && EDADB_BACKEND_MEMORY)
+#define EDADB_TEMPLATE_SQL_STATEMENT(KEYWORD, T) \
+    KEYWORD struct edadb::SqlStatementImpl<edadb::DbBackendType::SQLITE, T>; \
+    KEYWORD struct edadb::SqlStatementImpl<edadb::Config::backend_type, T>
+#else
+#define EDADB_TEMPLATE_SQL_STATEMENT(KEYWORD, T) \
+    KEYWORD struct edadb::SqlStatementImpl<edadb::Config::backend_type, T>
+#endif
+
+
+/**
+ * @brief Declare the DbMap of the type is instantiated in another translation unit.
+ * @param T The mapped type.
+ */
+#define EDADB_EXTERN_TEMPLATE(T) \
+    extern template class edadb::DbMap<T>; \
+    EDADB_TEMPLATE_SQL_STATEMENT(extern template, T)
+
+
+/**
+ * @brief Instantiate the DbMap of the type, once per program,
+ *     the translation unit must include edadb.h and the header mapping the type.
+ * @param T The mapped type.
+ */
+#define EDADB_INSTANTIATE_TEMPLATE(T) \
+    template class edadb::DbMap<T>; \
+    EDADB_TEMPLATE_SQL_STATEMENT(template, T)
@@ -0,0 +1,351 @@
+/**
+ * @file OpStats.h
+ * @brief OpStats.h records the counters and the latency histograms of the DbMap operations,
+ *     per table and per operation, in the phases of the statement: prepare, execute, fetch and finalize.
+ *     Disabled by default, the disabled check is a relaxed atomic load.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <array>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+
+#include "Singleton.h"
+
+
+namespace edadb {
+
+/**
+ * @enum OpPhase
+ * @brief The phase of the statement:
+ *     PREPARE:  build and prepare the statement,
+ *     EXECUTE:  bind and step the insert/update/delete, once per object,
+ *     FETCH:    step and fetch a row of the query, without the child rows,
+ *     FINALIZE: finalize the statement.
+ */
+enum class OpPhase : uint8_t {
+    PREPARE = 0,
+    EXECUTE,
+    FETCH,
+    FINALIZE,
+    MAX
+}; // OpPhase
+
+inline const char *opPhaseName(OpPhase p) {
+    static const char *names[] = { "prepare", "execute", "fetch", "finalize" };
+    return (p < OpPhase::MAX) ? names[static_cast<size_t>(p)] : "unknown";
+}
+
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style histogram of the latency in nanoseconds:
+ *     the values below 16 have their own buckets,
+ *     each power of two above is split into 16 linear sub-buckets, so the relative error is below 1/16.
+ *     Lock-free, the buckets are relaxed atomic counters.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t s_sub_bits    = 4;
+    static constexpr uint32_t s_sub_buckets = 1u << s_sub_bits;
+    static constexpr uint32_t s_buckets     = s_sub_buckets * (64 - s_sub_bits + 1);
+
+private:
+    std::array<std::atomic<uint64_t>, s_buckets> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+public:
+    void record(uint64_t ns) {
+        buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t m = max.load(std::memory_order_relaxed);
+        while ((ns > m) && !max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (auto &b : buckets) b.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getSum  () const { return sum.load(std::memory_order_relaxed); }
+    uint64_t getMax  () const { return max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief get the percentile, the upper bound of the bucket holding the rank.
+     * @param p The percentile in [0, 100].
+     * @return The latency in nanoseconds; 0 if empty.
+     */
+    uint64_t percentile(double p) const {
+        uint64_t total = 0;
+        std::array<uint64_t, s_buckets> snap;
+        for (uint32_t b = 0; b < s_buckets; ++b) {
+            snap[b] = buckets[b].load(std::memory_order_relaxed);
+            total += snap[b];
+        }
+        if (total == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        rank = (rank < 1) ? 1 : (rank > total ? total : rank);
+
+        uint64_t seen = 0;
+        for (uint32_t b = 0; b < s_buckets; ++b) {
+            seen += snap[b];
+            if (seen >= rank) {
+                const uint64_t upper = upperOf(b);
+                const uint64_t m = getMax();
+                return (upper < m) ? upper : m;
+            }
+        }
+        return getMax();
+    } // percentile
+
+public:
+    static uint32_t bucketOf(uint64_t v) {
+        if (v < s_sub_buckets) {
+            return static_cast<uint32_t>(v);
+        }
+        const uint32_t e = 63 - static_cast<uint32_t>(__builtin_clzll(v)); // e >= s_sub_bits
+        const uint32_t sub = static_cast<uint32_t>(v >> (e - s_sub_bits)) & (s_sub_buckets - 1);
+        return s_sub_buckets * (e - s_sub_bits + 1) + sub;
+    }
+
+    static uint64_t upperOf(uint32_t b) {
+        if (b < s_sub_buckets) {
+            return b;
+        }
+        const uint32_t e   = b / s_sub_buckets + s_sub_bits - 1;
+        const uint64_t sub = b % s_sub_buckets;
+        const uint64_t lo  = (uint64_t(1) << e) + (sub << (e - s_sub_bits));
+        return lo + (uint64_t(1) << (e - s_sub_bits)) - 1;
+    }
+}; // LatencyHistogram
+
+
+/**
+ * @struct OpStatsEntry
+ * @brief The counters and histograms of an operation on a table.
+ */
+struct OpStatsEntry {
+    std::string table;
+    std::string op;
+
+    std::atomic<uint64_t> rows{0};   // objects executed or rows fetched
+    std::atomic<uint64_t> errors{0}; // failed phases
+    std::array<LatencyHistogram, static_cast<size_t>(OpPhase::MAX)> phases;
+
+public:
+    void reset() {
+        rows.store(0, std::memory_order_relaxed);
+        errors.store(0, std::memory_order_relaxed);
+        for (auto &h : phases) h.reset();
+    }
+}; // OpStatsEntry
+
+
+/**
+ * @struct OpStatsSnapshot
+ * @brief The copy of an entry taken by OpStats::snapshot, the latency is in nanoseconds.
+ */
+struct OpStatsSnapshot {
+    struct Phase {
+        uint64_t count = 0;
+        uint64_t sum_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t p50_ns = 0;
+        uint64_t p90_ns = 0;
+        uint64_t p99_ns = 0;
+        uint64_t p999_ns = 0;
+    };
+
+    std::string table;
+    std::string op;
+    uint64_t    rows = 0;
+    uint64_t    errors = 0;
+    std::array<Phase, static_cast<size_t>(OpPhase::MAX)> phases;
+}; // OpStatsSnapshot
+
+
+/**
+ * @class OpStats
+ * @brief The registry of the operation statistics.
+ *     The entries are created on the first use and never removed, so the statements keep the pointer,
+ *     reset clears the counters only.
+ */
+class OpStats : public Singleton<OpStats> {
+private:
+    friend class Singleton<OpStats>;
+
+    inline static std::atomic<bool> s_enabled{false};
+
+    std::mutex mtx;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<OpStatsEntry>> entries;
+
+protected:
+    OpStats() = default;
+    ~OpStats() = default;
+
+public:
+    static void enable(bool on) { s_enabled.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief get the entry of the operation on the table, created if not exists.
+     * @return The entry, valid until the process exits.
+     */
+    OpStatsEntry *entry(const std::string &table, const std::string &op) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto &e = entries[std::make_pair(table, op)];
+        if (!e) {
+            e.reset(new OpStatsEntry);
+            e->table = table;
+            e->op = op;
+        }
+        return e.get();
+    }
+
+    /**
+     * @brief copy the entries with any record.
+     * @return The snapshots ordered by table and operation.
+     */
+    std::vector<OpStatsSnapshot> snapshot() {
+        std::vector<OpStatsSnapshot> out;
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &kv : entries) {
+            const OpStatsEntry &e = *kv.second;
+            OpStatsSnapshot s;
+            s.table  = e.table;
+            s.op     = e.op;
+            s.rows   = e.rows.load(std::memory_order_relaxed);
+            s.errors = e.errors.load(std::memory_order_relaxed);
+
+            bool any = (s.rows > 0) || (s.errors > 0);
+            for (size_t p = 0; p < e.phases.size(); ++p) {
+                const LatencyHistogram &h = e.phases[p];
+                auto &sp   = s.phases[p];
+                sp.count   = h.getCount();
+                sp.sum_ns  = h.getSum();
+                sp.max_ns  = h.getMax();
+                sp.p50_ns  = h.percentile(50);
+                sp.p90_ns  = h.percentile(90);
+                sp.p99_ns  = h.percentile(99);
+                sp.p999_ns = h.percentile(99.9);
+                any = any || (sp.count > 0);
+            }
+            if (any) out.push_back(std::move(s));
+        }
+        return out;
+    } // snapshot
+
+    /**
+     * @brief clear the counters of all entries.
+     */
+    void reset() {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &kv : entries) kv.second->reset();
+    }
+
+    /**
+     * @brief dump the snapshot as a text table, one line per phase.
+     */
+    void dumpText(std::ostream &os) {
+        os << std::left << std::setw(24) << "table" << " " << std::setw(18) << "op"
+           << std::setw(10) << "phase" << std::right << std::setw(10) << "count"
+           << std::setw(12) << "rows" << std::setw(8) << "errors"
+           << std::setw(12) << "avg_us" << std::setw(12) << "p50_us" << std::setw(12) << "p99_us"
+           << std::setw(12) << "max_us" << "\n";
+
+        for (auto &s : snapshot()) {
+            for (size_t p = 0; p < s.phases.size(); ++p) {
+                const auto &sp = s.phases[p];
+                if (sp.count == 0) continue;
+                os << std::left << std::setw(24) << s.table << " " << std::setw(18) << s.op
+                   << std::setw(10) << opPhaseName(static_cast<OpPhase>(p))
+                   << std::right << std::setw(10) << sp.count
+                   << std::setw(12) << s.rows << std::setw(8) << s.errors
+                   << std::fixed << std::setprecision(3)
+                   << std::setw(12) << sp.sum_ns / 1e3 / sp.count
+                   << std::setw(12) << sp.p50_ns / 1e3 << std::setw(12) << sp.p99_ns / 1e3
+                   << std::setw(12) << sp.max_ns / 1e3 << "\n";
+            }
+        }
+        os.unsetf(std::ios::floatfield);
+    } // dumpText
+
+    /**
+     * @brief dump the snapshot as a JSON array, the latency is in nanoseconds.
+     */
+    void dumpJson(std::ostream &os) {
+        os << "[";
+        bool first = true;
+        for (auto &s : snapshot()) {
+            os << (first ? "" : ",") << "{\"table\":\"" << s.table << "\",\"op\":\"" << s.op
+               << "\",\"rows\":" << s.rows << ",\"errors\":" << s.errors << ",\"phases\":{";
+            first = false;
+
+            bool first_phase = true;
+            for (size_t p = 0; p < s.phases.size(); ++p) {
+                const auto &sp = s.phases[p];
+                if (sp.count == 0) continue;
+                os << (first_phase ? "" : ",") << "\"" << opPhaseName(static_cast<OpPhase>(p))
+                   << "\":{\"count\":" << sp.count << ",\"sum_ns\":" << sp.sum_ns
+                   << ",\"max_ns\":" << sp.max_ns << ",\"p50_ns\":" << sp.p50_ns
+                   << ",\"p90_ns\":" << sp.p90_ns << ",\"p99_ns\":" << sp.p99_ns
+                   << ",\"p999_ns\":" << sp.p999_ns << "}";
+                first_phase = false;
+            }
+            os << "}}";
+        }
+        os << "]";
+    } // dumpJson
+}; // OpStats
+
+
+/**
+ * @class OpStatsTimer
+ * @brief Time a phase into the entry, nothing is done if the entry is nullptr (disabled).
+ */
+class OpStatsTimer {
+private:
+    OpStatsEntry *entry;
+    OpPhase       phase;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    OpStatsTimer(OpStatsEntry *e, OpPhase p) : entry(e), phase(p) {
+        if (entry != nullptr) start = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief record the phase once.
+     * @param ok false to count the error.
+     * @param rows The rows processed in the phase.
+     */
+    void stop(bool ok, uint64_t rows = 0) {
+        if (entry == nullptr) return;
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        entry->phases[static_cast<size_t>(phase)].record(static_cast<uint64_t>(ns));
+        if (rows > 0) entry->rows.fetch_add(rows, std::memory_order_relaxed);
+        if (!ok) entry->errors.fetch_add(1, std::memory_order_relaxed);
+        entry = nullptr;
+    }
+}; // OpStatsTimer
+
+} // namespace edadb
@@ -0,0 +1,74 @@
+/**
+ * @file QueryPlan.h
+ * @brief QueryPlan.h defines the query plan report of the statements generated by DbMap,
+ *     collected by DbMap::explainQueryPlans and checked by edadb::checkQueryPlans.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+namespace edadb {
+
+/**
+ * @struct QueryPlanReport
+ * @brief The query plan of a generated statement, the plan lines are the details
+ *     of "EXPLAIN QUERY PLAN", such as "SEARCH p USING INDEX ..." and "USE TEMP B-TREE FOR ORDER BY".
+ */
+struct QueryPlanReport {
+    std::string table;              // the table of the DbMap
+    std::string op;                 // the DbMap operation name, such as "QueryForeignKey"
+    std::string sql;                // the generated statement
+    std::vector<std::string> plan;  // the plan details in the order of the plan rows
+
+    bool full_scan   = false;       // a table is scanned without the index
+    bool temp_btree  = false;       // a temporary b-tree sorts or groups the rows
+    bool auto_index  = false;       // an automatic index is built for the statement
+    bool scan_expected = false;     // the operation reads the whole table by design, such as "Scan"
+
+public:
+    /**
+     * @brief check if the statement is served by the index,
+     *     a full scan or an automatic index means a missing index.
+     */
+    bool indexBacked() const {
+        return scan_expected || (!full_scan && !auto_index);
+    }
+
+    /**
+     * @brief parse the plan details and set the flags.
+     */
+    void analyze() {
+        full_scan = temp_btree = auto_index = false;
+        for (const auto &d : plan) {
+            // "SCAN t" since sqlite 3.36, "SCAN TABLE t" before; "SCAN CONSTANT ROW" reads no table
+            if ((d.compare(0, 5, "SCAN ") == 0) && (d.find("CONSTANT ROW") == std::string::npos)) {
+                full_scan = true;
+            }
+            if (d.find("USE TEMP B-TREE") != std::string::npos) {
+                temp_btree = true;
+            }
+            if (d.find("AUTOMATIC") != std::string::npos) {
+                auto_index = true;
+            }
+        }
+    } // analyze
+
+    /**
+     * @brief print the report, one line for the flags and one per plan detail.
+     */
+    void print(std::ostream &os) const {
+        os << table << " [" << op << "]"
+           << (full_scan ? " FULL_SCAN" : "") << (temp_btree ? " TEMP_BTREE" : "")
+           << (auto_index ? " AUTO_INDEX" : "") << (indexBacked() ? "" : " NOT_INDEXED") << "\n"
+           << "    " << sql << "\n";
+        for (const auto &d : plan) {
+            os << "    -- " << d << "\n";
+        }
+    } // print
+}; // QueryPlanReport
+
+} // namespace edadb
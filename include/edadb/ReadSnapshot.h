@@ -0,0 +1,103 @@
+/**
+ * @file ReadSnapshot.h
+ * @brief ReadSnapshot.h pins several read connections to the same database snapshot,
+ *     so the tables loaded in parallel on different connections see the same commit.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "DbManager.h"
+#include "Database.h"
+
+
+namespace edadb {
+
+/**
+ * @class ReadSnapshot
+ * @brief The read connections in the read transactions on the same commit,
+ *     ended and closed on destruction. The writer goes on in WAL mode, see DbManager::beginSnapshot.
+ *     Each connection is used by one thread at a time, such as:
+ *         ReadSnapshot snap(db, 2);
+ *         std::thread t0([&] { DbMap<Cell>::Reader r(cell_map, snap.connection(0)); ... });
+ *         std::thread t1([&] { DbMap<Net>::Reader  r(net_map,  snap.connection(1)); ... });
+ * @note The readers on the connections must be finalized before the snapshot is destroyed.
+ */
+class ReadSnapshot : public boost::noncopyable {
+public:
+    using Connection = DbManager::Connection;
+
+private:
+    DbManager &manager;
+    std::vector<Connection> conns;
+    bool pinned = false;
+
+public:
+    /**
+     * @brief Open the read connections and pin them to the latest commit.
+     * @param m The database.
+     * @param num_connections The number of the read connections.
+     */
+    ReadSnapshot(DbManager &m, size_t num_connections) : manager(m) {
+        for (size_t i = 0; i < num_connections; ++i) {
+            Connection conn = manager.openReadConnection();
+            if (conn == nullptr) {
+                std::cerr << "ReadSnapshot::ReadSnapshot: open read connection failed" << std::endl;
+                release();
+                return;
+            }
+            conns.push_back(conn);
+        }
+        pinned = manager.beginSnapshot(conns);
+        if (!pinned) {
+            release();
+        }
+    }
+
+    ReadSnapshot(Database &db, size_t num_connections)
+        : ReadSnapshot(db.getManager(), num_connections) {}
+
+    ~ReadSnapshot() {
+        release();
+    }
+
+public:
+    /**
+     * @brief Check if the connections are pinned to the snapshot.
+     */
+    bool valid() const {
+        return pinned;
+    }
+
+    size_t size() const {
+        return conns.size();
+    }
+
+    /**
+     * @brief Get the read connection to construct the DbMap<T>::Reader on.
+     * @param i The connection index, less than size().
+     */
+    Connection connection(size_t i) const {
+        return conns[i];
+    }
+
+    /**
+     * @brief End the read transactions and close the connections.
+     */
+    void release() {
+        if (pinned) {
+            manager.endSnapshot(conns);
+            pinned = false;
+        }
+        for (auto conn : conns) {
+            manager.closeReadConnection(conn);
+        }
+        conns.clear();
+    } // release
+}; // ReadSnapshot
+
+} // namespace edadb
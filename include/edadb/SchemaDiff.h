@@ -0,0 +1,61 @@
+/**
+ * @file SchemaDiff.h
+ * @brief SchemaDiff.h defines the difference between the columns generated for a table
+ *     and the columns of the table on disk, collected and applied by DbMap::evolveSchema.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+namespace edadb {
+
+/**
+ * @struct SchemaDiff
+ * @brief The schema change of a table.
+ *     The added columns are applied by ALTER TABLE ADD COLUMN in place,
+ *     the table is rebuilt only if a column type changed or the key columns are missing.
+ *     The blob column of another layout, such as std::array<double, 2> to 3, is retyped
+ *     and rebuilt as NULL, since the stored bytes cannot be decoded as the new layout.
+ */
+struct SchemaDiff {
+    std::string table;                // the table name
+    std::vector<std::string> added;   // the generated columns missing on disk
+    std::vector<std::string> removed; // the columns on disk not generated, kept unless rebuilt
+    std::vector<std::string> retyped; // the columns of the incompatible type or blob layout
+
+    bool created = false;             // the table does not exist
+    bool rebuild = false;             // the change cannot be applied in place
+
+public:
+    bool changed() const {
+        return created || rebuild || !added.empty() || !removed.empty() || !retyped.empty();
+    }
+
+    /**
+     * @brief print the change in one line, such as "cell: add 2, rebuild".
+     */
+    void print(std::ostream &os) const {
+        auto list = [&os](const char *what, const std::vector<std::string> &cols) {
+            if (cols.empty()) return;
+            os << " " << what << " (";
+            for (size_t i = 0; i < cols.size(); ++i) {
+                os << (i > 0 ? ", " : "") << cols[i];
+            }
+            os << ")";
+        };
+
+        os << table << ":";
+        if (created) os << " create";
+        list("add", added);
+        list("remove", removed);
+        list("retype", retyped);
+        if (rebuild) os << " rebuild";
+        os << "\n";
+    } // print
+}; // SchemaDiff
+
+} // namespace edadb
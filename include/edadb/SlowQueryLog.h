@@ -0,0 +1,231 @@
+/**
+ * @file SlowQueryLog.h
+ * @brief SlowQueryLog.h records the statements running longer than the threshold,
+ *     with the originating table and DbMap operation and the statement counters of the backend.
+ *     Disabled by default, the backend profiles the statements only if enabled.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+#include "Singleton.h"
+
+
+namespace edadb {
+
+/**
+ * @struct SlowQueryRecord
+ * @brief The statement running longer than the threshold.
+ */
+struct SlowQueryRecord {
+    uint64_t    time_us = 0;        // system clock in microseconds since epoch when recorded
+    uint64_t    duration_ns = 0;    // running time reported by the backend
+    std::string table;              // originating table, empty if not run by DbMap
+    std::string op;                 // originating DbMap operation name, such as "QueryForeignKey"
+    std::string sql;                // the statement with the place holders
+
+    // statement counters of the run, 0 if the backend has none
+    uint64_t    fullscan_steps = 0; // forward steps in the full table scans
+    uint64_t    sorts = 0;          // sort operations
+    uint64_t    autoindex = 0;      // rows inserted into the automatic indexes
+    uint64_t    vm_steps = 0;       // virtual machine operations
+}; // SlowQueryRecord
+
+
+/**
+ * @class SlowQueryLog
+ * @brief The slow query log.
+ *     DbMap labels its statements with the table and the operation when prepared,
+ *     the backend reports each finished statement by record(),
+ *     which is kept if the duration exceeds the threshold of the operation.
+ */
+class SlowQueryLog : public Singleton<SlowQueryLog> {
+public:
+    using Sink = std::function<void(const SlowQueryRecord &)>;
+
+    struct Label {
+        std::string table;
+        std::string op;
+    };
+
+private:
+    friend class Singleton<SlowQueryLog>;
+
+    inline static std::atomic<bool>     s_enabled{false};
+    inline static std::atomic<uint64_t> s_min_threshold_ns{0}; // min of all thresholds, the fast check
+
+    std::mutex mtx;
+    uint64_t   threshold_ns = 100 * 1000 * 1000;                // default threshold, 100ms
+    std::unordered_map<std::string, uint64_t>    op_threshold_ns; // threshold per operation name
+    std::unordered_map<const void *, Label>      labels;          // statement handler -> label
+    std::deque<SlowQueryRecord>                  records;         // the recent slow queries
+    size_t     capacity = 256;
+    uint64_t   total = 0;                                         // slow queries recorded
+    Sink       sink;
+
+protected:
+    SlowQueryLog() { s_min_threshold_ns.store(threshold_ns, std::memory_order_relaxed); }
+    ~SlowQueryLog() = default;
+
+public: // configuration
+    static void enable(bool on) {
+        if (on) i(); // create before the backend reports
+        s_enabled.store(on, std::memory_order_relaxed);
+    }
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief set the default threshold.
+     */
+    void setThreshold(std::chrono::nanoseconds t) {
+        std::lock_guard<std::mutex> lock(mtx);
+        threshold_ns = static_cast<uint64_t>(t.count());
+        updateMinThreshold();
+    }
+
+    /**
+     * @brief set the threshold of the operation, overriding the default one.
+     * @param op The DbMap operation name, such as DbMapOpTrait<T, OP>::name().
+     * @param t The threshold; negative to remove the override.
+     */
+    void setThreshold(const std::string &op, std::chrono::nanoseconds t) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (t.count() < 0) {
+            op_threshold_ns.erase(op);
+        } else {
+            op_threshold_ns[op] = static_cast<uint64_t>(t.count());
+        }
+        updateMinThreshold();
+    }
+
+    /**
+     * @brief set the number of the recent slow queries kept.
+     */
+    void setCapacity(size_t n) {
+        std::lock_guard<std::mutex> lock(mtx);
+        capacity = std::max<size_t>(n, 1);
+        while (records.size() > capacity) records.pop_front();
+    }
+
+    /**
+     * @brief set the sink called with each slow query, called under the log lock.
+     */
+    void setSink(Sink s) {
+        std::lock_guard<std::mutex> lock(mtx);
+        sink = std::move(s);
+    }
+
+    /**
+     * @brief the sink printing the slow queries to std::cerr.
+     */
+    static Sink stderrSink() {
+        return [](const SlowQueryRecord &r) {
+            std::cerr << "[EDADB SLOW QUERY] " << r.duration_ns / 1000 << "us"
+                << " table=" << (r.table.empty() ? "-" : r.table)
+                << " op=" << (r.op.empty() ? "-" : r.op)
+                << " fullscan_steps=" << r.fullscan_steps << " sorts=" << r.sorts
+                << " autoindex=" << r.autoindex << std::endl
+                << "    " << r.sql << std::endl;
+        };
+    }
+
+
+public: // statement labels, called by DbMap and the backend
+    /**
+     * @brief label the statement with the originating table and operation.
+     * @param stmt The statement handler of the backend.
+     */
+    void label(const void *stmt, const std::string &table, const std::string &op) {
+        std::lock_guard<std::mutex> lock(mtx);
+        labels[stmt] = Label{table, op};
+    }
+
+    /**
+     * @brief remove the label of the finalized statement.
+     */
+    void unlabel(const void *stmt) {
+        std::lock_guard<std::mutex> lock(mtx);
+        labels.erase(stmt);
+    }
+
+    /**
+     * @brief check if the duration may exceed a threshold, without the lock.
+     */
+    static bool mayRecord(uint64_t duration_ns) {
+        return enabled() && (duration_ns >= s_min_threshold_ns.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief record the finished statement if the duration exceeds the threshold of its operation.
+     * @param stmt The statement handler to find the label.
+     * @param r The record with the duration, the sql and the counters filled by the backend.
+     * @return true if recorded as slow; otherwise, false.
+     */
+    bool record(const void *stmt, SlowQueryRecord r) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = labels.find(stmt);
+        if (it != labels.end()) {
+            r.table = it->second.table;
+            r.op    = it->second.op;
+        }
+
+        uint64_t threshold = threshold_ns;
+        auto ot = op_threshold_ns.find(r.op);
+        if (ot != op_threshold_ns.end()) threshold = ot->second;
+        if (r.duration_ns < threshold) return false;
+
+        r.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        ++total;
+        if (sink) sink(r);
+        records.push_back(std::move(r));
+        while (records.size() > capacity) records.pop_front();
+        return true;
+    } // record
+
+
+public: // read
+    /**
+     * @brief get the recent slow queries from the oldest to the newest.
+     */
+    std::vector<SlowQueryRecord> recent() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return std::vector<SlowQueryRecord>(records.begin(), records.end());
+    }
+
+    /**
+     * @brief get the number of the slow queries recorded since the last clear.
+     */
+    uint64_t getTotal() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return total;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mtx);
+        records.clear();
+        total = 0;
+    }
+
+private:
+    void updateMinThreshold() {
+        uint64_t m = threshold_ns;
+        for (auto &kv : op_threshold_ns) m = std::min(m, kv.second);
+        s_min_threshold_ns.store(m, std::memory_order_relaxed);
+    }
+}; // SlowQueryLog
+
+} // namespace edadb
@@ -0,0 +1,727 @@
+/**
+ * @file Snapshot.h
+ * @brief Snapshot.h provides the memory-mapped binary snapshot file of the DbMap tables.
+ * @note The snapshot file is written in the host layout and all the sections are
+ *     aligned to Config::snapshot_page_size, so a column can be accessed in place:
+ *         [header] [sections of table 0] ... [sections of table n-1] [directory]
+ *     Each column has the sections:
+ *         INT64/DOUBLE: value array of row_count elements, 0 for null;
+ *         TEXT/BLOB   : offset array of (row_count + 1) uint64 into the heap section,
+ *                       each text is terminated by '\0' in the heap;
+ *         null bitmap : (row_count + 7) / 8 bytes, bit i is set if row i is null,
+ *                       only written if the column has null.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <unordered_map>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "Config.h"
+#include "TraitUtils.h"
+#include "BlobLayout.h"
+
+
+namespace edadb {
+
+
+/**
+ * @enum SnapshotColumnKind
+ * @brief The storage kind of the snapshot column.
+ */
+enum class SnapshotColumnKind : uint32_t {
+    INT64 = 0,
+    DOUBLE,
+    TEXT,
+    BLOB
+}; // SnapshotColumnKind
+
+
+/**
+ * @fn snapshotColumnKind
+ * @brief get the storage kind from the declared column type, following the sqlite3 type affinity.
+ * @param decl_type The declared column type, such as "INTEGER"; nullptr if unknown.
+ * @return SnapshotColumnKind Returns the storage kind.
+ */
+inline SnapshotColumnKind snapshotColumnKind(const char *decl_type) {
+    std::string t = (decl_type == nullptr) ? "" : decl_type;
+    for (auto &c : t) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    auto has = [&t](const char *s) { return t.find(s) != std::string::npos; };
+    if (has("INT") || has("BOOL"))                   return SnapshotColumnKind::INT64;
+    if (has("CHAR") || has("CLOB") || has("TEXT"))   return SnapshotColumnKind::TEXT;
+    if (t.empty() || has("BLOB") || has("BINARY"))   return SnapshotColumnKind::BLOB;
+    return SnapshotColumnKind::DOUBLE;
+} // snapshotColumnKind
+
+
+/**
+ * @struct SnapshotHeader
+ * @brief The header at the beginning of the snapshot file.
+ */
+struct SnapshotHeader {
+    static constexpr const char    *s_magic      = "EDADBSNP";
+    static constexpr const uint32_t s_version    = 1;
+    static constexpr const uint32_t s_endian_tag = 0x01020304;
+
+    char     magic[8];    // s_magic without '\0'
+    uint32_t version;     // s_version
+    uint32_t page_size;   // Config::snapshot_page_size
+    uint32_t endian_tag;  // s_endian_tag in the host byte order
+    uint32_t table_count; // number of tables in the directory
+    uint64_t dir_offset;  // offset of the directory
+    uint64_t dir_bytes;   // size of the directory
+    uint64_t file_bytes;  // size of the file
+}; // SnapshotHeader
+
+
+
+/**
+ * @class SnapshotWriter
+ * @brief Write the tables to the snapshot file row by row, one table at a time:
+ *     the columns of the table are buffered in memory and written at endTable.
+ *     The file is written to "path.tmp" and renamed to path at close,
+ *     so an interrupted export never leaves a truncated snapshot.
+ */
+class SnapshotWriter : public boost::noncopyable {
+private:
+    struct ColumnBuilder {
+        std::string          name;
+        SnapshotColumnKind   kind = SnapshotColumnKind::INT64;
+        std::vector<uint8_t> data;  // values or offsets
+        std::vector<uint8_t> nulls; // null bitmap
+        std::vector<uint8_t> heap;  // bytes of text/blob
+        bool                 has_null = false;
+    };
+
+    std::string path, tmp_path;
+    FILE       *fp = nullptr;
+    uint64_t    pos = 0; // current file position
+
+    std::vector<uint8_t> dir; // serialized directory
+    uint32_t table_count = 0;
+
+    // the current table
+    std::vector<ColumnBuilder> cols;
+    uint64_t rows = 0;
+
+public:
+    SnapshotWriter() = default;
+    ~SnapshotWriter() { abort(); }
+
+public:
+    /**
+     * @brief open the snapshot file to write.
+     * @param p The snapshot file path.
+     * @return true if opened; otherwise, false.
+     */
+    bool open(const std::string &p) {
+        abort();
+
+        path = p;
+        tmp_path = p + ".tmp";
+        fp = std::fopen(tmp_path.c_str(), "wb");
+        if (fp == nullptr) {
+            std::cerr << "SnapshotWriter::open: cannot open " << tmp_path << std::endl;
+            return false;
+        }
+
+        // reserve the header page, written at close
+        SnapshotHeader header{};
+        pos = 0;
+        dir.clear();
+        table_count = 0;
+        return writeAligned(&header, sizeof(header), nullptr);
+    } // open
+
+    /**
+     * @brief begin to write a table.
+     * @param name The table name.
+     * @param schema The schema text to validate the table at load, such as the projection SQL.
+     * @param fk_col The foreign key column index to group the rows; -1 if no foreign key.
+     * @param col_names The column names.
+     * @param kinds The column storage kinds.
+     * @return true if success; otherwise, false.
+     */
+    bool beginTable(const std::string &name, const std::string &schema, int32_t fk_col,
+            const std::vector<std::string> &col_names, const std::vector<SnapshotColumnKind> &kinds) {
+        if ((fp == nullptr) || (col_names.size() != kinds.size())) {
+            std::cerr << "SnapshotWriter::beginTable: invalid table " << name << std::endl;
+            return false;
+        }
+
+        putStr(name);
+        putStr(schema);
+        put32(static_cast<uint32_t>(fk_col));
+
+        rows = 0;
+        cols.assign(col_names.size(), ColumnBuilder());
+        for (size_t i = 0; i < cols.size(); ++i) {
+            cols[i].name = col_names[i];
+            cols[i].kind = kinds[i];
+            if (isVar(kinds[i]))
+                appendPod<uint64_t>(cols[i].data, 0);
+        }
+        return true;
+    } // beginTable
+
+    void appendNull(size_t c) {
+        ColumnBuilder &col = cols[c];
+        col.has_null = true;
+        col.nulls.back() |= static_cast<uint8_t>(1u << (rows & 7));
+        if (isVar(col.kind))
+            appendPod<uint64_t>(col.data, col.heap.size());
+        else
+            appendPod<uint64_t>(col.data, 0);
+    } // appendNull
+
+    void appendInt(size_t c, int64_t v) {
+        appendPod<int64_t>(cols[c].data, v);
+    }
+
+    void appendDouble(size_t c, double v) {
+        appendPod<double>(cols[c].data, v);
+    }
+
+    void appendBytes(size_t c, const void *p, size_t n) {
+        ColumnBuilder &col = cols[c];
+        const uint8_t *b = static_cast<const uint8_t *>(p);
+        col.heap.insert(col.heap.end(), b, b + n);
+        if (col.kind == SnapshotColumnKind::TEXT)
+            col.heap.push_back('\0');
+        appendPod<uint64_t>(col.data, col.heap.size());
+    } // appendBytes
+
+    /**
+     * @brief prepare the null bitmap of the next row, call before appending the row values.
+     */
+    void beginRow() {
+        if ((rows & 7) == 0) {
+            for (auto &col : cols)
+                col.nulls.push_back(0);
+        }
+    } // beginRow
+
+    void endRow() {
+        ++rows;
+    }
+
+    /**
+     * @brief write the buffered columns of the table.
+     * @return true if success; otherwise, false.
+     */
+    bool endTable() {
+        put64(rows);
+        put32(static_cast<uint32_t>(cols.size()));
+
+        bool ok = true;
+        for (auto &col : cols) {
+            uint64_t data_off = 0, null_off = 0, heap_off = 0;
+            ok = ok && writeAligned(col.data.data(), col.data.size(), &data_off);
+            if (col.has_null)
+                ok = ok && writeAligned(col.nulls.data(), col.nulls.size(), &null_off);
+            if (isVar(col.kind))
+                ok = ok && writeAligned(col.heap.data(), col.heap.size(), &heap_off);
+
+            putStr(col.name);
+            put32(static_cast<uint32_t>(col.kind));
+            put64(data_off);
+            put64(null_off);
+            put64(heap_off);
+            put64(col.heap.size());
+        } // for
+
+        cols.clear();
+        ++table_count;
+        if (!ok) {
+            std::cerr << "SnapshotWriter::endTable: write failed" << std::endl;
+        }
+        return ok;
+    } // endTable
+
+    /**
+     * @brief write the directory and header, then rename to the snapshot path.
+     * @return true if success; otherwise, false.
+     */
+    bool close() {
+        if (fp == nullptr) {
+            return false;
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SnapshotHeader::s_magic, sizeof(header.magic));
+        header.version     = SnapshotHeader::s_version;
+        header.page_size   = static_cast<uint32_t>(Config::snapshot_page_size);
+        header.endian_tag  = SnapshotHeader::s_endian_tag;
+        header.table_count = table_count;
+        header.dir_bytes   = dir.size();
+
+        bool ok = writeAligned(dir.data(), dir.size(), &header.dir_offset);
+        header.file_bytes = pos;
+        ok = ok && (std::fseek(fp, 0, SEEK_SET) == 0);
+        ok = ok && (std::fwrite(&header, sizeof(header), 1, fp) == 1);
+        ok = (std::fclose(fp) == 0) && ok;
+        fp = nullptr;
+
+        ok = ok && (std::rename(tmp_path.c_str(), path.c_str()) == 0);
+        if (!ok) {
+            std::cerr << "SnapshotWriter::close: write " << path << " failed" << std::endl;
+            std::remove(tmp_path.c_str());
+        }
+        return ok;
+    } // close
+
+    /**
+     * @brief discard the snapshot file being written.
+     */
+    void abort() {
+        if (fp != nullptr) {
+            std::fclose(fp);
+            fp = nullptr;
+            std::remove(tmp_path.c_str());
+        }
+    } // abort
+
+private:
+    static bool isVar(SnapshotColumnKind k) {
+        return (k == SnapshotColumnKind::TEXT) || (k == SnapshotColumnKind::BLOB);
+    }
+
+    template <typename V>
+    static void appendPod(std::vector<uint8_t> &buf, V v) {
+        const uint8_t *b = reinterpret_cast<const uint8_t *>(&v);
+        buf.insert(buf.end(), b, b + sizeof(V));
+    }
+
+    void put32(uint32_t v) { appendPod(dir, v); }
+    void put64(uint64_t v) { appendPod(dir, v); }
+    void putStr(const std::string &s) {
+        put32(static_cast<uint32_t>(s.size()));
+        dir.insert(dir.end(), s.begin(), s.end());
+    }
+
+    /**
+     * @brief write the bytes at the next page boundary.
+     * @param off The offset written at; nullptr if not needed.
+     */
+    bool writeAligned(const void *p, size_t n, uint64_t *off) {
+        const uint64_t page = Config::snapshot_page_size;
+        const uint64_t aligned = (pos + page - 1) / page * page;
+        static const std::array<uint8_t, Config::snapshot_page_size> zeros{};
+        if ((aligned > pos) && (std::fwrite(zeros.data(), aligned - pos, 1, fp) != 1)) {
+            return false;
+        }
+
+        pos = aligned;
+        if (off != nullptr) *off = pos;
+        if ((n > 0) && (std::fwrite(p, n, 1, fp) != 1)) {
+            return false;
+        }
+        pos += n;
+        return true;
+    } // writeAligned
+}; // SnapshotWriter
+
+
+
+/**
+ * @struct SnapshotColumn
+ * @brief One column of the mapped snapshot table, points into the mapped file.
+ */
+struct SnapshotColumn {
+    std::string        name;
+    SnapshotColumnKind kind  = SnapshotColumnKind::INT64;
+    uint64_t           rows  = 0;
+    const uint8_t     *data  = nullptr; // values or offsets
+    const uint8_t     *nulls = nullptr; // nullptr if no null
+    const uint8_t     *heap  = nullptr; // bytes of text/blob
+
+public:
+    bool isNull(size_t i) const {
+        return (nulls != nullptr) && ((nulls[i >> 3] >> (i & 7)) & 1);
+    }
+
+    /**
+     * @brief access the INT64/DOUBLE column in place.
+     * @tparam V int64_t for INT64 column, double for DOUBLE column.
+     * @return The value array of rows elements; nullptr if the kind does not match.
+     */
+    template <typename V>
+    const V *values() const {
+        static_assert(std::is_same_v<V, int64_t> || std::is_same_v<V, double>,
+            "SnapshotColumn::values: only int64_t and double columns are in place");
+        constexpr SnapshotColumnKind k = std::is_same_v<V, int64_t> ?
+            SnapshotColumnKind::INT64 : SnapshotColumnKind::DOUBLE;
+        return (kind == k) ? reinterpret_cast<const V *>(data) : nullptr;
+    } // values
+
+    int64_t getInt(size_t i) const {
+        return (kind == SnapshotColumnKind::DOUBLE) ?
+            static_cast<int64_t>(reinterpret_cast<const double *>(data)[i]) :
+            reinterpret_cast<const int64_t *>(data)[i];
+    }
+
+    double getDouble(size_t i) const {
+        return (kind == SnapshotColumnKind::INT64) ?
+            static_cast<double>(reinterpret_cast<const int64_t *>(data)[i]) :
+            reinterpret_cast<const double *>(data)[i];
+    }
+
+    /**
+     * @brief get the bytes of the TEXT/BLOB value in place, the text is terminated by '\0'.
+     *     The offsets are the begin of each value in the heap, ended by the heap size.
+     * @param i The row index.
+     * @param bytes The number of bytes, excluding the terminating '\0'.
+     */
+    const char *getBytes(size_t i, size_t *bytes) const {
+        const uint64_t *offs = reinterpret_cast<const uint64_t *>(data);
+        *bytes = offs[i + 1] - offs[i];
+        if (*bytes == 0) {
+            return ""; // null
+        }
+
+        if (kind == SnapshotColumnKind::TEXT)
+            --(*bytes); // exclude '\0'
+        return reinterpret_cast<const char *>(heap + offs[i]);
+    } // getBytes
+
+    std::string_view getText(size_t i) const {
+        size_t bytes = 0;
+        const char *p = getBytes(i, &bytes);
+        return std::string_view(p, bytes);
+    }
+}; // SnapshotColumn
+
+
+
+/**
+ * @struct SnapshotTable
+ * @brief One table of the mapped snapshot.
+ */
+struct SnapshotTable {
+    using RowRange = std::pair<size_t, size_t>; // [begin, end)
+
+    std::string name;
+    std::string schema;
+    uint64_t    rows   = 0;
+    int32_t     fk_col = -1; // foreign key column; -1 if no foreign key
+    std::vector<SnapshotColumn> cols;
+
+    // rows grouped by the foreign key, built at load
+    std::unordered_map<int64_t, RowRange>          int_fk_rows;
+    std::unordered_map<std::string_view, RowRange> text_fk_rows;
+
+public:
+    /**
+     * @brief get the column by name.
+     * @return The column; nullptr if not found.
+     */
+    const SnapshotColumn *column(const std::string &col_name) const {
+        for (auto &c : cols) {
+            if (c.name == col_name) return &c;
+        }
+        return nullptr;
+    } // column
+
+    /**
+     * @brief find the rows of the foreign key value, the rows are contiguous.
+     * @param key The foreign key value, which is the primary key of the parent.
+     * @return The row range; empty if not found.
+     */
+    template <typename K>
+    RowRange findForeignKeyRows(const K &key) const {
+        if constexpr (std::is_integral_v<K> || std::is_enum_v<K>) {
+            auto it = int_fk_rows.find(static_cast<int64_t>(key));
+            return (it != int_fk_rows.end()) ? it->second : RowRange(0, 0);
+        }
+        else if constexpr (std::is_floating_point_v<K>) {
+            auto it = int_fk_rows.find(doubleKey(static_cast<double>(key)));
+            return (it != int_fk_rows.end()) ? it->second : RowRange(0, 0);
+        }
+        else {
+            auto it = text_fk_rows.find(std::string_view(key));
+            return (it != text_fk_rows.end()) ? it->second : RowRange(0, 0);
+        }
+    } // findForeignKeyRows
+
+    /**
+     * @brief group the rows by the foreign key column, the rows are sorted by the key.
+     */
+    void buildForeignKeyIndex() {
+        if ((fk_col < 0) || (static_cast<size_t>(fk_col) >= cols.size())) {
+            return;
+        }
+
+        const SnapshotColumn &c = cols[fk_col];
+        for (size_t b = 0, e = 0; b < rows; b = e) {
+            if (c.isNull(b)) { e = b + 1; continue; }
+
+            if (c.kind == SnapshotColumnKind::TEXT || c.kind == SnapshotColumnKind::BLOB) {
+                const std::string_view k = c.getText(b);
+                for (e = b + 1; (e < rows) && !c.isNull(e) && (c.getText(e) == k); ++e) ;
+                text_fk_rows.emplace(k, RowRange(b, e));
+            } else {
+                const int64_t k = fkKey(c, b);
+                for (e = b + 1; (e < rows) && !c.isNull(e) && (fkKey(c, e) == k); ++e) ;
+                int_fk_rows.emplace(k, RowRange(b, e));
+            }
+        } // for
+    } // buildForeignKeyIndex
+
+private:
+    static int64_t doubleKey(double v) {
+        int64_t k = 0;
+        std::memcpy(&k, &v, sizeof(k));
+        return k;
+    }
+
+    static int64_t fkKey(const SnapshotColumn &c, size_t i) {
+        return (c.kind == SnapshotColumnKind::DOUBLE) ? doubleKey(c.getDouble(i)) : c.getInt(i);
+    }
+}; // SnapshotTable
+
+
+
+/**
+ * @class Snapshot
+ * @brief The snapshot file mapped read-only into memory.
+ *     The tables, columns and in place values are valid until close.
+ */
+class Snapshot : public boost::noncopyable {
+private:
+    void  *base  = nullptr;
+    size_t bytes = 0;
+    std::vector<SnapshotTable> tabs;
+    std::unordered_map<std::string, size_t> tab_index;
+
+public:
+    Snapshot() = default;
+    ~Snapshot() { close(); }
+
+public:
+    bool isOpen() const { return base != nullptr; }
+    const std::vector<SnapshotTable> &tables() const { return tabs; }
+
+    /**
+     * @brief get the table by name.
+     * @return The table; nullptr if not found.
+     */
+    const SnapshotTable *table(const std::string &name) const {
+        auto it = tab_index.find(name);
+        return (it != tab_index.end()) ? &tabs[it->second] : nullptr;
+    } // table
+
+    /**
+     * @brief map the snapshot file and load the directory.
+     * @param path The snapshot file path.
+     * @return true if opened; otherwise, false.
+     */
+    bool open(const std::string &path) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Snapshot::open: cannot open " << path << std::endl;
+            return false;
+        }
+
+        struct stat st;
+        if ((::fstat(fd, &st) != 0) || (static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader))) {
+            std::cerr << "Snapshot::open: invalid file " << path << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        bytes = static_cast<size_t>(st.st_size);
+        base = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            std::cerr << "Snapshot::open: mmap failed " << path << std::endl;
+            base = nullptr;
+            bytes = 0;
+            return false;
+        }
+
+        if (!loadDirectory()) {
+            std::cerr << "Snapshot::open: invalid snapshot " << path << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    } // open
+
+    void close() {
+        tabs.clear();
+        tab_index.clear();
+        if (base != nullptr) {
+            ::munmap(base, bytes);
+            base = nullptr;
+            bytes = 0;
+        }
+    } // close
+
+private:
+    bool loadDirectory() {
+        const uint8_t *p = static_cast<const uint8_t *>(base);
+
+        SnapshotHeader header;
+        std::memcpy(&header, p, sizeof(header));
+        if ((std::memcmp(header.magic, SnapshotHeader::s_magic, sizeof(header.magic)) != 0) ||
+            (header.version != SnapshotHeader::s_version) ||
+            (header.endian_tag != SnapshotHeader::s_endian_tag) ||
+            (header.file_bytes != bytes) ||
+            (header.dir_offset + header.dir_bytes > bytes)) {
+            return false;
+        }
+
+        const uint8_t *cur = p + header.dir_offset;
+        const uint8_t *end = cur + header.dir_bytes;
+        bool ok = true;
+
+        auto get32 = [&]() -> uint32_t {
+            uint32_t v = 0;
+            if (cur + sizeof(v) > end) { ok = false; return 0; }
+            std::memcpy(&v, cur, sizeof(v)); cur += sizeof(v);
+            return v;
+        };
+        auto get64 = [&]() -> uint64_t {
+            uint64_t v = 0;
+            if (cur + sizeof(v) > end) { ok = false; return 0; }
+            std::memcpy(&v, cur, sizeof(v)); cur += sizeof(v);
+            return v;
+        };
+        auto getStr = [&]() -> std::string {
+            uint32_t n = get32();
+            if (!ok || (cur + n > end)) { ok = false; return ""; }
+            std::string s(reinterpret_cast<const char *>(cur), n); cur += n;
+            return s;
+        };
+        auto at = [&](uint64_t off) -> const uint8_t * {
+            if (off > bytes) { ok = false; return nullptr; }
+            return (off == 0) ? nullptr : p + off;
+        };
+
+        tabs.resize(header.table_count);
+        for (uint32_t t = 0; ok && (t < header.table_count); ++t) {
+            SnapshotTable &tab = tabs[t];
+            tab.name   = getStr();
+            tab.schema = getStr();
+            tab.fk_col = static_cast<int32_t>(get32());
+            tab.rows   = get64();
+            tab.cols.resize(get32());
+            for (auto &c : tab.cols) {
+                c.name  = getStr();
+                c.kind  = static_cast<SnapshotColumnKind>(get32());
+                c.rows  = tab.rows;
+                c.data  = at(get64());
+                c.nulls = at(get64());
+                c.heap  = at(get64());
+                get64(); // heap bytes
+            }
+            tab.buildForeignKeyIndex();
+            tab_index[tab.name] = t;
+        } // for
+
+        return ok;
+    } // loadDirectory
+}; // Snapshot
+
+
+
+/**
+ * @class SnapshotCursor
+ * @brief The row source on the snapshot table, which provides the same
+ *     fetchNull/fetchColumn interface as DbStatement to materialize the objects.
+ */
+class SnapshotCursor {
+private:
+    const SnapshotTable &tab;
+    size_t row = 0;
+
+public:
+    SnapshotCursor(const SnapshotTable &t, size_t r = 0) : tab(t), row(r) {}
+
+public:
+    void seek(size_t r) { row = r; }
+
+    bool fetchNull(int index) {
+        return tab.cols[index].isNull(row);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, bool>
+        fetchColumn(int index, T *value) {
+        *value = static_cast<T>(tab.cols[index].getInt(row));
+        return true;
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, bool>
+        fetchColumn(int index, T *value) {
+        *value = static_cast<T>(tab.cols[index].getDouble(row));
+        return true;
+    }
+
+    bool fetchColumn(int index, std::string *value) {
+        size_t bytes = 0;
+        const char *p = tab.cols[index].getBytes(row, &bytes);
+        value->assign(p, bytes);
+        return true;
+    }
+    bool fetchColumn(int index, const char **value) {
+        size_t bytes = 0;
+        *value = tab.cols[index].getBytes(row, &bytes);
+        return true;
+    }
+
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        fetchColumn(int index, std::vector<E, Alloc> *value) {
+        size_t bytes = 0;
+        const char *p = tab.cols[index].getBytes(row, &bytes);
+        if (bytes % sizeof(E) != 0) {
+            std::cerr << "SnapshotCursor::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
+
+        value->resize(bytes / sizeof(E));
+        if (bytes > 0)
+            BlobLayout::decode(reinterpret_cast<const unsigned char *>(p), value->size(), value->data());
+        return true;
+    }
+
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        fetchColumn(int index, std::array<E, N> *value) {
+        size_t bytes = 0;
+        const char *p = tab.cols[index].getBytes(row, &bytes);
+        if (bytes != N * sizeof(E)) {
+            std::cerr << "SnapshotCursor::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
+
+        if (bytes > 0)
+            BlobLayout::decode(reinterpret_cast<const unsigned char *>(p), N, value->data());
+        return true;
+    }
+}; // SnapshotCursor
+
+
+} // namespace edadb
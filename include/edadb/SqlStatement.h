@@ -16,6 +16,7 @@
 #include <boost/fusion/include/vector.hpp>
 
 #include "Shadow.h"
+#include "Config.h"
 #include "DbBackendType.h"
 #include "TypeInfoTrait.h"
 #include "TypeMetaData.h"
@@ -105,6 +106,15 @@ public:
 using FKC = ForeignKeyConstraint;
 
 
+/**
+ * @brief Sort order of the ordered scan and keyset pagination.
+ */
+enum class SortOrder {
+    ASC,
+    DESC
+}; // SortOrder
+
+
 
 /**
  * @struct SqlStatementBase
@@ -125,10 +135,12 @@ protected:  // some utility functions
         std::vector<std::string>& type;
         FKC& fkc;
         uint32_t index = 0;
+        std::vector<std::string>* layout = nullptr; // the blob layout, empty if not a blob column
 
     public:
         ColumnNameType(std::vector<std::string>& n, std::vector<std::string>& t,
-            ForeignKeyConstraint& f) : name(n), type(t), fkc(f), index(0) {}
+            ForeignKeyConstraint& f, std::vector<std::string>* l = nullptr) :
+            name(n), type(t), fkc(f), index(0), layout(l) {}
 
         /**
          * @brief Appender for column names to the vector.
@@ -165,7 +177,7 @@ protected:  // some utility functions
                 FKC next_fkc(fkc);
                 next_fkc.updatePrefix(column_name, TypeMetaData<CppType>::table_name());
                 boost::fusion::for_each(
-                    vecs, ColumnNameType<CppType>(name, type, next_fkc));
+                    vecs, ColumnNameType<CppType>(name, type, next_fkc, layout));
             }
             else if constexpr (sqlType == SqlType::External) {
                 assert ((index > 0) &&
@@ -175,7 +187,7 @@ protected:  // some utility functions
                 FKC next_fkc(fkc);
                 next_fkc.updatePrefix(column_name, TypeMetaData<Shadow<CppType>>::table_name());
                 boost::fusion::for_each(
-                    vecs, ColumnNameType<Shadow<CppType>>(name, type, next_fkc));
+                    vecs, ColumnNameType<Shadow<CppType>>(name, type, next_fkc, layout));
             }
             else if constexpr ((!std::is_enum<CppType>::value /* SqlType::Unknown */) &&
                 ((sqlType == SqlType::CompositeVector) || (sqlType == SqlType::Unknown))) {
@@ -186,6 +198,9 @@ protected:  // some utility functions
                 // use the user defined column name
                 name.push_back(fkc.getPrimaryColumnFullName(column_name));
                 type.push_back(getSqlTypeString<CppType>());
+                if (layout != nullptr) {
+                    layout->push_back(blobLayout<CppType>());
+                }
             } // if constexpr sqlType
         } // operator()
     }; // ColumnNameType
@@ -205,10 +220,11 @@ struct SqlStatementImpl : public SqlStatementBase {
 
 
 /**
- * SqlStatement is defined in backend, such as backend/sqlite/SqlStatement4Sqlite.h
- *  using SqlStatement = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE,
- *      SqlStatementImpl<DbBackendType::SQLITE>>;
+ * SqlStatement of Config::backend_type,
+ * SqlStatementImpl is specialized in backend, such as backend/sqlite/SqlStatement4Sqlite.h
  */
+template<typename T>
+using SqlStatement = SqlStatementImpl<Config::backend_type, T>;
 
 
 } // namespace edadb
\ No newline at end of file
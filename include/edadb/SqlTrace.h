@@ -0,0 +1,254 @@
+/**
+ * @file SqlTrace.h
+ * @brief SqlTrace.h traces the SQL statements run by the backends at runtime.
+ *     Off by default, enabled by enableSqlTrace or the environment variable EDADB_SQL_TRACE=<N>,
+ *     which traces 1 of every N statements to std::cout.
+ *     The sampled statements are kept in a lock-free ring buffer and passed to the sink if set.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+
+#include "Singleton.h"
+
+
+namespace edadb {
+
+/**
+ * @struct SqlTraceRecord
+ * @brief The traced statement, the text is truncated to SqlTrace::s_max_sql_len in the ring buffer.
+ */
+struct SqlTraceRecord {
+    uint64_t    seq = 0;        // sequence number of the traced statements
+    uint64_t    time_us = 0;    // system clock in microseconds since epoch
+    std::string sql;            // the statement with the place holders
+    std::string expanded;       // the statement with the bound values, empty if not available
+}; // SqlTraceRecord
+
+
+/**
+ * @class SqlTrace
+ * @brief The runtime SQL trace.
+ *     The backends call traced() first, which is a relaxed atomic load if disabled,
+ *     then record() only for the sampled statements.
+ */
+class SqlTrace : public Singleton<SqlTrace> {
+public:
+    using Sink = std::function<void(const SqlTraceRecord &)>;
+
+    static constexpr size_t s_ring_size   = 1024; // power of two
+    static constexpr size_t s_max_sql_len = 512;
+
+private:
+    friend class Singleton<SqlTrace>;
+
+    /**
+     * The slot of the ring buffer protected by the sequence lock:
+     * the writer makes the version odd while writing, the reader retries if the version changed.
+     */
+    struct Slot {
+        std::atomic<uint64_t> version{0};
+        uint64_t seq = 0;
+        uint64_t time_us = 0;
+        uint32_t sql_len = 0;
+        uint32_t exp_len = 0;
+        char     sql[s_max_sql_len];
+        char     exp[s_max_sql_len];
+    };
+
+    inline static std::atomic<bool>     s_enabled{false};
+    inline static std::atomic<uint32_t> s_sample_every{1};
+    inline static std::atomic<uint64_t> s_counter{0};
+
+    std::atomic<bool>     expand{true};   // expand the bound values if the backend can
+    std::atomic<uint64_t> head{0};        // next slot to write
+    std::atomic<uint64_t> dropped{0};     // records dropped on the slot contention
+    std::array<Slot, s_ring_size> ring;
+
+    std::shared_ptr<const Sink> sink;     // accessed by std::atomic_load/store
+
+protected:
+    SqlTrace() = default;
+    ~SqlTrace() = default;
+
+private:
+    /**
+     * @brief EDADB_SQL_TRACE=<N>: trace 1 of every N statements to std::cout,
+     *     loaded on the static initialization since traced() does not touch the instance.
+     */
+    static bool loadEnv() {
+        const char *env = std::getenv("EDADB_SQL_TRACE");
+        const unsigned long n = (env != nullptr) ? std::strtoul(env, nullptr, 10) : 0;
+        if (n > 0) {
+            setSampleEvery(static_cast<uint32_t>(n));
+            i().setSink(stdoutSink());
+            enable(true);
+        }
+        return (n > 0);
+    }
+
+    inline static const bool s_env_loaded = loadEnv();
+
+public: // configuration
+    static void enable(bool on) { s_enabled.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief trace 1 of every n statements, 1 to trace all.
+     */
+    static void setSampleEvery(uint32_t n) {
+        s_sample_every.store(std::max<uint32_t>(n, 1), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief check if the statement to run is sampled, called once per statement.
+     * @return true if enabled and sampled; otherwise, false.
+     */
+    static bool traced() {
+        if (!enabled()) return false;
+        const uint32_t every = s_sample_every.load(std::memory_order_relaxed);
+        const uint64_t n = s_counter.fetch_add(1, std::memory_order_relaxed);
+        return (every <= 1) || (n % every == 0);
+    }
+
+    /**
+     * @brief expand the bound values into the traced statement, true by default.
+     */
+    void setExpand(bool on) { expand.store(on, std::memory_order_relaxed); }
+    bool getExpand() const  { return expand.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief set the sink called with each sampled statement, nullptr to keep the ring buffer only.
+     *     The sink is called on the thread running the statement.
+     */
+    void setSink(Sink s) {
+        std::shared_ptr<const Sink> p;
+        if (s) p = std::make_shared<const Sink>(std::move(s));
+        std::atomic_store(&sink, p);
+    }
+
+    /**
+     * @brief the sink printing the statements to std::cout.
+     */
+    static Sink stdoutSink() {
+        return [](const SqlTraceRecord &r) {
+            if (r.expanded.empty() || (r.expanded == r.sql)) {
+                std::cout << "[EDADB TRACE] << SQL STATEMENT: " << std::endl;
+                std::cout << "    " << r.sql << std::endl << std::endl;
+            } else {
+                std::cout << "[EDADB TRACE] << RAW SQL STATEMENT: " << std::endl;
+                std::cout << "    " << r.sql << std::endl;
+                std::cout << "[EDADB TRACE] << EXPANDED SQL STATEMENT: " << std::endl;
+                std::cout << "    " << r.expanded << std::endl << std::endl;
+            }
+        };
+    }
+
+
+public: // record and read
+    /**
+     * @brief record the sampled statement into the ring buffer and pass it to the sink.
+     * @param sql The statement with the place holders.
+     * @param expanded The statement with the bound values, nullptr if not available.
+     */
+    void record(const char *sql, const char *expanded = nullptr) {
+        SqlTraceRecord r;
+        r.seq = head.fetch_add(1, std::memory_order_acq_rel);
+        r.time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        if (sql != nullptr) r.sql = sql;
+        if (expanded != nullptr) r.expanded = expanded;
+
+        push(r);
+
+        std::shared_ptr<const Sink> s = std::atomic_load(&sink);
+        if (s) (*s)(r);
+    } // record
+
+    void record(const std::string &sql) {
+        record(sql.c_str(), nullptr);
+    }
+
+    /**
+     * @brief get the recent statements in the ring buffer.
+     * @param n The max number of the statements.
+     * @return The statements from the oldest to the newest.
+     */
+    std::vector<SqlTraceRecord> recent(size_t n = s_ring_size) const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        n = std::min<uint64_t>({n, s_ring_size, end});
+
+        std::vector<SqlTraceRecord> out;
+        out.reserve(n);
+        for (uint64_t i = end - n; i < end; ++i) {
+            const Slot &slot = ring[i & (s_ring_size - 1)];
+            SqlTraceRecord r;
+            const uint64_t v0 = slot.version.load(std::memory_order_acquire);
+            if (v0 & 1) continue; // being written
+
+            r.seq     = slot.seq;
+            r.time_us = slot.time_us;
+            r.sql.assign(slot.sql, std::min<size_t>(slot.sql_len, s_max_sql_len));
+            r.expanded.assign(slot.exp, std::min<size_t>(slot.exp_len, s_max_sql_len));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((v0 == 0) || (slot.version.load(std::memory_order_relaxed) != v0)) continue;
+            if (r.seq != i) continue; // overwritten by a newer record
+            out.push_back(std::move(r));
+        }
+        return out;
+    } // recent
+
+    /**
+     * @brief get the number of the records dropped on the slot contention.
+     */
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief clear the ring buffer and the counters, not thread safe with record().
+     */
+    void clear() {
+        for (auto &slot : ring) slot.version.store(0, std::memory_order_relaxed);
+        head.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        s_counter.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief write the record into its slot, dropped if another writer holds the slot.
+     */
+    void push(const SqlTraceRecord &r) {
+        Slot &slot = ring[r.seq & (s_ring_size - 1)];
+
+        uint64_t v = slot.version.load(std::memory_order_relaxed);
+        if ((v & 1) || !slot.version.compare_exchange_strong(v, v + 1, std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.seq     = r.seq;
+        slot.time_us = r.time_us;
+        slot.sql_len = static_cast<uint32_t>(std::min(r.sql.size(), s_max_sql_len));
+        slot.exp_len = static_cast<uint32_t>(std::min(r.expanded.size(), s_max_sql_len));
+        std::memcpy(slot.sql, r.sql.data(), slot.sql_len);
+        std::memcpy(slot.exp, r.expanded.data(), slot.exp_len);
+
+        slot.version.store(v + 2, std::memory_order_release);
+    } // push
+}; // SqlTrace
+
+} // namespace edadb
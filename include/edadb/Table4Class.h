@@ -230,6 +230,23 @@ GENERATE_CLASS_TYPEMETADATA(CLASSNAME, TABLENAME, CLASS_ELEMS, (EXPAND_member_na
 #define TABLE4CLASS_WITH_PKEY(CLASSNAME, TABLENAME, CLASS_ELEMS, PK_ELEMS) \
 GENERATE_CLASS_TYPEMETADATA_WITH_PKEY(CLASSNAME, TABLENAME, CLASS_ELEMS, (EXPAND_member_names(CLASS_ELEMS)), PK_ELEMS, (EXPAND_member_names(PK_ELEMS)), SqlType::Composite)
 
+/**
+ * @fn TABLE4CLASS_ROWID
+ * @brief TABLE4CLASS_ROWID is a macro to define a table for a class keyed by an integer surrogate key,
+ *     the first member is the INTEGER PRIMARY KEY: the object inserted with the key 0 gets the
+ *     rowid assigned by the database written back, such as:
+ *         struct Via { int64_t id = 0; std::string layer; int x, y; };
+ *         TABLE4CLASS_ROWID(Via, "via", (id, layer, x, y));
+ * @param CLASSNAME The name of the class.
+ * @param TABLENAME The name of the table.
+ * @param CLASS_ELEMS The tuple of class elements, the first is the integer key.
+ */
+#define TABLE4CLASS_ROWID(CLASSNAME, TABLENAME, CLASS_ELEMS) \
+TABLE4CLASS(CLASSNAME, TABLENAME, CLASS_ELEMS) \
+namespace edadb{\
+template<> struct RowidKeyTrait<CLASSNAME> : std::true_type {};\
+}
+
 /**
  * @fn Table4ExternalClass
  * @brief Table4ExternalClass is a macro to define a private table for a class.
@@ -332,3 +349,13 @@ namespace edadb { \
 #define TABLE4CLASS_WVEC(CLASSNAME, TABLENAME, CLASS_ELEMS, VEC_ELEMS) \
 TABLE4CLASS_WVEC_COLNAME(CLASSNAME, TABLENAME, CLASS_ELEMS, (EXPAND_member_names(CLASS_ELEMS)), VEC_ELEMS)
 
+/**
+ * @fn TABLE4CLASS_WVEC_ROWID
+ * @brief TABLE4CLASS_WVEC_ROWID is TABLE4CLASS_WVEC keyed by an integer surrogate key,
+ *     the child rows reference the rowid written back, see TABLE4CLASS_ROWID.
+ */
+#define TABLE4CLASS_WVEC_ROWID(CLASSNAME, TABLENAME, CLASS_ELEMS, VEC_ELEMS) \
+TABLE4CLASS_WVEC(CLASSNAME, TABLENAME, CLASS_ELEMS, VEC_ELEMS) \
+namespace edadb{\
+template<> struct RowidKeyTrait<CLASSNAME> : std::true_type {};\
+}
@@ -11,7 +11,10 @@
 #include <boost/fusion/include/pair.hpp>
 
 #include <iostream> 
+#include <string>
 #include <type_traits>
+#include <vector>
+#include <array>
 
 
 namespace edadb {
@@ -35,6 +38,73 @@ template<typename U, typename Alloc>
 struct is_vector<std::vector<U, Alloc>> : std::true_type {};
 
 
+/**
+ * @brief is_blob_elem: A type trait to check if a type can be stored in a blob
+ *     element by element using memcpy, which is the arithmetic or enum type.
+ */
+template<typename E>
+struct is_blob_elem : std::bool_constant<
+    (std::is_arithmetic_v<E> || std::is_enum_v<E>) && !std::is_const_v<E> > {};
+
+/**
+ * @brief is_blob: A type trait to check if a type is stored as a single blob column:
+ *     std::vector<POD> (except std::vector<bool>) and std::array<POD, N>.
+ */
+template<typename T>
+struct is_blob : std::false_type {};
+
+template<typename E, typename Alloc>
+struct is_blob<std::vector<E, Alloc>> :
+    std::bool_constant<is_blob_elem<E>::value && !std::is_same_v<E, bool>> {};
+
+template<typename E, std::size_t N>
+struct is_blob<std::array<E, N>> : is_blob_elem<E> {};
+
+/**
+ * @brief blob_elem: The element type of the blob type.
+ */
+template<typename T>
+struct blob_elem { using type = void; };
+
+template<typename E, typename Alloc>
+struct blob_elem<std::vector<E, Alloc>> { using type = E; };
+
+template<typename E, std::size_t N>
+struct blob_elem<std::array<E, N>> { using type = E; };
+
+/**
+ * @brief blob_extent: The element count of the std::array blob type, 0 for std::vector.
+ */
+template<typename T>
+struct blob_extent : std::integral_constant<std::size_t, 0> {};
+
+template<typename E, std::size_t N>
+struct blob_extent<std::array<E, N>> : std::integral_constant<std::size_t, N> {};
+
+/**
+ * @brief blobLayout: The layout of the blob type stored in the column, such as "f8x3"
+ *     for std::array<double, 3> and "i4" for std::vector<int>; empty if not a blob type.
+ *     The kind is f (floating point), i (signed) or u (unsigned), the enum by its underlying type.
+ */
+template<typename T>
+inline std::string blobLayout() {
+    if constexpr (is_blob<T>::value) {
+        using E = typename blob_elem<T>::type;
+        using V = typename std::conditional_t<std::is_enum_v<E>,
+            std::underlying_type<E>, std::enable_if<true, E>>::type;
+        const char kind = std::is_floating_point_v<V> ? 'f' : (std::is_signed_v<V> ? 'i' : 'u');
+        std::string layout = kind + std::to_string(sizeof(E));
+        if (blob_extent<T>::value > 0) {
+            layout += "x" + std::to_string(blob_extent<T>::value);
+        }
+        return layout;
+    }
+    else {
+        return std::string();
+    }
+} // blobLayout
+
+
 
 
 
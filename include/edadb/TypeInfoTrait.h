@@ -142,7 +142,9 @@ public:
 template<typename T>
 struct TypeInfoTrait {
     using NoPtrT = std::remove_const_t<std::remove_pointer_t<T>>; // remove const and pointer
-    static constexpr bool is_vector = is_vector<NoPtrT>::value;
+
+    // vector of POD is stored as a blob column, not as a child table
+    static constexpr bool is_vector = is_vector<NoPtrT>::value && !is_blob<NoPtrT>::value;
     using Info = std::conditional_t<
         is_vector, VectorTypeInfo<T>, ScalarTypeInfo<T>
     >;
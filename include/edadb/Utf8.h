@@ -0,0 +1,80 @@
+/**
+ * @file Utf8.h
+ * @brief Utf8.h converts between the wide string and UTF-8 for the backends storing text as UTF-8.
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+
+namespace edadb {
+
+/**
+ * @brief encode the wide string to UTF-8,
+ *     wchar_t is UTF-32 or UTF-16 with surrogate pairs.
+ * @param w The wide string.
+ * @param n The number of wchar_t.
+ * @return The UTF-8 string.
+ */
+inline std::string encodeUtf8(const wchar_t *w, size_t n) {
+    std::string out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t cp = static_cast<uint32_t>(w[i]);
+        if ((sizeof(wchar_t) == 2) && (cp >= 0xD800) && (cp < 0xDC00) && (i + 1 < n)) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<uint32_t>(w[++i]) - 0xDC00);
+        }
+
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    } // for
+    return out;
+} // encodeUtf8
+
+
+/**
+ * @brief decode the UTF-8 bytes to the wide string.
+ * @param s The UTF-8 bytes.
+ * @param n The number of bytes.
+ * @return The wide string.
+ */
+inline std::wstring decodeUtf8(const char *s, size_t n) {
+    std::wstring out;
+    out.reserve(n);
+    const auto *p = reinterpret_cast<const unsigned char*>(s);
+    for (size_t i = 0; i < n; ) {
+        uint32_t cp = p[i];
+        size_t len = (cp < 0x80) ? 1 : (cp < 0xE0) ? 2 : (cp < 0xF0) ? 3 : 4;
+        cp = (len == 1) ? cp : (len == 2) ? (cp & 0x1F) : (len == 3) ? (cp & 0x0F) : (cp & 0x07);
+        for (size_t k = 1; (k < len) && (i + k < n); ++k) {
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        i += len;
+
+        if ((sizeof(wchar_t) == 2) && (cp >= 0x10000)) {
+            cp -= 0x10000;
+            out += static_cast<wchar_t>(0xD800 + (cp >> 10));
+            out += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+        } else {
+            out += static_cast<wchar_t>(cp);
+        }
+    } // for
+    return out;
+} // decodeUtf8
+
+} // namespace edadb
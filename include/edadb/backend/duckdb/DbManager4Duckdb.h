@@ -0,0 +1,728 @@
+/**
+ * @file DbManager4Duckdb.h
+ * @brief DbManager4Duckdb.h provides a way to manage the DuckDB database.
+ *      DuckDB is an in-process columnar database for the analytical scans.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <stdint.h>
+#include <duckdb.h>
+
+#include "Macro4Duckdb.h"
+
+#include "edadb/Config.h"
+#include "edadb/Singleton.h"
+#include "edadb/SqlTrace.h"
+
+#include "edadb/DbBackendType.h"
+#include "edadb/DbStatement.h"
+#include "edadb/backend/duckdb/DbStatement4Duckdb.h"
+#include "edadb/DbManager.h"
+
+namespace edadb {
+
+/**
+ * @class DbManager
+ * @brief This class manages the DuckDB database.
+ *    One database instance per manager, the main connection serves the DbMap,
+ *    and the read connections serve the parallel scan.
+ */
+template<>
+class DbManagerImpl<DbBackendType::DUCKDB> :
+        public Singleton< DbManagerImpl<DbBackendType::DUCKDB> > {
+private:
+    /**
+     * @brief friend class for Singleton pattern.
+     */
+    friend class Singleton< DbManagerImpl<DbBackendType::DUCKDB> >;
+
+public:
+    // database connection handler type
+    using Connection = duckdb_connection;
+
+protected:
+    std::string       connect_param;      // database connection parameter
+    duckdb_database   database = nullptr; // database instance
+    duckdb_connection db = nullptr;       // main connection
+    std::atomic<uint64_t> connect_gen{0}; // bumped on close, see connectGeneration
+
+    // the last rowid key assigned per table, seeded by the max key on the first use
+    std::unordered_map<std::string, int64_t> rowid_keys;
+    std::mutex rowid_mtx;
+
+    // connectWal: the idle connections of the Readers, a connection is not shared by threads
+    std::mutex                     reader_mtx;
+    std::vector<duckdb_connection> idle_readers;
+    size_t                         reader_pool_size = 0; // 0 if the Readers use the main connection
+    bool                           wal_mode = false;
+
+    // the thread in the transaction of the main connection, which reads its own writes
+    std::atomic<std::thread::id> txn_thread{};
+
+public:
+    // DuckDB bind parameter index starts from 1
+    static const uint32_t s_bind_column_begin_index = 1;
+
+    // DuckDB fetch column index starts from 0
+    static const uint32_t s_read_column_begin_index = 0;
+
+    // DuckDB has no rowid alias and the appender cannot return the key, see nextRowidKey
+    static const bool s_assign_rowid_key = false;
+
+    // DuckDB has no SAVEPOINT, and BEGIN TRANSACTION fails in a transaction
+    static const bool s_has_savepoint = false;
+
+public:
+    /**
+     * @brief ctor of the database owned by a Database handle,
+     *     the default database is the Singleton DbManager::i().
+     */
+    DbManagerImpl(void) = default;
+
+    /**
+     * @brief dtor closes the database without the checkpoint, the DbMap bound to it must be destroyed before.
+     *     The dtor of the Singleton runs at exit, when DuckDB can no longer checkpoint,
+     *     so the write ahead log is replayed on the next open instead.
+     */
+    ~DbManagerImpl() {
+        closeDatabase();
+    }
+
+    DbManagerImpl(const DbManagerImpl &) = delete;
+    DbManagerImpl &operator=(const DbManagerImpl &) = delete;
+
+
+public: // database operation
+    /**
+     * @brief Get the database connection parameter.
+     * @return connected status.
+     */
+    bool isConnected() const {
+        return !connect_param.empty();
+    }
+
+    /**
+     * @brief Get the generation of the connection, bumped on close,
+     *     the read connections kept across the reads are stale if opened in another generation.
+     */
+    uint64_t connectGeneration() const {
+        return connect_gen.load();
+    }
+
+
+    /**
+     * @brief Connect to the database using the connection parameter.
+     * @param c The database file, ":memory:" for the in-memory database.
+     * @return true if connected; otherwise, false.
+     */
+    bool connect(const std::string &c = "edadb.duckdb") {
+        if (isConnected()) {
+            return true;
+        }
+
+        char *err = nullptr;
+        if (duckdb_open_ext(c.c_str(), &database, nullptr, &err) != DuckDBSuccess) {
+            std::cerr << "DbManager4Duckdb::connect[duckdb_open_ext] failed!" << std::endl;
+            std::cerr << "Error: " << (err ? err : "Unknown error") << std::endl;
+            duckdb_free(err);
+            database = nullptr;
+            return false;
+        }
+
+        if (duckdb_connect(database, &db) != DuckDBSuccess) {
+            std::cerr << "DbManager4Duckdb::connect[duckdb_connect] failed!" << std::endl;
+            duckdb_close(&database);
+            database = nullptr;
+            db = nullptr;
+            return false;
+        }
+
+        // close() checkpoints instead, see ~DbManagerImpl
+        duckdb_result res;
+        duckdb_query(db, "PRAGMA disable_checkpoint_on_shutdown;", &res);
+        duckdb_destroy_result(&res);
+
+        connect_param = c;
+        return true;
+    } // connect
+
+
+    /**
+     * @brief Execute the SQL statement directly.
+     * @param sql The SQL statement.
+     * @return true if executed; otherwise, false.
+     */
+    bool exec(const std::string &sql) {
+        if (SqlTrace::traced()) {
+            SqlTrace::i().record(sql);
+        }
+
+        duckdb_result res;
+        bool executed = (duckdb_query(db, sql.c_str(), &res) == DuckDBSuccess);
+        if (!executed) {
+            std::cerr << "DbManager4Duckdb::exec[duckdb_query] failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL: " + sql);
+        } // if
+        duckdb_destroy_result(&res);
+
+        // a failed commit rolls back in DuckDB, so the transaction ends either way
+        const std::string word = firstKeyword(sql);
+        if (executed && (word == "BEGIN")) {
+            txn_thread.store(std::this_thread::get_id());
+        }
+        else if ((word == "COMMIT") || (word == "END") || (word == "ROLLBACK") || (word == "ABORT")) {
+            txn_thread.store(std::thread::id());
+        }
+        return executed;
+    } // exec
+
+
+    /**
+     * @brief close the database after the checkpoint.
+     *     The statements must be finalized before, DuckDB has no API to enumerate them.
+     * @return true if closed; otherwise, false.
+    */
+    bool close() {
+        if (db != nullptr) {
+            // fails if a transaction is running, the log is replayed on the next open then
+            duckdb_result res;
+            duckdb_query(db, "CHECKPOINT;", &res);
+            duckdb_destroy_result(&res);
+        }
+        return closeDatabase();
+    } // close
+
+
+    /**
+     * @brief Check if a table exists in the database.
+     * @param name The table name.
+     * @return true if exists; otherwise, false.
+     */
+    bool tableExists(std::string name) {
+        if (name.empty()) return false;
+
+        static constexpr const char* kSQL =
+            "SELECT 1 FROM information_schema.tables WHERE table_name = ? LIMIT 1;";
+        duckdb_prepared_statement s = nullptr;
+        if (duckdb_prepare(db, kSQL, &s) != DuckDBSuccess) {
+            duckdb_destroy_prepare(&s);
+            return false;
+        }
+
+        bool found = false;
+        duckdb_result res;
+        duckdb_bind_varchar_length(s, 1, name.data(), name.size());
+        if (duckdb_execute_prepared(s, &res) == DuckDBSuccess) {
+            found = (duckdb_row_count(&res) > 0);
+        }
+        duckdb_destroy_result(&res);
+        duckdb_destroy_prepare(&s);
+
+        return found;
+    } // tableExists
+
+
+    /**
+     * @brief Read the schema fingerprint stored for the root table.
+     * @param name The root table name.
+     * @param fp The fingerprint.
+     * @return true if found; otherwise, false.
+     */
+    bool readSchemaFingerprint(const std::string &name, std::string &fp) {
+        if (!tableExists(Config::schema_table_name)) return false;
+
+        const std::string sql = std::string("SELECT fingerprint FROM \"") +
+            Config::schema_table_name + "\" WHERE name = ?;";
+        duckdb_prepared_statement s = nullptr;
+        if (duckdb_prepare(db, sql.c_str(), &s) != DuckDBSuccess) {
+            EDADB_DUCKDB_LOG_ERROR(duckdb_prepare_error(s), "Failed to prepare SQL: " + sql);
+            duckdb_destroy_prepare(&s);
+            return false;
+        }
+
+        bool found = false;
+        duckdb_result res;
+        duckdb_bind_varchar_length(s, 1, name.data(), name.size());
+        if (duckdb_execute_prepared(s, &res) == DuckDBSuccess) {
+            found = (duckdb_row_count(&res) > 0) && !duckdb_value_is_null(&res, 0, 0);
+            if (found) {
+                char *v = duckdb_value_varchar(&res, 0, 0);
+                fp = v;
+                duckdb_free(v);
+            }
+        }
+        duckdb_destroy_result(&res);
+        duckdb_destroy_prepare(&s);
+        return found;
+    } // readSchemaFingerprint
+
+
+    /**
+     * @brief Store the schema fingerprint of the root table, the metadata table is created if not exists.
+     * @param name The root table name.
+     * @param fp The fingerprint.
+     * @return true if stored; otherwise, false.
+     */
+    bool writeSchemaFingerprint(const std::string &name, const std::string &fp) {
+        const std::string tab = std::string("\"") + Config::schema_table_name + "\"";
+        if (!exec("CREATE TABLE IF NOT EXISTS " + tab +
+                " (name VARCHAR PRIMARY KEY, fingerprint VARCHAR NOT NULL);")) {
+            return false;
+        }
+
+        const std::string sql = "INSERT OR REPLACE INTO " + tab + " (name, fingerprint) VALUES (?, ?);";
+        duckdb_prepared_statement s = nullptr;
+        if (duckdb_prepare(db, sql.c_str(), &s) != DuckDBSuccess) {
+            EDADB_DUCKDB_LOG_ERROR(duckdb_prepare_error(s), "Failed to prepare SQL: " + sql);
+            duckdb_destroy_prepare(&s);
+            return false;
+        }
+
+        duckdb_result res;
+        duckdb_bind_varchar_length(s, 1, name.data(), name.size());
+        duckdb_bind_varchar_length(s, 2, fp.data(), fp.size());
+        bool stored = (duckdb_execute_prepared(s, &res) == DuckDBSuccess);
+        if (!stored) {
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL: " + sql);
+        }
+        duckdb_destroy_result(&res);
+        duckdb_destroy_prepare(&s);
+        return stored;
+    } // writeSchemaFingerprint
+
+
+    /**
+     * @brief Get the columns of the table on disk by "PRAGMA table_info".
+     * @param name The table name.
+     * @param names The column names in the table order.
+     * @param types The column types by the canonical names.
+     * @return true if the table exists; otherwise, false.
+     */
+    bool tableColumns(const std::string &name,
+            std::vector<std::string> &names, std::vector<std::string> &types) {
+        const std::string sql = "PRAGMA table_info('" + name + "');";
+        duckdb_result res;
+        if (duckdb_query(db, sql.c_str(), &res) != DuckDBSuccess) {
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL: " + sql);
+            duckdb_destroy_result(&res);
+            return false;
+        }
+
+        // columns: cid, name, type, notnull, dflt_value, pk
+        names.clear();
+        types.clear();
+        const idx_t rows = duckdb_row_count(&res);
+        for (idx_t r = 0; r < rows; ++r) {
+            char *n = duckdb_value_varchar(&res, 1, r);
+            char *t = duckdb_value_varchar(&res, 2, r);
+            names.emplace_back(n ? n : "");
+            types.emplace_back(t ? t : "");
+            duckdb_free(n);
+            duckdb_free(t);
+        }
+        duckdb_destroy_result(&res);
+        return !names.empty();
+    } // tableColumns
+
+
+    /**
+     * @brief Rebuild the table by the new definition and copy the common columns,
+     *     for the changes ALTER TABLE cannot apply in place.
+     *     The tables have no foreign key constraint in DuckDB, the indexes of the old table are dropped.
+     * @param name The table name.
+     * @param tmp_name The name the new table is created by create_sql, renamed to name at last.
+     * @param create_sql The create table statement of the new table named tmp_name.
+     * @param copy_cols The columns copied from the old table.
+     * @return true if rebuilt; otherwise, false.
+     */
+    bool rebuildTable(const std::string &name, const std::string &tmp_name,
+            const std::string &create_sql, const std::vector<std::string> &copy_cols) {
+        std::string cols;
+        for (size_t i = 0; i < copy_cols.size(); ++i) {
+            cols += (i > 0 ? ", " : "") + copy_cols[i];
+        }
+
+        bool ok = exec("DROP TABLE IF EXISTS \"" + tmp_name + "\";") && exec(create_sql);
+        if (ok && !copy_cols.empty()) {
+            ok = exec("INSERT INTO \"" + tmp_name + "\" (" + cols + ") SELECT " + cols +
+                " FROM \"" + name + "\";");
+        }
+        return ok && exec("DROP TABLE \"" + name + "\";") &&
+            exec("ALTER TABLE \"" + tmp_name + "\" RENAME TO \"" + name + "\";");
+    } // rebuildTable
+
+
+    /**
+     * @brief Get the rowid range of the table, used to partition the table scan.
+     * @param name The table name.
+     * @param lo The min rowid.
+     * @param hi The max rowid.
+     * @param conn The connection to query, nullptr for the main connection.
+     * @return true if the table is not empty; otherwise, false.
+     */
+    bool rowidRange(const std::string &name, int64_t &lo, int64_t &hi, Connection conn = nullptr) {
+        const std::string sql = "SELECT min(rowid), max(rowid) FROM \"" + name + "\";";
+        duckdb_result res;
+        if (duckdb_query((conn != nullptr) ? conn : db, sql.c_str(), &res) != DuckDBSuccess) {
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL: " + sql);
+            duckdb_destroy_result(&res);
+            return false;
+        }
+
+        bool found = (duckdb_row_count(&res) > 0) && !duckdb_value_is_null(&res, 0, 0);
+        if (found) {
+            lo = duckdb_value_int64(&res, 0, 0);
+            hi = duckdb_value_int64(&res, 1, 0);
+        }
+        duckdb_destroy_result(&res);
+        return found;
+    } // rowidRange
+
+
+    /**
+     * @brief The query plan is not explained in the backend.
+     * @return false.
+     */
+    bool explainQueryPlan(const std::string &sql, std::vector<std::string> &details) {
+        (void)sql;
+        details.clear();
+        std::cerr << "DbManager4Duckdb::explainQueryPlan: not supported" << std::endl;
+        return false;
+    }
+
+
+public: // in-memory database
+    /**
+     * @brief The online backup of Sqlite3 is not available in DuckDB,
+     *     use connect(":memory:") and "ATTACH ... ; COPY FROM DATABASE ..." instead.
+     * @return false.
+     */
+    bool connectInMemory(const std::string &file) {
+        std::cerr << "DbManager4Duckdb::connectInMemory: not supported, "
+            << "use connect(\":memory:\") to open " << file << std::endl;
+        return false;
+    }
+
+    bool isInMemory() const {
+        return false;
+    }
+
+    bool save(int pages_per_step = Config::backup_pages_per_step) {
+        (void)pages_per_step;
+        std::cerr << "DbManager4Duckdb::save: not supported" << std::endl;
+        return false;
+    }
+
+    std::future<bool> saveAsync(int pages_per_step = Config::backup_pages_per_step) {
+        return std::async(std::launch::deferred,
+            [this, pages_per_step] { return save(pages_per_step); });
+    }
+
+    bool startAutoSave(std::chrono::milliseconds interval) {
+        (void)interval;
+        std::cerr << "DbManager4Duckdb::startAutoSave: not supported" << std::endl;
+        return false;
+    }
+
+    void stopAutoSave() {}
+
+
+public: // read connections for parallel read
+    /**
+     * @brief The connections of the database instance share it, in memory or not.
+     * @return true if connected; otherwise, false.
+     */
+    bool canOpenReadConnection() const {
+        return isConnected();
+    }
+
+    /**
+     * @brief Open a connection to the connected database.
+     *     Each connection should be used by one thread only.
+     * @return The connection handler; nullptr if failed.
+     */
+    Connection openReadConnection() {
+        if (!isConnected()) {
+            std::cerr << "DbManager4Duckdb::openReadConnection: not connected" << std::endl;
+            return nullptr;
+        }
+
+        duckdb_connection conn = nullptr;
+        if (duckdb_connect(database, &conn) != DuckDBSuccess) {
+            std::cerr << "DbManager4Duckdb::openReadConnection[duckdb_connect] failed!" << std::endl;
+            return nullptr;
+        }
+        return conn;
+    } // openReadConnection
+
+    /**
+     * @brief Close the connection opened by openReadConnection.
+     * @param conn The connection handler.
+     * @return true if closed; otherwise, false.
+     */
+    bool closeReadConnection(Connection conn) {
+        if (conn != nullptr) {
+            duckdb_disconnect(&conn);
+        }
+        return true;
+    } // closeReadConnection
+
+
+    /**
+     * @brief Connect with the reader pool, the main connection is the only writer
+     *     and the Readers run on the pooled connections, so the reads go on while writing.
+     *     DuckDB always logs ahead and reads by MVCC, no journal mode is set.
+     * @param c The database file.
+     * @param readers The number of the connections kept in the pool.
+     * @param checkpoint_interval Unused, DuckDB checkpoints by its checkpoint_threshold.
+     * @return true if connected with the reader pool; otherwise, false.
+     */
+    bool connectWal(const std::string &c,
+            size_t readers = Config::wal_reader_connections,
+            std::chrono::milliseconds checkpoint_interval =
+                std::chrono::milliseconds(Config::wal_checkpoint_interval_ms)) {
+        (void)checkpoint_interval;
+        if (isConnected()) {
+            return wal_mode && (connect_param == c);
+        }
+        if (!connect(c)) {
+            return false;
+        }
+        wal_mode = true;
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            for (size_t i = 0; i < readers; ++i) {
+                duckdb_connection conn = openReadConnection();
+                if (conn == nullptr) break;
+                idle_readers.push_back(conn);
+            }
+            reader_pool_size = idle_readers.size();
+        }
+        if (reader_pool_size < readers) {
+            close();
+            return false;
+        }
+        return true;
+    } // connectWal
+
+    /**
+     * @brief Check if connected by connectWal.
+     * @return true if the Readers use the reader pool; otherwise, false.
+     */
+    bool isWal() const {
+        return wal_mode;
+    }
+
+    /**
+     * @brief Acquire a pooled connection for a Reader,
+     *     another connection is opened if all in the pool are in use.
+     * @return The connection to read on; nullptr for the main connection,
+     *     if not connected by connectWal or the calling thread is in a transaction of the main connection.
+     */
+    Connection acquireReadConnection() {
+        if ((reader_pool_size == 0) || (txn_thread.load() == std::this_thread::get_id())) {
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            if (!idle_readers.empty()) {
+                duckdb_connection conn = idle_readers.back();
+                idle_readers.pop_back();
+                return conn;
+            }
+        }
+        return openReadConnection();
+    } // acquireReadConnection
+
+    /**
+     * @brief Release the connection acquired by acquireReadConnection,
+     *     the statements on it must be destroyed.
+     * @param conn The connection handler.
+     */
+    void releaseReadConnection(Connection conn) {
+        if (conn == nullptr) return;
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            if (idle_readers.size() < reader_pool_size) {
+                idle_readers.push_back(conn);
+                return;
+            }
+        }
+        closeReadConnection(conn);
+    } // releaseReadConnection
+
+    /**
+     * @brief Checkpoint the write ahead log into the database file.
+     * @return true if success; otherwise, false.
+     */
+    bool checkpoint() {
+        return exec("CHECKPOINT;");
+    }
+
+
+    /**
+     * @brief Begin the transactions of the read connections back to back,
+     *     DuckDB cannot share a snapshot, a commit in between is seen by the later connections.
+     * @param conns The connections opened by openReadConnection.
+     * @return true if begun; otherwise, false, no transaction is left.
+     */
+    bool beginSnapshot(const std::vector<Connection> &conns) {
+        bool ok = true;
+        for (auto conn : conns) {
+            duckdb_result res;
+            ok = ok && (duckdb_query(conn, "BEGIN TRANSACTION;", &res) == DuckDBSuccess);
+            duckdb_destroy_result(&res);
+        }
+        if (!ok) {
+            std::cerr << "DbManager4Duckdb::beginSnapshot: begin the transactions failed" << std::endl;
+            endSnapshot(conns);
+        }
+        return ok;
+    } // beginSnapshot
+
+    bool endSnapshot(const std::vector<Connection> &conns) {
+        for (auto conn : conns) {
+            duckdb_result res;
+            duckdb_query(conn, "COMMIT;", &res); // fails if not begun
+            duckdb_destroy_result(&res);
+        }
+        return true;
+    } // endSnapshot
+
+
+
+public: // statement operation
+    /**
+     * @brief Initialize the SQL statement
+     * @param stmt The DuckDB statement
+     * @param conn The connection to run the statement, nullptr for the main connection
+     * @return true if initialized; otherwise, false
+     */
+    bool initStatement(DbStatementImpl<DbBackendType::DUCKDB> &dbstmt,
+            Connection conn = nullptr) {
+        // use the main connection if no connection specified
+        dbstmt.db = (conn != nullptr) ? conn : db;
+        dbstmt.stmt = nullptr;
+        dbstmt.appender = nullptr;
+
+        return true;
+    } // initStatement
+
+    /**
+     * @brief check the number of rows changed by the last statement of this thread.
+     * @return The number of rows changed.
+     */
+    int changes() {
+        return static_cast<int>(DbStatementImpl<DbBackendType::DUCKDB>::last_changes);
+    }
+
+    /**
+     * @brief The key is assigned before insert by nextRowidKey, see s_assign_rowid_key.
+     * @return 0.
+     */
+    int64_t lastInsertRowid(Connection conn = nullptr) {
+        (void)conn;
+        return 0;
+    }
+
+    /**
+     * @brief Assign the next key of the rowid key table before insert,
+     *     the keys assigned are not reused even if the insert is rolled back.
+     * @param name The table name.
+     * @param col The key column name.
+     * @param key The key assigned, the max key in the table + 1 on the first use.
+     * @return true if assigned; otherwise, false.
+     */
+    bool nextRowidKey(const std::string &name, const std::string &col, int64_t &key) {
+        std::lock_guard<std::mutex> lock(rowid_mtx);
+        auto it = rowid_keys.find(name);
+        if (it == rowid_keys.end()) {
+            const std::string sql = "SELECT coalesce(max(" + col + "), 0) FROM \"" + name + "\";";
+            duckdb_result res;
+            if (duckdb_query(db, sql.c_str(), &res) != DuckDBSuccess) {
+                EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL: " + sql);
+                duckdb_destroy_result(&res);
+                return false;
+            }
+            const int64_t max_key = (duckdb_row_count(&res) > 0) ? duckdb_value_int64(&res, 0, 0) : 0;
+            duckdb_destroy_result(&res);
+            it = rowid_keys.emplace(name, max_key).first;
+        }
+
+        key = ++it->second;
+        return true;
+    } // nextRowidKey
+
+
+private:
+    /**
+     * @brief get the first keyword of the statement in upper case.
+     * @param sql The SQL statement.
+     */
+    static std::string firstKeyword(const std::string &sql) {
+        size_t b = 0;
+        while ((b < sql.size()) && std::isspace(static_cast<unsigned char>(sql[b]))) ++b;
+        size_t e = b;
+        while ((e < sql.size()) && std::isalpha(static_cast<unsigned char>(sql[e]))) ++e;
+
+        std::string word = sql.substr(b, e - b);
+        for (auto &c : word) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return word;
+    } // firstKeyword
+
+    /**
+     * @brief close the database without the checkpoint.
+     * @return true.
+     */
+    bool closeDatabase(void) {
+        closeReaderPool();
+        ++connect_gen;
+        txn_thread.store(std::thread::id());
+        if (db != nullptr) {
+            duckdb_disconnect(&db);
+            db = nullptr;
+        }
+        if (database != nullptr) {
+            duckdb_close(&database);
+            database = nullptr;
+        }
+
+        connect_param.clear();
+        {
+            std::lock_guard<std::mutex> lock(rowid_mtx);
+            rowid_keys.clear();
+        }
+        return true;
+    } // closeDatabase
+
+    /**
+     * @brief close the idle connections of the reader pool,
+     *     the connections still acquired are closed on release.
+     */
+    void closeReaderPool(void) {
+        std::lock_guard<std::mutex> lock(reader_mtx);
+        for (auto conn : idle_readers) {
+            closeReadConnection(conn);
+        }
+        idle_readers.clear();
+        reader_pool_size = 0;
+        wal_mode = false;
+    } // closeReaderPool
+}; // DbManagerImpl<DbBackendType::DUCKDB>
+
+} // namespace edadb
@@ -0,0 +1,722 @@
+/***
+ * @file DbStatement4Duckdb.h
+ * @brief DbStatement4Duckdb.h provides a way to manage the DuckDB statement.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <iostream>
+
+#include <duckdb.h>
+
+#include "edadb/DbBackendType.h"
+#include "edadb/DbStatement.h"
+#include "edadb/TraitUtils.h"
+#include "edadb/BlobLayout.h"
+#include "edadb/Utf8.h"
+#include "edadb/SqlTrace.h"
+#include "Macro4Duckdb.h"
+
+
+namespace edadb {
+
+/**
+ * @struct DbStatement
+ * @brief This struct holds the DuckDB prepared statement or appender, and the result in fetch.
+ *     The result is fetched chunk by chunk (vectorized), the columns are read from the chunk vectors.
+ *     The insert statement is served by the appender, @see prepareAppend.
+ */
+template <>
+struct DbStatementImpl<DbBackendType::DUCKDB> {
+    // insert by the appender instead of the prepared insert statement
+    static constexpr bool has_appender = true;
+
+    // DuckDB connection handler
+    duckdb_connection db = nullptr;
+
+    // statement handler
+    duckdb_prepared_statement stmt = nullptr;
+
+    // appender handler, prepared by prepareAppend
+    duckdb_appender appender = nullptr;
+
+    // the result of the statement and the chunk under the cursor
+    duckdb_result     result{};
+    bool              executed   = false;
+    duckdb_data_chunk chunk      = nullptr;
+    idx_t             chunk_size = 0;
+    idx_t             row        = 0;
+    std::vector<duckdb_type> col_types;
+
+    // text buffer returned by fetchColumn(const char**), valid until the next fetch
+    std::string  text_buf;
+    std::wstring wtext_buf;
+
+    // number of rows changed by the last bindStep of this thread
+    inline static thread_local idx_t last_changes = 0;
+
+private:
+    /**
+     * @brief the value bound in the appender mode:
+     *     the row is buffered until bindStep since the appender can not drop a partial row.
+     */
+    struct Cell {
+        enum class Kind { NUL, BOOL, INT32, INT64, DOUBLE, TEXT, BLOB };
+        Kind        kind = Kind::NUL;
+        int64_t     i = 0;
+        double      d = 0;
+        std::string s;
+    };
+    std::vector<Cell> cells;
+
+public:
+    DbStatementImpl () = default;
+    ~DbStatementImpl() = default;
+
+public:
+    inline bool invalidDb     () { return (db   == nullptr); }
+    inline bool stmtIsNull    () { return (stmt == nullptr) && (appender == nullptr); }
+    inline bool stmtIsPrepared() { return !stmtIsNull(); }
+    inline bool isAppender    () { return (appender != nullptr); }
+
+    /**
+     * @brief prepare the SQL statement
+     */
+    bool prepare(const std::string &sql) {
+        if (invalidDb()) {
+            std::cerr << "DbStatementImpl::prepare: invalid database" << std::endl;
+            return false;
+        }
+
+        if (stmtIsPrepared()) {
+            std::cerr << "DbStatementImpl::prepare: statement is already prepared" << std::endl;
+            return false;
+        }
+
+        if (SqlTrace::traced()) {
+            SqlTrace::i().record(sql);
+        }
+
+        bool prepared = (duckdb_prepare(db, sql.c_str(), &stmt) == DuckDBSuccess);
+        if (!prepared) {
+            std::cerr << "DbStatementImpl::prepare: duckdb_prepare failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_prepare_error(stmt), "Failed to prepare SQL: " + sql);
+            duckdb_destroy_prepare(&stmt);
+            stmt = nullptr;
+        }
+        return prepared;
+    }
+
+    /**
+     * @brief no slow query log in the backend, the label is ignored.
+     */
+    void setLabel(const std::string &, const char *) {}
+
+    /**
+     * @brief prepare the appender to insert rows into the table in bulk,
+     *     the columns are bound in the table column order and appended on bindStep.
+     *     The rows are flushed to the table on finalize.
+     * @param table The table name.
+     * @return true if prepared; otherwise, false.
+     */
+    bool prepareAppend(const std::string &table) {
+        if (invalidDb()) {
+            std::cerr << "DbStatementImpl::prepareAppend: invalid database" << std::endl;
+            return false;
+        }
+
+        if (stmtIsPrepared()) {
+            std::cerr << "DbStatementImpl::prepareAppend: statement is already prepared" << std::endl;
+            return false;
+        }
+
+        if (SqlTrace::traced()) {
+            SqlTrace::i().record("APPEND TO " + table);
+        }
+
+        bool prepared =
+            (duckdb_appender_create(db, nullptr, table.c_str(), &appender) == DuckDBSuccess);
+        if (!prepared) {
+            std::cerr << "DbStatementImpl::prepareAppend: duckdb_appender_create failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_appender_error(appender), "Failed to create appender: " + table);
+            duckdb_appender_destroy(&appender);
+            appender = nullptr;
+        }
+        cells.clear();
+        return prepared;
+    }
+
+    /**
+     * @brief clear all of the binding placeholder in the SQL statement
+     * @return true if cleared; otherwise, false.
+     */
+    bool clearBindings() {
+        if (isAppender()) {
+            cells.clear();
+            return true;
+        }
+
+        bool cleared = (duckdb_clear_bindings(stmt) == DuckDBSuccess);
+        if (!cleared) {
+            std::cerr << "DbStatementImpl::clearBindings: duckdb_clear_bindings failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_prepare_error(stmt), "Failed to clear bindings in SQL statement");
+        }
+        return cleared;
+    }
+
+    /**
+     * @brief reset the SQL statement, the result is released
+     * @return true if reseted; otherwise, false.
+     */
+    bool reset() {
+        closeResult();
+        cells.clear();
+        return true;
+    }
+
+    /**
+     * @brief finalize the SQL statement, the appended rows are flushed.
+     * @return true if finalized; otherwise, false.
+     */
+    bool finalize() {
+        closeResult();
+        cells.clear();
+
+        bool finalized = true;
+        if (appender != nullptr) {
+            finalized = (duckdb_appender_close(appender) == DuckDBSuccess);
+            if (!finalized) {
+                std::cerr << "DbStatementImpl::finalize: duckdb_appender_close failed!" << std::endl;
+                EDADB_DUCKDB_LOG_ERROR(duckdb_appender_error(appender), "Failed to flush appender");
+            }
+            duckdb_appender_destroy(&appender);
+            appender = nullptr;
+        }
+
+        if (stmt != nullptr) {
+            duckdb_destroy_prepare(&stmt);
+            stmt = nullptr;
+        }
+        return finalized;
+    }
+
+
+public: // insert column
+    /**
+     * @brief bind null to the column
+     * @return true if binded; otherwise, false.
+     */
+    bool bindNull(int index) {
+        if (isAppender()) {
+            cellAt(index).kind = Cell::Kind::NUL;
+            return true;
+        }
+        return checkBind(duckdb_bind_null(stmt, index), "duckdb_bind_null", index);
+    }
+
+    /**
+     * @brief bind bool type to the BOOLEAN column
+     * @return true if binded; otherwise, false.
+     */
+    bool bindColumn(int index, bool *value) {
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::BOOL;
+            c.i = *value;
+            return true;
+        }
+        return checkBind(duckdb_bind_boolean(stmt, index, *value), "duckdb_bind_boolean", index);
+    }
+
+    /**
+     * @brief bind to 32B integer type
+     *   the size of T should be less than or equal to int
+     *      (unsigned) char, (unsigned) short, (unsigned) int
+     * @return true if binded; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && (sizeof(T) <= sizeof(int)), bool>
+        bindColumn(int index, T *value) {
+        const int32_t v = static_cast<int32_t>(*value);
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::INT32;
+            c.i = v;
+            return true;
+        }
+        return checkBind(duckdb_bind_int32(stmt, index, v), "duckdb_bind_int32", index);
+    }
+
+    /**
+     * @brief bind to 64B integer type
+     *   the size of T should be greater than int: enable_if
+     *      (unsigned) long, (unsigned) long long
+     * @return true if binded; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && (sizeof(T) > sizeof(int)), bool>
+        bindColumn(int index, T *value) {
+        const int64_t v = static_cast<int64_t>(*value);
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::INT64;
+            c.i = v;
+            return true;
+        }
+        return checkBind(duckdb_bind_int64(stmt, index, v), "duckdb_bind_int64", index);
+    }
+
+    /**
+     * @brief bind double type
+     *     float, double, long double
+     * @return true if binded; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, bool>
+        bindColumn(int index, T *value) {
+        const double v = static_cast<double>(*value);
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::DOUBLE;
+            c.d = v;
+            return true;
+        }
+        return checkBind(duckdb_bind_double(stmt, index, v), "duckdb_bind_double", index);
+    }
+
+    /**
+     * @brief bind string type
+     * @return true if binded; otherwise, false.
+     */
+    bool bindColumn(int index, std::string *value) {
+        return bindText(index, value->data(), value->size());
+    }
+    bool bindColumn(int index, const char *value) {
+        return bindText(index, value, std::strlen(value));
+    }
+
+    /**
+     * @brief bind wstring type, stored as UTF-8 text
+     * @return true if binded; otherwise, false.
+     */
+    bool bindColumn(int index, std::wstring *value) {
+        return bindColumn(index, value->c_str());
+    }
+    bool bindColumn(int index, const wchar_t *value) {
+        const std::string utf8 = encodeUtf8(value, std::wcslen(value));
+        return bindText(index, utf8.data(), utf8.size());
+    }
+
+
+    /**
+     * @brief bind vector of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        bindColumn(int index, std::vector<E, Alloc> *value) {
+        return bindBlob(index, value->data(), value->size());
+    }
+
+    /**
+     * @brief bind std::array of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        bindColumn(int index, std::array<E, N> *value) {
+        return bindBlob(index, value->data(), N);
+    }
+
+    /**
+     * @brief bind the elements to the blob column, the bytes are copied by DuckDB.
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E>
+    bool bindBlob(int index, const E *data, size_t n) {
+        const size_t bytes = n * sizeof(E);
+        std::vector<unsigned char> buf;
+        const void *p = data;
+        if constexpr (BlobLayout::need_swap) {
+            buf.resize(bytes);
+            if (n > 0)
+                BlobLayout::encode(data, n, buf.data());
+            p = buf.data();
+        }
+
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::BLOB;
+            c.s.assign(static_cast<const char*>(p), bytes);
+            return true;
+        }
+        return checkBind(duckdb_bind_blob(stmt, index, p, bytes), "duckdb_bind_blob", index);
+    }
+
+
+    /**
+     * @brief bind the column and execute the SQL statement,
+     *     or append the bound row in the appender mode.
+     * @return true if inserted; otherwise, false.
+     */
+    bool bindStep() {
+        if (isAppender()) {
+            return appendRow();
+        }
+
+        duckdb_result res;
+        bool stepped = (duckdb_execute_prepared(stmt, &res) == DuckDBSuccess);
+        if (!stepped) {
+            std::cerr << "DbStatementImpl::bindStep: duckdb_execute_prepared failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&res), "Failed to execute SQL statement");
+        } else {
+            last_changes = duckdb_rows_changed(&res);
+        }
+        duckdb_destroy_result(&res);
+        return stepped;
+    }
+
+
+public: // schema info
+    /**
+     * @brief Get the column count of the statement, the statement is executed if not yet.
+     * @return The column count.
+     */
+    int getColumnCount() {
+        return executeResult() ? static_cast<int>(duckdb_column_count(&result)) : 0;
+    }
+
+    /**
+     * @brief Get the column type of the statement.
+     * @param index The column index
+     * @return The column type of duckdb_type.
+     */
+    int getColumnType(int index) {
+        return executeResult() ? static_cast<int>(col_types.at(index)) : DUCKDB_TYPE_INVALID;
+    }
+
+    /**
+     * @brief Get the column name of the statement.
+     * @param index The column index
+     * @return The column name.
+     */
+    const char *getColumnName(int index) {
+        return executeResult() ? duckdb_column_name(&result, index) : nullptr;
+    }
+
+    /**
+     * @brief Get the column type name of the statement.
+     * @param index The column index
+     * @return The type name, such as "INTEGER"; nullptr if not a scalar type.
+     */
+    const char *getColumnDeclType(int index) {
+        if (!executeResult()) return nullptr;
+
+        switch (col_types.at(index)) {
+        case DUCKDB_TYPE_BOOLEAN:   return "BOOLEAN";
+        case DUCKDB_TYPE_TINYINT:   return "TINYINT";
+        case DUCKDB_TYPE_SMALLINT:  return "SMALLINT";
+        case DUCKDB_TYPE_INTEGER:   return "INTEGER";
+        case DUCKDB_TYPE_BIGINT:    return "BIGINT";
+        case DUCKDB_TYPE_UTINYINT:  return "UTINYINT";
+        case DUCKDB_TYPE_USMALLINT: return "USMALLINT";
+        case DUCKDB_TYPE_UINTEGER:  return "UINTEGER";
+        case DUCKDB_TYPE_UBIGINT:   return "UBIGINT";
+        case DUCKDB_TYPE_FLOAT:     return "FLOAT";
+        case DUCKDB_TYPE_DOUBLE:    return "DOUBLE";
+        case DUCKDB_TYPE_VARCHAR:   return "VARCHAR";
+        case DUCKDB_TYPE_BLOB:      return "BLOB";
+        default:                    return nullptr;
+        } // switch
+    }
+
+
+public: // fetch column
+    /**
+     * @brief move to the next row, the next chunk is fetched if the current one is consumed.
+     * @return true if the next row exists; otherwise, false.
+     */
+    bool fetchStep() {
+        if (!executeResult()) {
+            return false;
+        }
+
+        if ((chunk != nullptr) && (++row < chunk_size)) {
+            return true;
+        }
+
+        // fetch the next non-empty chunk
+        while (true) {
+            if (chunk != nullptr) {
+                duckdb_destroy_data_chunk(&chunk);
+                chunk = nullptr;
+            }
+
+            chunk = duckdb_fetch_chunk(result);
+            if (chunk == nullptr) {
+                chunk_size = 0;
+                return false;
+            }
+
+            row = 0;
+            chunk_size = duckdb_data_chunk_get_size(chunk);
+            if (chunk_size > 0) {
+                return true;
+            }
+        } // while
+    }
+
+    /**
+     * @brief try to fetch null from the column using the column index.
+     * @param index The column index.
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchNull(int index) {
+        uint64_t *validity = duckdb_vector_get_validity(vectorAt(index));
+        return (validity != nullptr) && !duckdb_validity_row_is_valid(validity, row);
+    } // fetchNull
+
+    /**
+     * @brief fetch integer and floating point type,
+     *     the value is converted from the column type.
+     * @return true if fetched; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>, bool>
+        fetchColumn(int index, T *value) {
+        return readNumber(index, value);
+    }
+
+    /**
+     * @brief fetch string type
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchColumn(int index, std::string *value) {
+        const char *p = nullptr; size_t bytes = 0;
+        fetchText(index, &p, &bytes);
+        value->assign(p, bytes);
+        return true;
+    }
+    bool fetchColumn(int index, const char **value) {
+        fetchColumn(index, &text_buf);
+        *value = text_buf.c_str();
+        return true;
+    }
+
+    /**
+     * @brief fetch the raw bytes of the text/blob column without copy,
+     *     the bytes are valid until the next chunk or finalize.
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchText(int index, const char **value, size_t *bytes) {
+        auto *s = static_cast<duckdb_string_t*>(duckdb_vector_get_data(vectorAt(index))) + row;
+        *bytes = s->value.inlined.length;
+        *value = (*bytes <= sizeof(s->value.inlined.inlined)) ?
+            s->value.inlined.inlined : s->value.pointer.ptr;
+        return true;
+    }
+    bool fetchBlob(int index, const void **value, size_t *bytes) {
+        const char *p = nullptr;
+        fetchText(index, &p, bytes);
+        *value = p;
+        return true;
+    }
+
+    /**
+     * @brief fetch wstring type from UTF-8 text
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchColumn(int index, std::wstring *value) {
+        const char *p = nullptr; size_t bytes = 0;
+        fetchText(index, &p, &bytes);
+        *value = decodeUtf8(p, bytes);
+        return true;
+    }
+    bool fetchColumn(int index, const wchar_t **value) {
+        fetchColumn(index, &wtext_buf);
+        *value = wtext_buf.c_str();
+        return true;
+    }
+
+    /**
+     * @brief fetch vector of POD from the blob column
+     * @return true if fetched; false if the blob size is not a multiple of the element size.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        fetchColumn(int index, std::vector<E, Alloc> *value) {
+        const void *bin = nullptr; size_t bytes = 0;
+        fetchBlob(index, &bin, &bytes);
+        if (bytes % sizeof(E) != 0) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
+
+        value->resize(bytes / sizeof(E));
+        if (bytes > 0)
+            BlobLayout::decode(static_cast<const unsigned char*>(bin), value->size(), value->data());
+        return true;
+    }
+
+    /**
+     * @brief fetch std::array of POD from the blob column
+     * @return true if fetched; false if the blob size is not the array size.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        fetchColumn(int index, std::array<E, N> *value) {
+        const void *bin = nullptr; size_t bytes = 0;
+        fetchBlob(index, &bin, &bytes);
+        if (bytes != N * sizeof(E)) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
+
+        if (bytes > 0)
+            BlobLayout::decode(static_cast<const unsigned char*>(bin), N, value->data());
+        return true;
+    }
+
+
+private: // utility functions
+    /**
+     * @brief execute the statement once to get the result for fetch.
+     * @return true if the result is available; otherwise, false.
+     */
+    bool executeResult() {
+        if (executed) {
+            return true;
+        }
+
+        if (stmt == nullptr) {
+            std::cerr << "DbStatementImpl::executeResult: statement is not prepared" << std::endl;
+            return false;
+        }
+
+        if (duckdb_execute_prepared(stmt, &result) != DuckDBSuccess) {
+            std::cerr << "DbStatementImpl::executeResult: duckdb_execute_prepared failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_result_error(&result), "Failed to execute SQL statement");
+            duckdb_destroy_result(&result);
+            return false;
+        }
+
+        const idx_t n = duckdb_column_count(&result);
+        col_types.resize(n);
+        for (idx_t i = 0; i < n; ++i) {
+            col_types[i] = duckdb_column_type(&result, i);
+        }
+
+        executed = true;
+        chunk = nullptr;
+        chunk_size = row = 0;
+        return true;
+    } // executeResult
+
+    /**
+     * @brief release the chunk and the result.
+     */
+    void closeResult() {
+        if (chunk != nullptr) {
+            duckdb_destroy_data_chunk(&chunk);
+            chunk = nullptr;
+        }
+        if (executed) {
+            duckdb_destroy_result(&result);
+            executed = false;
+        }
+        chunk_size = row = 0;
+    } // closeResult
+
+    duckdb_vector vectorAt(int index) {
+        return duckdb_data_chunk_get_vector(chunk, index);
+    }
+
+    /**
+     * @brief read the number of the current row, converted from the column type.
+     */
+    template <typename V>
+    bool readNumber(int index, V *value) {
+        const void *data = duckdb_vector_get_data(vectorAt(index));
+        switch (col_types.at(index)) {
+        case DUCKDB_TYPE_BOOLEAN:   *value = static_cast<V>(static_cast<const bool    *>(data)[row]); break;
+        case DUCKDB_TYPE_TINYINT:   *value = static_cast<V>(static_cast<const int8_t  *>(data)[row]); break;
+        case DUCKDB_TYPE_SMALLINT:  *value = static_cast<V>(static_cast<const int16_t *>(data)[row]); break;
+        case DUCKDB_TYPE_INTEGER:   *value = static_cast<V>(static_cast<const int32_t *>(data)[row]); break;
+        case DUCKDB_TYPE_BIGINT:    *value = static_cast<V>(static_cast<const int64_t *>(data)[row]); break;
+        case DUCKDB_TYPE_UTINYINT:  *value = static_cast<V>(static_cast<const uint8_t *>(data)[row]); break;
+        case DUCKDB_TYPE_USMALLINT: *value = static_cast<V>(static_cast<const uint16_t*>(data)[row]); break;
+        case DUCKDB_TYPE_UINTEGER:  *value = static_cast<V>(static_cast<const uint32_t*>(data)[row]); break;
+        case DUCKDB_TYPE_UBIGINT:   *value = static_cast<V>(static_cast<const uint64_t*>(data)[row]); break;
+        case DUCKDB_TYPE_FLOAT:     *value = static_cast<V>(static_cast<const float   *>(data)[row]); break;
+        case DUCKDB_TYPE_DOUBLE:    *value = static_cast<V>(static_cast<const double  *>(data)[row]); break;
+        default:
+            std::cerr << "DbStatementImpl::fetchColumn: column " << index
+                << " is not a number" << std::endl;
+            return false;
+        } // switch
+        return true;
+    } // readNumber
+
+    bool bindText(int index, const char *data, size_t bytes) {
+        if (isAppender()) {
+            Cell &c = cellAt(index);
+            c.kind = Cell::Kind::TEXT;
+            c.s.assign(data, bytes);
+            return true;
+        }
+        return checkBind(duckdb_bind_varchar_length(stmt, index, data, bytes),
+            "duckdb_bind_varchar_length", index);
+    } // bindText
+
+    bool checkBind(duckdb_state rc, const char *func, int index) {
+        if (rc != DuckDBSuccess) {
+            std::cerr << "DbStatementImpl::bindColumn: " << func << " failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_prepare_error(stmt),
+                "Failed to bind column at index " + std::to_string(index));
+        }
+        return (rc == DuckDBSuccess);
+    } // checkBind
+
+    Cell &cellAt(int index) {
+        if (cells.size() < static_cast<size_t>(index)) {
+            cells.resize(index);
+        }
+        return cells[index - 1];
+    } // cellAt
+
+    /**
+     * @brief append the buffered row to the appender in the column order.
+     * @return true if appended; otherwise, false.
+     */
+    bool appendRow() {
+        duckdb_state rc = DuckDBSuccess;
+        for (auto &c : cells) {
+            switch (c.kind) {
+            case Cell::Kind::NUL:    rc = duckdb_append_null  (appender); break;
+            case Cell::Kind::BOOL:   rc = duckdb_append_bool  (appender, c.i != 0); break;
+            case Cell::Kind::INT32:  rc = duckdb_append_int32 (appender, static_cast<int32_t>(c.i)); break;
+            case Cell::Kind::INT64:  rc = duckdb_append_int64 (appender, c.i); break;
+            case Cell::Kind::DOUBLE: rc = duckdb_append_double(appender, c.d); break;
+            case Cell::Kind::TEXT:   rc = duckdb_append_varchar_length(appender, c.s.data(), c.s.size()); break;
+            case Cell::Kind::BLOB:   rc = duckdb_append_blob  (appender, c.s.data(), c.s.size()); break;
+            } // switch
+            if (rc != DuckDBSuccess) break;
+        } // for
+        cells.clear();
+
+        rc = (rc == DuckDBSuccess) ? duckdb_appender_end_row(appender) : rc;
+        if (rc != DuckDBSuccess) {
+            std::cerr << "DbStatementImpl::bindStep: duckdb_appender_end_row failed!" << std::endl;
+            EDADB_DUCKDB_LOG_ERROR(duckdb_appender_error(appender), "Failed to append row");
+            return false;
+        }
+
+        last_changes = 1;
+        return true;
+    } // appendRow
+}; // DbStatementImpl
+
+} // namespace edadb
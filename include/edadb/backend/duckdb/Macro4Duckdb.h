@@ -0,0 +1,70 @@
+/**
+ * @file Macro4Duckdb.h
+ * @brief Macro4Duckdb.h provides a macro for DuckDB
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <assert.h>
+#include <duckdb.h>
+
+#include "edadb/DbError.h"
+
+namespace edadb {
+
+/**
+ * @brief map the DuckDB error message to DbErrorCode by the error type in the message,
+ *     since the prepare, result and appender errors are all returned as the message only,
+ *     and the appender wraps the error, such as "Failed to append: Duplicate key ...".
+ *     The write-write conflict of the concurrent transactions is BUSY,
+ *     the transaction is rolled back and can be retried.
+ * @param err The error message, nullptr if the handle is invalid.
+ */
+inline DbErrorCode duckdbErrorCode(const char *err) {
+    if (err == nullptr) {
+        return DbErrorCode::MISUSE;
+    }
+
+    const std::string msg(err);
+    auto has = [&msg](const char *s) { return msg.find(s) != std::string::npos; };
+    if (has("TransactionContext Error") && has("onflict")) {
+        return DbErrorCode::BUSY;
+    }
+    if (has("Constraint Error") || has("constraint")) {
+        return DbErrorCode::CONSTRAINT;
+    }
+    if (has("Catalog Error")) {
+        return DbErrorCode::NOT_FOUND;
+    }
+    if (has("IO Error") || has("Out of Memory Error")) {
+        return DbErrorCode::IO;
+    }
+    return DbErrorCode::ERROR;
+}
+
+} // namespace edadb
+
+/**
+ * @macro EDADB_DUCKDB_LOG_ERROR
+ * @brief Macro to log DuckDB errors with the error message
+ * @param err The error message from DuckDB, such as duckdb_prepare_error
+ * @param msg The custom message to log
+ * @note This macro will print the custom message and error message to std::cerr,
+ *     and keep the error for edadb::lastError(). Only the API misuse asserts,
+ *     the conflict and constraint errors are returned to the caller.
+ */
+#define EDADB_DUCKDB_LOG_ERROR(err, msg)                            \
+    do {                                                            \
+        const char *edadb_duckdb_err_ = (err);                      \
+        const edadb::DbErrorCode edadb_duckdb_code_ =               \
+            edadb::duckdbErrorCode(edadb_duckdb_err_);              \
+        std::cerr << "DuckDB Error: " << (msg) << ". Errmsg: "      \
+                  << (edadb_duckdb_err_ ? edadb_duckdb_err_ : "Unknown error") \
+                  << std::endl;                                     \
+        edadb::setLastError(edadb_duckdb_code_, 0,                  \
+            std::string(msg) + ": " +                               \
+            (edadb_duckdb_err_ ? edadb_duckdb_err_ : "Unknown error")); \
+        assert(edadb_duckdb_code_ != edadb::DbErrorCode::MISUSE);   \
+    } while (0)
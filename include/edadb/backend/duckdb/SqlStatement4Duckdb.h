@@ -0,0 +1,96 @@
+/***
+ * @file SqlStatement4Duckdb.h
+ * @brief SqlStatement4Duckdb.h generates the DuckDB SQL statement for the given type.
+ */
+
+#pragma once
+
+#include <string>
+#include <cctype>
+
+#include "edadb/Config.h"
+#include "edadb/SqlStatement.h"
+#include "edadb/backend/sqlite/SqlStatement4Sqlite.h"
+
+namespace edadb {
+
+/**
+ * @class SqlStatement
+ * @brief This class generates the DuckDB SQL statement for the given type.
+ *     DuckDB accepts the same statements as Sqlite3 except the foreign key actions,
+ *     so the statements are inherited and only the differences are overridden.
+ * @tparam T The class type.
+ */
+template<typename T>
+struct SqlStatementImpl<DbBackendType::DUCKDB, T> : public SqlStatementImpl<DbBackendType::SQLITE, T> {
+public:
+    /**
+     * DuckDB does not support ON DELETE CASCADE,
+     * the child rows are deleted by deleteOrphanStatement after the parent rows.
+     */
+    static constexpr bool cascade_foreign_key = false;
+
+public:
+    /**
+     * @brief create the table statement without the foreign key constraint:
+     *     DuckDB rejects the cascade actions and the update of the referenced rows,
+     *     the foreign key column is kept to group the child rows.
+     * @param this_fkc  this foreign key constraint.
+     * @param work_fkc  work foreign key constraint.
+     * @return The create table statement.
+     */
+    static std::string createTableStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        std::string sql =
+            SqlStatementImpl<DbBackendType::SQLITE, T>::createTableStatement(this_fkc, work_fkc);
+        if (this_fkc.valid()) {
+            const size_t pos = sql.rfind(", FOREIGN KEY (");
+            assert(pos != std::string::npos);
+            sql = sql.substr(0, pos) + ");";
+        }
+        return sql;
+    } // createTableStatement
+
+
+    /**
+     * @brief Check if the type of the column on disk is the generated one,
+     *     DuckDB reports the type by its canonical name, such as VARCHAR for TEXT.
+     * @param disk_type The type read from the table
+     * @param def_type The type generated by SqlStatement
+     * @return true if the same type; otherwise, false.
+     */
+    static bool sameColumnType(const std::string& disk_type, const std::string& def_type) {
+        auto canonical = [](std::string t) {
+            for (auto &c : t) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            const size_t paren = t.find('(');
+            if (paren != std::string::npos) t.resize(paren); // VARCHAR(n), DECIMAL(p,s)
+
+            if ((t == "TEXT") || (t == "STRING") || (t == "CHAR") || (t == "BPCHAR")) return std::string("VARCHAR");
+            if ((t == "INT") || (t == "INT4") || (t == "SIGNED")) return std::string("INTEGER");
+            if ((t == "INT8") || (t == "LONG")) return std::string("BIGINT");
+            if ((t == "INT2") || (t == "SHORT")) return std::string("SMALLINT");
+            if (t == "INT1") return std::string("TINYINT");
+            if (t == "BOOL") return std::string("BOOLEAN");
+            if ((t == "FLOAT4") || (t == "REAL")) return std::string("FLOAT");
+            if (t == "FLOAT8") return std::string("DOUBLE");
+            if ((t == "BINARY") || (t == "VARBINARY") || (t == "BYTEA")) return std::string("BLOB");
+            return t;
+        };
+        return canonical(disk_type) == canonical(def_type);
+    } // sameColumnType
+
+
+    /**
+     * @brief Generate the statement deleting the child rows whose parent row is deleted.
+     * @param this_fkc this foreign key constraint, must be valid.
+     * @return The delete statement.
+     */
+    static std::string deleteOrphanStatement(const ForeignKeyConstraint& this_fkc) {
+        assert(this_fkc.valid());
+        return "DELETE FROM \"" + this_fkc.fore_tab_name + "\" WHERE "
+            + this_fkc.fore_col_name + " NOT IN (SELECT " + this_fkc.prim_col_name
+            + " FROM \"" + this_fkc.prim_tab_name + "\");";
+    } // deleteOrphanStatement
+}; // SqlStatementImpl
+
+} // namespace edadb
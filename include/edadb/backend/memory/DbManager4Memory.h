@@ -0,0 +1,426 @@
+/**
+ * @file DbManager4Memory.h
+ * @brief DbManager4Memory.h provides a way to manage the tables of the memory backend.
+ *      The memory backend keeps the tables in the process without SQL and persistence,
+ *      for the unit tests and the hot-cache workloads.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <unordered_map>
+#include <future>
+#include <chrono>
+#include <stdint.h>
+
+#include "Macro4Memory.h"
+
+#include "edadb/Config.h"
+#include "edadb/Singleton.h"
+#include "edadb/SqlTrace.h"
+
+#include "edadb/DbBackendType.h"
+#include "edadb/DbStatement.h"
+#include "edadb/backend/memory/MemStore.h"
+#include "edadb/backend/memory/DbStatement4Memory.h"
+#include "edadb/DbManager.h"
+
+namespace edadb {
+
+/**
+ * @class DbManager
+ * @brief This class manages the tables of the memory backend.
+ *    One database per manager, the connection is the database itself.
+ *    The database is not synchronized: the parallel readers are safe only if no writer is running.
+ */
+template<>
+class DbManagerImpl<DbBackendType::MEMORY> :
+        public Singleton< DbManagerImpl<DbBackendType::MEMORY> > {
+private:
+    /**
+     * @brief friend class for Singleton pattern.
+     */
+    friend class Singleton< DbManagerImpl<DbBackendType::MEMORY> >;
+
+public:
+    // database connection handler type
+    using Connection = MemDatabase*;
+
+protected:
+    std::string connect_param; // database name, only for isConnected
+    std::atomic<uint64_t> connect_gen{0}; // bumped on close, see connectGeneration
+    MemDatabase database;      // the tables
+    std::unordered_map<std::string, std::string> schema_fps; // schema fingerprint per root table
+
+public:
+    // bind parameter index starts from 1 as sqlite3
+    static const uint32_t s_bind_column_begin_index = 1;
+
+    // fetch column index starts from 0 as sqlite3
+    static const uint32_t s_read_column_begin_index = 0;
+
+    // the rowid key inserted as NULL is assigned by MemDatabase as sqlite3
+    static const bool s_assign_rowid_key = true;
+
+    // SAVEPOINT and RELEASE are parsed by MemPlan as sqlite3
+    static const bool s_has_savepoint = true;
+
+public:
+    /**
+     * @brief ctor of the database owned by a Database handle,
+     *     the default database is the Singleton DbManager::i().
+     */
+    DbManagerImpl(void) = default;
+
+    /**
+     * @brief dtor closes the database, the DbMap bound to it must be destroyed before.
+     */
+    ~DbManagerImpl() {
+        close();
+    }
+
+    DbManagerImpl(const DbManagerImpl &) = delete;
+    DbManagerImpl &operator=(const DbManagerImpl &) = delete;
+
+
+public: // database operation
+    /**
+     * @brief Get the database connection parameter.
+     * @return connected status.
+     */
+    bool isConnected() const {
+        return !connect_param.empty();
+    }
+
+    /**
+     * @brief Get the generation of the connection, bumped on close,
+     *     the read connections kept across the reads are stale if opened in another generation.
+     */
+    uint64_t connectGeneration() const {
+        return connect_gen.load();
+    }
+
+
+    /**
+     * @brief Connect to the empty database, the tables are dropped on close.
+     * @param c The database name, nothing is opened.
+     * @return true if connected; otherwise, false.
+     */
+    bool connect(const std::string &c = "edadb.memory") {
+        if (isConnected()) {
+            return true;
+        }
+
+        database.clear();
+        connect_param = c.empty() ? std::string("edadb.memory") : c;
+        return true;
+    } // connect
+
+
+    /**
+     * @brief Execute the statement without binding, such as create table and transaction.
+     * @param sql The plan generated by SqlStatement4Memory.h or the transaction statement.
+     * @return true if executed; otherwise, false.
+     */
+    bool exec(const std::string &sql) {
+        if (SqlTrace::traced()) {
+            SqlTrace::i().record(sql);
+        }
+
+        MemPlan plan;
+        std::string err;
+        bool executed = plan.parse(sql, err);
+        if (executed) {
+            executed = database.exec(plan);
+            err = database.error();
+        }
+
+        if (!executed) {
+            std::cerr << "DbManager4Memory::exec failed!" << std::endl;
+            EDADB_MEMORY_LOG_ERROR(err, "Failed to execute SQL: " + sql);
+        } // if
+        return executed;
+    } // exec
+
+
+    /**
+     * @brief close the database, all tables are dropped.
+     *     The statements must be finalized before.
+     * @return true if closed; otherwise, false.
+    */
+    bool close() {
+        ++connect_gen;
+        database.clear();
+        schema_fps.clear();
+        connect_param.clear();
+        return true;
+    } // close
+
+
+    /**
+     * @brief Check if a table exists in the database.
+     * @param name The table name.
+     * @return true if exists; otherwise, false.
+     */
+    bool tableExists(std::string name) {
+        if (name.empty()) return false;
+        return (database.table(name) != nullptr);
+    } // tableExists
+
+
+    /**
+     * @brief Read the schema fingerprint stored for the root table,
+     *     kept with the tables and dropped on close.
+     * @param name The root table name.
+     * @param fp The fingerprint.
+     * @return true if found; otherwise, false.
+     */
+    bool readSchemaFingerprint(const std::string &name, std::string &fp) {
+        auto it = schema_fps.find(name);
+        if (it == schema_fps.end()) return false;
+        fp = it->second;
+        return true;
+    } // readSchemaFingerprint
+
+    bool writeSchemaFingerprint(const std::string &name, const std::string &fp) {
+        schema_fps[name] = fp;
+        return true;
+    } // writeSchemaFingerprint
+
+
+    /**
+     * @brief Get the columns of the table.
+     * @param name The table name.
+     * @param names The column names in the table order.
+     * @param types The column types.
+     * @return true if the table exists; otherwise, false.
+     */
+    bool tableColumns(const std::string &name,
+            std::vector<std::string> &names, std::vector<std::string> &types) {
+        const MemTable *tab = database.table(name);
+        if (tab == nullptr) return false;
+        names = tab->cols;
+        types = tab->types;
+        return true;
+    } // tableColumns
+
+
+    /**
+     * @brief The tables live in the process only, so the schema never changes under them.
+     * @return false.
+     */
+    bool rebuildTable(const std::string &name, const std::string &tmp_name,
+            const std::string &create_sql, const std::vector<std::string> &copy_cols) {
+        (void)tmp_name;
+        (void)create_sql;
+        (void)copy_cols;
+        std::cerr << "DbManager4Memory::rebuildTable: not supported for " << name << std::endl;
+        return false;
+    }
+
+
+    /**
+     * @brief Get the rowid range of the table, used to partition the table scan.
+     * @param name The table name.
+     * @param lo The min rowid.
+     * @param hi The max rowid.
+     * @param conn The connection to query, nullptr for the main connection.
+     * @return true if the table is not empty; otherwise, false.
+     */
+    bool rowidRange(const std::string &name, int64_t &lo, int64_t &hi, Connection conn = nullptr) {
+        (void)conn;
+        const MemTable *tab = database.table(name);
+        if ((tab == nullptr) || (tab->live == 0)) {
+            return false;
+        }
+
+        const int64_t n = static_cast<int64_t>(tab->rows.size());
+        lo = 1;
+        while (!tab->alive[lo - 1]) ++lo;
+        hi = n;
+        while (!tab->alive[hi - 1]) --hi;
+        return true;
+    } // rowidRange
+
+
+    /**
+     * @brief The query plan is not explained in the backend.
+     * @return false.
+     */
+    bool explainQueryPlan(const std::string &sql, std::vector<std::string> &details) {
+        (void)sql;
+        details.clear();
+        std::cerr << "DbManager4Memory::explainQueryPlan: not supported" << std::endl;
+        return false;
+    }
+
+
+public: // in-memory database
+    /**
+     * @brief The memory backend has no persistence, use the sqlite3 backend instead.
+     * @return false.
+     */
+    bool connectInMemory(const std::string &file) {
+        std::cerr << "DbManager4Memory::connectInMemory: not supported, "
+            << "use connect() without loading " << file << std::endl;
+        return false;
+    }
+
+    // never connected by connectInMemory, no file to save back
+    bool isInMemory() const {
+        return false;
+    }
+
+    bool save(int pages_per_step = Config::backup_pages_per_step) {
+        (void)pages_per_step;
+        std::cerr << "DbManager4Memory::save: not supported" << std::endl;
+        return false;
+    }
+
+    std::future<bool> saveAsync(int pages_per_step = Config::backup_pages_per_step) {
+        return std::async(std::launch::deferred,
+            [this, pages_per_step] { return save(pages_per_step); });
+    }
+
+    bool startAutoSave(std::chrono::milliseconds interval) {
+        (void)interval;
+        std::cerr << "DbManager4Memory::startAutoSave: not supported" << std::endl;
+        return false;
+    }
+
+    void stopAutoSave() {}
+
+
+public: // read connections for parallel read
+    /**
+     * @brief The connection is the database itself, shared by the threads.
+     * @return true if connected; otherwise, false.
+     */
+    bool canOpenReadConnection() const {
+        return isConnected();
+    }
+
+    /**
+     * @brief Get the connection to read the database in another thread,
+     *     safe only if no writer is running at the same time.
+     * @return The connection handler; nullptr if failed.
+     */
+    Connection openReadConnection() {
+        if (!isConnected()) {
+            std::cerr << "DbManager4Memory::openReadConnection: not connected" << std::endl;
+            return nullptr;
+        }
+        return &database;
+    } // openReadConnection
+
+    /**
+     * @brief Close the connection opened by openReadConnection, nothing to release.
+     * @param conn The connection handler.
+     * @return true if closed; otherwise, false.
+     */
+    bool closeReadConnection(Connection conn) {
+        (void)conn;
+        return true;
+    } // closeReadConnection
+
+
+    /**
+     * @brief Connect without the reader pool, WAL mode is sqlite only:
+     *     the memory backend has no journal.
+     * @return true if connected; otherwise, false.
+     */
+    bool connectWal(const std::string &c,
+            size_t readers = Config::wal_reader_connections,
+            std::chrono::milliseconds checkpoint_interval =
+                std::chrono::milliseconds(Config::wal_checkpoint_interval_ms)) {
+        (void)readers;
+        (void)checkpoint_interval;
+        return connect(c);
+    } // connectWal
+
+    bool isWal() const {
+        return false;
+    }
+
+    /**
+     * @brief No reader pool, the Readers use the main connection.
+     */
+    Connection acquireReadConnection() {
+        return nullptr;
+    }
+
+    void releaseReadConnection(Connection conn) {
+        (void)conn;
+    }
+
+    /**
+     * @brief Checkpoint, nothing to write back.
+     * @return true if success; otherwise, false.
+     */
+    bool checkpoint() {
+        return true;
+    }
+
+    /**
+     * @brief The read connections are the database itself, no transaction to begin.
+     */
+    bool beginSnapshot(const std::vector<Connection> &conns) {
+        (void)conns;
+        return isConnected();
+    }
+
+    bool endSnapshot(const std::vector<Connection> &conns) {
+        (void)conns;
+        return true;
+    }
+
+
+
+public: // statement operation
+    /**
+     * @brief Initialize the statement
+     * @param stmt The memory backend statement
+     * @param conn The connection to run the statement, nullptr for the main connection
+     * @return true if initialized; otherwise, false
+     */
+    bool initStatement(DbStatementImpl<DbBackendType::MEMORY> &dbstmt,
+            Connection conn = nullptr) {
+        dbstmt.db = (conn != nullptr) ? conn : &database;
+        dbstmt.prepared = false;
+        return true;
+    } // initStatement
+
+    /**
+     * @brief check the number of rows changed by the last statement.
+     * @return The number of rows changed.
+     */
+    int changes() {
+        return database.changes();
+    }
+
+    /**
+     * @brief Get the rowid of the last row inserted.
+     * @param conn The connection inserted on, nullptr for the database.
+     * @return The rowid, the key of the rowid key table; 0 if none inserted.
+     */
+    int64_t lastInsertRowid(Connection conn = nullptr) {
+        return ((conn != nullptr) ? conn : &database)->lastInsertRowid();
+    }
+
+    /**
+     * @brief The rowid key is assigned by MemDatabase on insert, see s_assign_rowid_key.
+     * @return false.
+     */
+    bool nextRowidKey(const std::string &name, const std::string &col, int64_t &key) {
+        (void)col;
+        (void)key;
+        std::cerr << "DbManager4Memory::nextRowidKey: assigned on insert for " << name << std::endl;
+        return false;
+    }
+}; // DbManagerImpl<DbBackendType::MEMORY>
+
+} // namespace edadb
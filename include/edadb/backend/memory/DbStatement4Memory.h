@@ -0,0 +1,659 @@
+/***
+ * @file DbStatement4Memory.h
+ * @brief DbStatement4Memory.h provides a way to run the statement of the memory backend.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cwchar>
+#include <iostream>
+#include <algorithm>
+
+#include "edadb/DbBackendType.h"
+#include "edadb/DbStatement.h"
+#include "edadb/TraitUtils.h"
+#include "edadb/BlobLayout.h"
+#include "edadb/Utf8.h"
+#include "edadb/SqlTrace.h"
+#include "MemStore.h"
+#include "Macro4Memory.h"
+
+
+namespace edadb {
+
+/**
+ * @struct DbStatement
+ * @brief This struct holds the plan of the memory backend, the bound values and the result rows.
+ *     The select plan is evaluated on the first fetchStep into the rowids of the result,
+ *     the columns are read from the table rows in place.
+ */
+template <>
+struct DbStatementImpl<DbBackendType::MEMORY> {
+    // no appender, insert by the prepared insert plan
+    static constexpr bool has_appender = false;
+
+    // the tables of the memory backend
+    MemDatabase *db = nullptr;
+
+    // the prepared plan and its table
+    MemPlan  plan;
+    MemTable *tab = nullptr;
+    bool     prepared = false;
+
+    // bound values, the index starts from 1 as the sqlite3 place holders
+    std::vector<MemValue> params;
+
+    // the result of the select plan and the row under the cursor
+    std::vector<int64_t> result;
+    std::vector<int32_t> proj;
+    bool                 evaluated = false;
+    size_t               cursor = 0;
+    const MemRow         *cur = nullptr;
+
+    // wide text buffer returned by fetchColumn(const wchar_t**), valid until the next fetch
+    std::wstring wtext_buf;
+
+public:
+    DbStatementImpl () = default;
+    ~DbStatementImpl() = default;
+
+public:
+    inline bool invalidDb     () { return (db == nullptr); }
+    inline bool stmtIsNull    () { return !prepared; }
+    inline bool stmtIsPrepared() { return prepared; }
+
+    /**
+     * @brief prepare the plan generated by SqlStatement4Memory.h
+     */
+    bool prepare(const std::string &sql) {
+        if (invalidDb()) {
+            std::cerr << "DbStatementImpl::prepare: invalid database" << std::endl;
+            return false;
+        }
+
+        if (stmtIsPrepared()) {
+            std::cerr << "DbStatementImpl::prepare: statement is already prepared" << std::endl;
+            return false;
+        }
+
+        if (SqlTrace::traced()) {
+            SqlTrace::i().record(sql);
+        }
+
+        plan = MemPlan();
+        std::string err;
+        if (!plan.parse(sql, err)) {
+            std::cerr << "DbStatementImpl::prepare: parse failed!" << std::endl;
+            EDADB_MEMORY_LOG_ERROR(err, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        tab = nullptr;
+        const bool row_op = (plan.op == MemPlan::Op::INSERT) || (plan.op == MemPlan::Op::UPDATE) ||
+            (plan.op == MemPlan::Op::DELETE) || (plan.op == MemPlan::Op::SELECT);
+        if (row_op && ((tab = db->table(plan.table)) == nullptr)) {
+            std::cerr << "DbStatementImpl::prepare: no such table!" << std::endl;
+            EDADB_MEMORY_LOG_ERROR(plan.table, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        proj.clear();
+        if (plan.op == MemPlan::Op::SELECT) {
+            for (auto &c : plan.proj) {
+                const int32_t idx = tab->columnIndex(c);
+                if (idx < 0) {
+                    std::cerr << "DbStatementImpl::prepare: no such column!" << std::endl;
+                    EDADB_MEMORY_LOG_ERROR(c, "Failed to prepare SQL: " + sql);
+                    return false;
+                }
+                proj.push_back(idx);
+            }
+            if (proj.empty()) {
+                for (size_t c = 0; c < tab->cols.size(); ++c) proj.push_back(static_cast<int32_t>(c));
+            }
+            if (!plan.order_col.empty() && (tab->columnIndex(plan.order_col) < 0)) {
+                std::cerr << "DbStatementImpl::prepare: no such order column!" << std::endl;
+                EDADB_MEMORY_LOG_ERROR(plan.order_col, "Failed to prepare SQL: " + sql);
+                return false;
+            }
+        }
+
+        params.clear();
+        closeResult();
+        prepared = true;
+        return true;
+    }
+
+    /**
+     * @brief no slow query log in the backend, the label is ignored.
+     */
+    void setLabel(const std::string &, const char *) {}
+
+    /**
+     * @brief no appender in the memory backend, use prepare with the insert plan instead
+     * @return false.
+     */
+    bool prepareAppend(const std::string &table) {
+        std::cerr << "DbStatementImpl::prepareAppend: not supported, table " << table << std::endl;
+        return false;
+    }
+
+    /**
+     * @brief clear all of the binding placeholder in the statement
+     * @return true if cleared; otherwise, false.
+     */
+    bool clearBindings() {
+        std::fill(params.begin(), params.end(), MemValue());
+        return true;
+    }
+
+    /**
+     * @brief reset the statement, the bound values are kept
+     * @return true if reseted; otherwise, false.
+     */
+    bool reset() {
+        closeResult();
+        return true;
+    }
+
+    /**
+     * @brief finalize the statement
+     * @return true if finalized; otherwise, false.
+     */
+    bool finalize() {
+        closeResult();
+        params.clear();
+        proj.clear();
+        tab = nullptr;
+        prepared = false;
+        return true;
+    }
+
+
+public: // insert column
+    /**
+     * @brief bind null to the column
+     * @return true if binded; otherwise, false.
+     */
+    bool bindNull(int index) {
+        paramAt(index) = MemValue();
+        return true;
+    }
+
+    /**
+     * @brief bind integer type
+     *   bool, (unsigned) char, (unsigned) short, (unsigned) int, (unsigned) long (long)
+     * @return true if binded; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, bool>
+        bindColumn(int index, T *value) {
+        paramAt(index) = MemValue::ofInt(static_cast<int64_t>(*value));
+        return true;
+    }
+
+    /**
+     * @brief bind double type
+     *     float, double, long double
+     * @return true if binded; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, bool>
+        bindColumn(int index, T *value) {
+        paramAt(index) = MemValue::ofReal(static_cast<double>(*value));
+        return true;
+    }
+
+    /**
+     * @brief bind string type
+     * @return true if binded; otherwise, false.
+     */
+    bool bindColumn(int index, std::string *value) {
+        paramAt(index) = MemValue::ofText(value->data(), value->size());
+        return true;
+    }
+    bool bindColumn(int index, const char *value) {
+        paramAt(index) = MemValue::ofText(value, std::strlen(value));
+        return true;
+    }
+
+    /**
+     * @brief bind wstring type, stored as UTF-8 text
+     * @return true if binded; otherwise, false.
+     */
+    bool bindColumn(int index, std::wstring *value) {
+        return bindColumn(index, value->c_str());
+    }
+    bool bindColumn(int index, const wchar_t *value) {
+        const std::string utf8 = encodeUtf8(value, std::wcslen(value));
+        paramAt(index) = MemValue::ofText(utf8.data(), utf8.size());
+        return true;
+    }
+
+
+    /**
+     * @brief bind vector of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        bindColumn(int index, std::vector<E, Alloc> *value) {
+        return bindBlob(index, value->data(), value->size());
+    }
+
+    /**
+     * @brief bind std::array of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        bindColumn(int index, std::array<E, N> *value) {
+        return bindBlob(index, value->data(), N);
+    }
+
+    /**
+     * @brief bind the elements to the blob column, the bytes are copied in the blob layout.
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E>
+    bool bindBlob(int index, const E *data, size_t n) {
+        MemValue &v = paramAt(index);
+        v = MemValue::ofBlob(nullptr, 0);
+        v.s.resize(n * sizeof(E));
+        if (n > 0) {
+            BlobLayout::encode(data, n, reinterpret_cast<unsigned char*>(&v.s[0]));
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief execute the insert, update or delete plan with the bound values.
+     *     The update plan binds all columns and then the key to update.
+     * @return true if executed; otherwise, false.
+     */
+    bool bindStep() {
+        if (!prepared) {
+            std::cerr << "DbStatementImpl::bindStep: statement is not prepared" << std::endl;
+            return false;
+        }
+
+        int changes = 0;
+        bool stepped = true;
+        switch (plan.op) {
+        case MemPlan::Op::INSERT:
+            stepped = (db->insertRow(*tab, boundRow()) > 0);
+            changes = stepped ? 1 : 0;
+            break;
+        case MemPlan::Op::UPDATE:
+        case MemPlan::Op::DELETE: {
+            const bool update = (plan.op == MemPlan::Op::UPDATE);
+            const MemValue &key = paramAt(update ? static_cast<int>(tab->cols.size()) + 1 : 1);
+            const std::vector<int64_t> *ids = tab->findKey(key);
+            const std::vector<int64_t> copy = (ids != nullptr) ? *ids : std::vector<int64_t>();
+            for (size_t k = 0; stepped && (k < copy.size()); ++k) {
+                stepped = update ?
+                    db->updateRow(*tab, copy[k], boundRow()) : db->deleteRow(*tab, copy[k]);
+                changes += stepped ? 1 : 0;
+            }
+            break;
+        }
+        case MemPlan::Op::SELECT:
+            std::cerr << "DbStatementImpl::bindStep: use fetchStep to run the select plan" << std::endl;
+            return false;
+        default:
+            stepped = db->exec(plan);
+            break;
+        } // switch
+
+        if (!stepped) {
+            std::cerr << "DbStatementImpl::bindStep: step failed!" << std::endl;
+            EDADB_MEMORY_LOG_ERROR(db->error(), "Failed to step SQL statement");
+        }
+        db->setChanges(changes);
+        return stepped;
+    }
+
+
+public: // schema info
+    /**
+     * @brief Get the column count of the statement.
+     * @return The column count.
+     */
+    int getColumnCount() {
+        return static_cast<int>(proj.size());
+    }
+
+    /**
+     * @brief Get the storage kind of the column value in the current row.
+     * @param index The column index
+     * @return The MemValue::Kind of the value.
+     */
+    int getColumnType(int index) {
+        return static_cast<int>(value(index).kind);
+    }
+
+    /**
+     * @brief Get the column name of the statement.
+     * @param index The column index
+     * @return The column name.
+     */
+    const char *getColumnName(int index) {
+        return tab->cols.at(proj.at(index)).c_str();
+    }
+
+    /**
+     * @brief Get the declared column type of the statement.
+     * @param index The column index
+     * @return The declared type, such as "INTEGER".
+     */
+    const char *getColumnDeclType(int index) {
+        return tab->types.at(proj.at(index)).c_str();
+    }
+
+
+public: // fetch column
+    /**
+     * @brief move to the next row, the select plan is evaluated at the first row.
+     * @return true if the next row exists; otherwise, false.
+     */
+    bool fetchStep() {
+        if (!prepared || (plan.op != MemPlan::Op::SELECT)) {
+            std::cerr << "DbStatementImpl::fetchStep: select plan is not prepared" << std::endl;
+            return false;
+        }
+
+        if (!evaluated) {
+            evaluate();
+        }
+
+        // skip the rows deleted since the evaluation
+        while (cursor < result.size()) {
+            const int64_t rowid = result[cursor++];
+            if (tab->isAlive(rowid)) {
+                cur = &tab->row(rowid);
+                return true;
+            }
+        }
+        cur = nullptr;
+        return false;
+    }
+
+    /**
+     * @brief try to fetch null from the column using the column index.
+     * @param index The column index.
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchNull(int index) {
+        return value(index).isNull();
+    } // fetchNull
+
+    /**
+     * @brief fetch integer type
+     * @return true if fetched; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, bool>
+        fetchColumn(int index, T *value) {
+        *value = static_cast<T>(this->value(index).asInt());
+        return true;
+    }
+
+    /**
+     * @brief fetch double type
+     *  float, double, long double
+     * @return true if fetched; otherwise, false.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, bool>
+        fetchColumn(int index, T *value) {
+        *value = static_cast<T>(this->value(index).asReal());
+        return true;
+    }
+
+    /**
+     * @brief fetch string type
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchColumn(int index, std::string *value) {
+        const MemValue &v = this->value(index);
+        if ((v.kind == MemValue::Kind::TEXT) || (v.kind == MemValue::Kind::BLOB)) {
+            value->assign(v.s);
+        } else {
+            *value = v.isNull() ? std::string() : v.asText();
+        }
+        return true;
+    }
+    bool fetchColumn(int index, const char **value) {
+        size_t bytes = 0;
+        return fetchText(index, value, &bytes);
+    }
+
+    /**
+     * @brief fetch the raw bytes of the text/blob column without copy,
+     *     the bytes are valid until the row is changed.
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchText(int index, const char **value, size_t *bytes) {
+        const MemValue &v = this->value(index);
+        *value = v.s.c_str();
+        *bytes = v.s.size();
+        return true;
+    }
+    bool fetchBlob(int index, const void **value, size_t *bytes) {
+        const MemValue &v = this->value(index);
+        *value = v.s.data();
+        *bytes = v.s.size();
+        return true;
+    }
+
+    /**
+     * @brief fetch wstring type from UTF-8 text
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchColumn(int index, std::wstring *value) {
+        const MemValue &v = this->value(index);
+        *value = decodeUtf8(v.s.data(), v.s.size());
+        return true;
+    }
+    bool fetchColumn(int index, const wchar_t **value) {
+        fetchColumn(index, &wtext_buf);
+        *value = wtext_buf.c_str();
+        return true;
+    }
+
+    /**
+     * @brief fetch vector of POD from the blob column
+     * @return true if fetched; false if the blob size is not a multiple of the element size.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        fetchColumn(int index, std::vector<E, Alloc> *value) {
+        const std::string &bin = this->value(index).s;
+        if (bin.size() % sizeof(E) != 0) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bin.size() << std::endl;
+            return false;
+        }
+
+        value->resize(bin.size() / sizeof(E));
+        if (!bin.empty())
+            BlobLayout::decode(reinterpret_cast<const unsigned char*>(bin.data()),
+                value->size(), value->data());
+        return true;
+    }
+
+    /**
+     * @brief fetch std::array of POD from the blob column
+     * @return true if fetched; false if the blob size is not the array size.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        fetchColumn(int index, std::array<E, N> *value) {
+        const std::string &bin = this->value(index).s;
+        if (bin.size() != N * sizeof(E)) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bin.size() << std::endl;
+            return false;
+        }
+
+        if (!bin.empty())
+            BlobLayout::decode(reinterpret_cast<const unsigned char*>(bin.data()), N, value->data());
+        return true;
+    }
+
+
+private: // utility functions
+    MemValue &paramAt(int index) {
+        if (static_cast<size_t>(index) >= params.size()) {
+            params.resize(index + 1);
+        }
+        return params[index];
+    }
+
+    const MemValue &value(int index) const {
+        return (*cur)[proj.at(index)];
+    }
+
+    /**
+     * @brief the row of the bound values in the table column order.
+     */
+    MemRow boundRow() {
+        const size_t n = tab->cols.size();
+        paramAt(static_cast<int>(n));
+        return MemRow(params.begin() + 1, params.begin() + 1 + n);
+    }
+
+    void closeResult() {
+        result.clear();
+        evaluated = false;
+        cursor = 0;
+        cur = nullptr;
+    }
+
+    /**
+     * @brief evaluate the select plan to the rowids of the result:
+     *     filter by WHERE, sort by ORDER then the key, and cut by LIMIT.
+     *   The bound values are the WHERE values followed by the LIMIT.
+     */
+    void evaluate() {
+        evaluated = true;
+        cursor = 0;
+        result.clear();
+
+        int bind = 1;
+        auto appendIds = [this](const std::vector<int64_t> *ids) {
+            if (ids != nullptr) result.insert(result.end(), ids->begin(), ids->end());
+        };
+
+        // order key: (column, key) in the plan direction, the NULL columns come last in both orders
+        const int32_t ocol = plan.order_col.empty() ? 0 : tab->columnIndex(plan.order_col);
+        const int dir = plan.desc ? -1 : 1;
+        auto before = [this, ocol, dir](int64_t a, int64_t b) {
+            const MemRow &ra = tab->row(a), &rb = tab->row(b);
+            if (ra[ocol].isNull() != rb[ocol].isNull()) {
+                return rb[ocol].isNull();
+            }
+            int c = MemValue::compare(ra[ocol], rb[ocol]);
+            if ((c == 0) && (ocol != 0)) c = MemValue::compare(ra[0], rb[0]);
+            return (c == 0) ? (a < b) : (c * dir < 0);
+        };
+
+        switch (plan.where) {
+        case MemPlan::Where::ALL:
+            scanAll([](const MemRow &) { return true; });
+            break;
+        case MemPlan::Where::KEY:
+            appendIds(tab->findKey(paramAt(bind++)));
+            break;
+        case MemPlan::Where::KEYS: {
+            // "IN (...)": each key once, in the key order, NULL never matches
+            std::vector<MemValue> keys;
+            for (size_t k = 0; k < plan.nkeys; ++k) {
+                const MemValue &v = paramAt(bind++);
+                if (!v.isNull()) keys.push_back(v);
+            }
+            std::sort(keys.begin(), keys.end(),
+                [](const MemValue &a, const MemValue &b) { return MemValue::compare(a, b) < 0; });
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            for (auto &k : keys) appendIds(tab->findKey(k));
+            break;
+        }
+        case MemPlan::Where::FK:
+            if (tab->fk_col >= 0) appendIds(tab->findForeignKey(paramAt(bind++)));
+            break;
+        case MemPlan::Where::ROWID: {
+            const int64_t lo = std::max<int64_t>(paramAt(bind++).asInt(), 1);
+            const int64_t hi = std::min<int64_t>(paramAt(bind++).asInt(),
+                static_cast<int64_t>(tab->rows.size()));
+            for (int64_t id = lo; id <= hi; ++id) {
+                if (tab->alive[id - 1]) result.push_back(id);
+            }
+            break;
+        }
+        case MemPlan::Where::AFTER: {
+            // seek after (column, key) of the last row of the previous page,
+            // the NULL columns are read by the NULL run
+            MemValue col_after;
+            if (ocol != 0) col_after = paramAt(bind++);
+            const MemValue key_after = paramAt(bind++);
+            scanAll([&](const MemRow &r) {
+                if ((ocol != 0) && r[ocol].isNull()) return false;
+                int c = (ocol != 0) ? MemValue::compare(r[ocol], col_after) : 0;
+                if (c == 0) c = MemValue::compare(r[0], key_after);
+                return c * dir > 0;
+            });
+            break;
+        }
+        case MemPlan::Where::NOT_NULL:
+            scanAll([&](const MemRow &r) { return !r[ocol].isNull(); });
+            break;
+        case MemPlan::Where::NULL_RUN:
+            scanAll([&](const MemRow &r) { return r[ocol].isNull(); });
+            break;
+        case MemPlan::Where::NULL_AFTER: {
+            // seek after the key of the last row in the NULL columns
+            const MemValue key_after = paramAt(bind++);
+            scanAll([&](const MemRow &r) {
+                return r[ocol].isNull() && (MemValue::compare(r[0], key_after) * dir > 0);
+            });
+            break;
+        }
+        } // switch
+
+        const bool ordered = !plan.order_col.empty();
+        size_t limit = result.size();
+        if (plan.limit) {
+            const int64_t n = paramAt(bind++).asInt();
+            limit = (n < 0) ? result.size() : std::min<size_t>(static_cast<size_t>(n), result.size());
+        }
+
+        if (plan.snapshot_order) {
+            // group the child rows by the foreign key, rowid order in each group
+            if (tab->fk_col >= 0) {
+                const int32_t fk = tab->fk_col;
+                std::stable_sort(result.begin(), result.end(), [this, fk](int64_t a, int64_t b) {
+                    return MemValue::compare(tab->row(a)[fk], tab->row(b)[fk]) < 0;
+                });
+            }
+        } else if (ordered && (limit < result.size())) {
+            std::partial_sort(result.begin(), result.begin() + limit, result.end(), before);
+        } else if (ordered) {
+            std::sort(result.begin(), result.end(), before);
+        }
+        result.resize(limit);
+    } // evaluate
+
+    template <typename Pred>
+    void scanAll(Pred pred) {
+        result.reserve(tab->live);
+        for (size_t r = 0; r < tab->rows.size(); ++r) {
+            if (tab->alive[r] && pred(tab->rows[r])) {
+                result.push_back(static_cast<int64_t>(r + 1));
+            }
+        }
+    }
+}; // DbStatementImpl
+
+} // namespace edadb
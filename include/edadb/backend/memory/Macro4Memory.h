@@ -0,0 +1,31 @@
+/**
+ * @file Macro4Memory.h
+ * @brief Macro4Memory.h provides a macro for the memory backend
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "edadb/DbError.h"
+
+/**
+ * @macro EDADB_MEMORY_LOG_ERROR
+ * @brief Macro to log the memory backend errors with the error message
+ * @param err The error message from MemDatabase::error
+ * @param msg The custom message to log
+ * @note This macro will print the custom message and error message to std::cerr,
+ *     and keep the error for edadb::lastError(). The errors are returned to the caller,
+ *     such as the constraint violation and the plan not supported by the memory backend.
+ */
+#define EDADB_MEMORY_LOG_ERROR(err, msg)                            \
+    do {                                                            \
+        const std::string edadb_memory_err_ = (err);                \
+        std::cerr << "Memory Error: " << (msg) << ". Errmsg: "      \
+                  << edadb_memory_err_ << std::endl;                \
+        edadb::setLastError(                                        \
+            (edadb_memory_err_.find("constraint failed") != std::string::npos) ? \
+                edadb::DbErrorCode::CONSTRAINT : edadb::DbErrorCode::ERROR, \
+            0, std::string(msg) + ": " + edadb_memory_err_);        \
+    } while (0)
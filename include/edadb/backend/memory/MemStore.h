@@ -0,0 +1,854 @@
+/**
+ * @file MemStore.h
+ * @brief MemStore.h provides the in-process tables of the memory backend:
+ *     the rows are kept in memory and indexed by hash tables on the primary key and the foreign key,
+ *     the statements are plans generated by SqlStatement4Memory.h instead of SQL.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+
+
+namespace edadb {
+
+/**
+ * @struct MemValue
+ * @brief The value of a column, typed as sqlite3 storage classes.
+ */
+struct MemValue {
+    enum class Kind : uint8_t { NUL = 0, INT, REAL, TEXT, BLOB };
+
+    Kind        kind = Kind::NUL;
+    int64_t     i = 0;
+    double      d = 0;
+    std::string s;     // TEXT or BLOB bytes
+
+public:
+    static MemValue ofInt (int64_t v) { MemValue m; m.kind = Kind::INT;  m.i = v; return m; }
+    static MemValue ofReal(double  v) { MemValue m; m.kind = Kind::REAL; m.d = v; return m; }
+    static MemValue ofText(const char *p, size_t n) {
+        MemValue m; m.kind = Kind::TEXT; m.s.assign(p, n); return m;
+    }
+    static MemValue ofBlob(const void *p, size_t n) {
+        MemValue m; m.kind = Kind::BLOB; m.s.assign(static_cast<const char*>(p), n); return m;
+    }
+
+public:
+    bool isNull() const { return kind == Kind::NUL; }
+    bool isNumber() const { return (kind == Kind::INT) || (kind == Kind::REAL); }
+
+    int64_t asInt() const {
+        switch (kind) {
+        case Kind::INT:  return i;
+        case Kind::REAL: return static_cast<int64_t>(d);
+        case Kind::TEXT: return std::strtoll(s.c_str(), nullptr, 10);
+        default:         return 0;
+        }
+    }
+
+    double asReal() const {
+        switch (kind) {
+        case Kind::INT:  return static_cast<double>(i);
+        case Kind::REAL: return d;
+        case Kind::TEXT: return std::strtod(s.c_str(), nullptr);
+        default:         return 0;
+        }
+    }
+
+    /**
+     * @brief the text of the value, numbers are rendered as sqlite3 does.
+     */
+    std::string asText() const {
+        if (kind == Kind::INT) {
+            return std::to_string(i);
+        }
+        if (kind == Kind::REAL) {
+            std::ostringstream os;
+            os.precision(15);
+            os << d;
+            return os.str();
+        }
+        return s;
+    }
+
+    /**
+     * @brief compare as sqlite3: NULL < numbers < TEXT < BLOB, text by bytes.
+     * @return <0, 0, >0 as a is less than, equal to, greater than b.
+     */
+    static int compare(const MemValue &a, const MemValue &b) {
+        const int ra = a.rank(), rb = b.rank();
+        if (ra != rb) {
+            return ra < rb ? -1 : 1;
+        }
+
+        switch (a.kind) {
+        case Kind::NUL:
+            return 0;
+        case Kind::INT:
+        case Kind::REAL:
+            if ((a.kind == Kind::INT) && (b.kind == Kind::INT)) {
+                return (a.i < b.i) ? -1 : (a.i > b.i);
+            } else {
+                const double x = a.asReal(), y = b.asReal();
+                return (x < y) ? -1 : (x > y);
+            }
+        default: {
+            const int c = a.s.compare(b.s);
+            return (c < 0) ? -1 : (c > 0);
+        }
+        } // switch
+    } // compare
+
+    bool operator==(const MemValue &o) const { return compare(*this, o) == 0; }
+    bool operator!=(const MemValue &o) const { return compare(*this, o) != 0; }
+
+private:
+    int rank() const {
+        return (kind == Kind::NUL) ? 0 : isNumber() ? 1 : (kind == Kind::TEXT) ? 2 : 3;
+    }
+}; // MemValue
+
+
+/**
+ * @struct MemValueHash
+ * @brief hash consistent with MemValue::compare, integral reals hash as integers.
+ */
+struct MemValueHash {
+    size_t operator()(const MemValue &v) const {
+        switch (v.kind) {
+        case MemValue::Kind::INT:
+            return std::hash<int64_t>()(v.i);
+        case MemValue::Kind::REAL: {
+            const int64_t i = static_cast<int64_t>(v.d);
+            return (static_cast<double>(i) == v.d) ?
+                std::hash<int64_t>()(i) : std::hash<double>()(v.d);
+        }
+        case MemValue::Kind::TEXT:
+        case MemValue::Kind::BLOB:
+            return std::hash<std::string>()(v.s);
+        default:
+            return 0;
+        }
+    }
+}; // MemValueHash
+
+
+using MemRow   = std::vector<MemValue>;
+using MemIndex = std::unordered_map<MemValue, std::vector<int64_t>, MemValueHash>;
+
+
+/**
+ * @struct MemTable
+ * @brief The rows of a table, addressed by rowid starting from 1.
+ *     The deleted rows are tombstones, so the rowid of a row never changes.
+ *     The first column is indexed as the key, the foreign key column is indexed to group the child rows,
+ *     the rowids in each index entry are kept in ascending order.
+ *     The integer key of the rowid key table inserted as NULL is assigned the max key + 1 as sqlite3 does.
+ */
+struct MemTable {
+    enum class Affinity : uint8_t { INTEGER, REAL, TEXT, NONE };
+
+    std::string              name;
+    std::vector<std::string> cols;
+    std::vector<std::string> types;
+    std::vector<Affinity>    affinity;
+    bool                     has_pk = false;
+    bool                     rowid_key = false; // the key is assigned if inserted as NULL
+    int64_t                  max_key = 0;       // the max integer key of the rowid key table
+
+    // foreign key column referencing the first column of the parent table
+    int32_t                  fk_col = -1;
+    std::string              ref_table;
+    std::vector<std::string> children; // names of the tables referencing this table
+
+    std::vector<MemRow>  rows;
+    std::vector<uint8_t> alive;
+    size_t               live = 0;
+
+    MemIndex key_index;
+    MemIndex fk_index;
+
+public:
+    /**
+     * @brief get the column index by name.
+     * @return the column index; -1 if not found.
+     */
+    int32_t columnIndex(const std::string &col) const {
+        for (size_t c = 0; c < cols.size(); ++c) {
+            if (cols[c] == col) return static_cast<int32_t>(c);
+        }
+        return -1;
+    }
+
+    bool isAlive(int64_t rowid) const {
+        return (rowid >= 1) && (static_cast<size_t>(rowid) <= rows.size()) && alive[rowid - 1];
+    }
+
+    const MemRow &row(int64_t rowid) const { return rows[rowid - 1]; }
+
+    /**
+     * @brief get the rowids of the key or foreign key value.
+     * @return the rowids in ascending order; nullptr if not found.
+     */
+    const std::vector<int64_t> *findKey(const MemValue &v) const {
+        auto it = key_index.find(v);
+        return (it == key_index.end()) ? nullptr : &it->second;
+    }
+    const std::vector<int64_t> *findForeignKey(const MemValue &v) const {
+        auto it = fk_index.find(v);
+        return (it == fk_index.end()) ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief convert the value to the column affinity as sqlite3 does.
+     */
+    void applyAffinity(size_t c, MemValue &v) const {
+        if ((affinity[c] == Affinity::INTEGER) && (v.kind == MemValue::Kind::REAL)) {
+            const int64_t i = static_cast<int64_t>(v.d);
+            if (static_cast<double>(i) == v.d) {
+                v = MemValue::ofInt(i);
+            }
+        } else if ((affinity[c] == Affinity::REAL) && (v.kind == MemValue::Kind::INT)) {
+            v = MemValue::ofReal(static_cast<double>(v.i));
+        }
+    }
+
+    static Affinity affinityOf(std::string t) {
+        for (auto &ch : t) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        auto has = [&t](const char *s) { return t.find(s) != std::string::npos; };
+        if (has("INT") || has("BOOL"))                 return Affinity::INTEGER;
+        if (has("CHAR") || has("CLOB") || has("TEXT")) return Affinity::TEXT;
+        if (t.empty() || has("BLOB") || has("BINARY")) return Affinity::NONE;
+        return Affinity::REAL;
+    }
+
+public: // index maintenance
+    void indexAdd(int64_t rowid, const MemRow &r) {
+        if (rowid_key && (r[0].kind == MemValue::Kind::INT)) {
+            max_key = std::max(max_key, r[0].i);
+        }
+        insertSorted(key_index[r[0]], rowid);
+        if (fk_col >= 0) {
+            insertSorted(fk_index[r[fk_col]], rowid);
+        }
+    }
+
+    void indexRemove(int64_t rowid, const MemRow &r) {
+        eraseFrom(key_index, r[0], rowid);
+        if (fk_col >= 0) {
+            eraseFrom(fk_index, r[fk_col], rowid);
+        }
+    }
+
+private:
+    static void insertSorted(std::vector<int64_t> &ids, int64_t rowid) {
+        if (ids.empty() || (ids.back() < rowid)) {
+            ids.push_back(rowid);
+        } else {
+            ids.insert(std::lower_bound(ids.begin(), ids.end(), rowid), rowid);
+        }
+    }
+
+    static void eraseFrom(MemIndex &index, const MemValue &v, int64_t rowid) {
+        auto it = index.find(v);
+        if (it == index.end()) return;
+
+        auto &ids = it->second;
+        auto pos = std::lower_bound(ids.begin(), ids.end(), rowid);
+        if ((pos != ids.end()) && (*pos == rowid)) {
+            ids.erase(pos);
+        }
+        if (ids.empty()) {
+            index.erase(it);
+        }
+    }
+}; // MemTable
+
+
+/**
+ * @struct MemPlan
+ * @brief The statement of the memory backend, parsed from the text generated by SqlStatement4Memory.h:
+ *     CREATE tab PK=0|1|ROWID [FK=col:parent] COLS=c1:TYPE,c2:TYPE,...
+ *     INDEX tab
+ *     INSERT tab | UPDATE tab | DELETE tab
+ *     SELECT tab [COLS=c1,c2] [WHERE=KEY|KEYS:n|FK|ROWID|AFTER|NOT_NULL|NULL|NULL_AFTER]
+ *         [ORDER=col:ASC|DESC|SNAPSHOT] [LIMIT], the NULL order columns come last in both orders,
+ *   and the transaction statements in SQL:
+ *     BEGIN [TRANSACTION] | COMMIT | END | ROLLBACK [TO [SAVEPOINT] name] | SAVEPOINT name |
+ *     RELEASE [SAVEPOINT] name | DROP TABLE [IF EXISTS] tab
+ */
+struct MemPlan {
+    enum class Op : uint8_t {
+        NONE, CREATE, DROP, INDEX, INSERT, UPDATE, DELETE, SELECT,
+        BEGIN, COMMIT, ROLLBACK, SAVEPOINT, RELEASE, ROLLBACK_TO
+    };
+    enum class Where : uint8_t { ALL, KEY, KEYS, FK, ROWID, AFTER, NOT_NULL, NULL_RUN, NULL_AFTER };
+
+    Op          op = Op::NONE;
+    std::string table;   // table name, or savepoint name
+
+    // CREATE
+    std::vector<std::string> cols, types;
+    bool        pk = false;
+    bool        rowid_key = false; // PK=ROWID
+    std::string fk_col, ref_table;
+
+    // SELECT
+    std::vector<std::string> proj; // empty for all columns
+    Where       where = Where::ALL;
+    size_t      nkeys = 0;
+    std::string order_col;         // empty for no order
+    bool        desc = false;
+    bool        snapshot_order = false;
+    bool        limit = false;
+
+public:
+    /**
+     * @brief parse the statement text.
+     * @param text The statement text.
+     * @param err The error message if failed.
+     * @return true if parsed; otherwise, false.
+     */
+    bool parse(const std::string &text, std::string &err) {
+        std::vector<std::string> tok = tokenize(text);
+        if (tok.empty()) {
+            err = "empty statement";
+            return false;
+        }
+
+        const std::string kw = upper(tok[0]);
+        auto arg = [&tok](size_t i) { return (i < tok.size()) ? tok[i] : std::string(); };
+
+        if (kw == "BEGIN") {
+            op = Op::BEGIN;
+        } else if ((kw == "COMMIT") || (kw == "END")) {
+            op = Op::COMMIT;
+        } else if (kw == "ROLLBACK") {
+            op = Op::ROLLBACK;
+            if ((tok.size() > 1) && (upper(tok[1]) == "TO")) {
+                op = Op::ROLLBACK_TO;
+                table = (upper(arg(2)) == "SAVEPOINT") ? arg(3) : arg(2);
+            }
+        } else if (kw == "SAVEPOINT") {
+            op = Op::SAVEPOINT;
+            table = arg(1);
+        } else if (kw == "RELEASE") {
+            op = Op::RELEASE;
+            table = (upper(arg(1)) == "SAVEPOINT") ? arg(2) : arg(1);
+        } else if (kw == "DROP") {
+            op = Op::DROP;
+            size_t i = 1;
+            if (upper(arg(i)) == "TABLE") ++i;
+            if ((upper(arg(i)) == "IF") && (upper(arg(i + 1)) == "EXISTS")) i += 2;
+            table = arg(i);
+        } else if (kw == "CREATE") {
+            op = Op::CREATE;
+            table = arg(1);
+        } else if (kw == "INDEX") {
+            op = Op::INDEX;
+            table = arg(1);
+        } else if (kw == "INSERT") {
+            op = Op::INSERT;
+            table = arg(1);
+        } else if (kw == "UPDATE") {
+            op = Op::UPDATE;
+            table = arg(1);
+        } else if (kw == "DELETE") {
+            op = Op::DELETE;
+            table = arg(1);
+        } else if (kw == "SELECT") {
+            op = Op::SELECT;
+            table = arg(1);
+        } else {
+            err = "unsupported statement: " + text;
+            return false;
+        }
+
+        if (table.empty() && (op != Op::BEGIN) && (op != Op::COMMIT) && (op != Op::ROLLBACK)) {
+            err = "missing name: " + text;
+            return false;
+        }
+
+        // options: KEY=VALUE
+        for (size_t i = 2; i < tok.size(); ++i) {
+            if ((op != Op::CREATE) && (op != Op::SELECT)) break;
+
+            const std::string &t = tok[i];
+            const size_t eq = t.find('=');
+            const std::string key = upper(t.substr(0, eq));
+            const std::string val = (eq == std::string::npos) ? "" : t.substr(eq + 1);
+
+            if (key == "PK") {
+                rowid_key = (upper(val) == "ROWID");
+                pk = (val == "1") || rowid_key;
+            } else if (key == "FK") {
+                const size_t c = val.find(':');
+                fk_col = val.substr(0, c);
+                ref_table = (c == std::string::npos) ? "" : val.substr(c + 1);
+            } else if ((key == "COLS") && (op == Op::CREATE)) {
+                for (auto &ct : split(val, ',')) {
+                    const size_t c = ct.find(':');
+                    cols.push_back(ct.substr(0, c));
+                    types.push_back((c == std::string::npos) ? "" : ct.substr(c + 1));
+                }
+            } else if (key == "COLS") {
+                proj = split(val, ',');
+            } else if (key == "WHERE") {
+                const std::string w = upper(val);
+                if (w == "KEY")                 where = Where::KEY;
+                else if (w.rfind("KEYS:", 0) == 0) {
+                    where = Where::KEYS;
+                    nkeys = std::strtoul(w.c_str() + 5, nullptr, 10);
+                }
+                else if (w == "FK")             where = Where::FK;
+                else if (w == "ROWID")          where = Where::ROWID;
+                else if (w == "AFTER")          where = Where::AFTER;
+                else if (w == "NOT_NULL")       where = Where::NOT_NULL;
+                else if (w == "NULL")           where = Where::NULL_RUN;
+                else if (w == "NULL_AFTER")     where = Where::NULL_AFTER;
+                else {
+                    err = "unsupported WHERE: " + val;
+                    return false;
+                }
+            } else if (key == "ORDER") {
+                if (upper(val) == "SNAPSHOT") {
+                    snapshot_order = true;
+                } else {
+                    const auto opts = split(val, ':');
+                    order_col = opts.empty() ? "" : opts.front();
+                    desc = (opts.size() > 1) && (upper(opts[1]) == "DESC");
+                }
+            } else if (key == "LIMIT") {
+                limit = true;
+            } else {
+                err = "unsupported option: " + t;
+                return false;
+            }
+        } // for
+
+        return true;
+    } // parse
+
+private:
+    static std::string upper(std::string s) {
+        for (auto &c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    static std::vector<std::string> split(const std::string &s, char sep) {
+        std::vector<std::string> out;
+        size_t b = 0;
+        while (b <= s.size()) {
+            size_t e = s.find(sep, b);
+            if (e == std::string::npos) e = s.size();
+            if (e > b) out.push_back(s.substr(b, e - b));
+            b = e + 1;
+        }
+        return out;
+    }
+
+    /**
+     * @brief split by spaces, drop the trailing ';' and the quotes of the names.
+     */
+    static std::vector<std::string> tokenize(const std::string &text) {
+        std::vector<std::string> out;
+        std::string cur;
+        for (char c : text) {
+            if (std::isspace(static_cast<unsigned char>(c)) || (c == ';')) {
+                if (!cur.empty()) out.push_back(std::move(cur));
+                cur.clear();
+            } else if (c != '"') {
+                cur += c;
+            }
+        }
+        if (!cur.empty()) out.push_back(std::move(cur));
+        return out;
+    }
+}; // MemPlan
+
+
+/**
+ * @class MemDatabase
+ * @brief The tables of the memory backend.
+ *     The rows changed in a transaction are recorded in the undo log to roll back,
+ *     the child rows are deleted and updated with the parent row as ON DELETE/UPDATE CASCADE.
+ *     Not synchronized: the concurrent readers are safe only without writer.
+ */
+class MemDatabase {
+private:
+    std::unordered_map<std::string, MemTable> tables;
+
+    struct Undo {
+        enum class Kind : uint8_t { INSERT, DELETE, UPDATE };
+        Kind     kind;
+        MemTable *tab;
+        int64_t  rowid;
+        MemRow   old_row;
+    };
+    std::vector<Undo> undo_log;
+    bool in_txn = false;
+    std::vector<std::pair<std::string, size_t>> savepoints; // name, undo log size
+
+    std::string last_error;
+    int         last_changes = 0;
+    int64_t     last_insert_rowid = 0;
+
+public:
+    const std::string &error() const { return last_error; }
+
+    // number of rows changed by the last statement, the cascaded rows are not counted
+    int  changes() const { return last_changes; }
+    void setChanges(int n) { last_changes = n; }
+
+    // the rowid of the last row inserted, the key of the rowid key table as sqlite3
+    int64_t lastInsertRowid() const { return last_insert_rowid; }
+
+    MemTable *table(const std::string &name) {
+        auto it = tables.find(name);
+        return (it == tables.end()) ? nullptr : &it->second;
+    }
+
+    void clear() {
+        tables.clear();
+        undo_log.clear();
+        savepoints.clear();
+        in_txn = false;
+    }
+
+
+public: // schema
+    /**
+     * @brief execute the statement without binding: schema and transaction.
+     * @return true if success; otherwise, false.
+     */
+    bool exec(const MemPlan &p) {
+        switch (p.op) {
+        case MemPlan::Op::CREATE:      return createTable(p);
+        case MemPlan::Op::DROP:        return dropTable(p.table);
+        case MemPlan::Op::INDEX:       return true; // hash indexed already, sort on demand
+        case MemPlan::Op::BEGIN:       return begin();
+        case MemPlan::Op::COMMIT:      return commit();
+        case MemPlan::Op::ROLLBACK:    return rollback();
+        case MemPlan::Op::SAVEPOINT:   return savepoint(p.table);
+        case MemPlan::Op::RELEASE:     return release(p.table);
+        case MemPlan::Op::ROLLBACK_TO: return rollbackTo(p.table);
+        default:
+            return fail("statement needs binding, use the statement instead");
+        }
+    } // exec
+
+    bool createTable(const MemPlan &p) {
+        if (tables.count(p.table) > 0) {
+            return true; // IF NOT EXISTS
+        }
+        if (p.cols.empty()) {
+            return fail("no column in table " + p.table);
+        }
+
+        MemTable tab;
+        tab.name   = p.table;
+        tab.cols   = p.cols;
+        tab.types  = p.types;
+        tab.has_pk = p.pk;
+        tab.rowid_key = p.rowid_key;
+        for (auto &t : p.types) {
+            tab.affinity.push_back(MemTable::affinityOf(t));
+        }
+
+        if (!p.fk_col.empty()) {
+            MemTable *parent = table(p.ref_table);
+            tab.fk_col = tab.columnIndex(p.fk_col);
+            if ((parent == nullptr) || (tab.fk_col < 0)) {
+                return fail("invalid foreign key " + p.fk_col + " of table " + p.table);
+            }
+            tab.ref_table = p.ref_table;
+            parent->children.push_back(p.table);
+        }
+
+        tables.emplace(p.table, std::move(tab));
+        return true;
+    } // createTable
+
+    bool dropTable(const std::string &name) {
+        MemTable *tab = table(name);
+        if (tab == nullptr) {
+            return true; // IF EXISTS
+        }
+
+        if (MemTable *parent = table(tab->ref_table)) {
+            auto &ch = parent->children;
+            ch.erase(std::remove(ch.begin(), ch.end(), name), ch.end());
+        }
+        // the undo log must not refer to the dropped table
+        undo_log.erase(std::remove_if(undo_log.begin(), undo_log.end(),
+            [tab](const Undo &u) { return u.tab == tab; }), undo_log.end());
+        tables.erase(name);
+        return true;
+    } // dropTable
+
+
+public: // rows
+    /**
+     * @brief insert the row, check the key uniqueness and the parent row of the foreign key.
+     * @return the rowid; -1 if failed.
+     */
+    int64_t insertRow(MemTable &tab, MemRow &&r) {
+        if (r.size() != tab.cols.size()) {
+            fail("column count mismatch of table " + tab.name);
+            return -1;
+        }
+        for (size_t c = 0; c < r.size(); ++c) {
+            tab.applyAffinity(c, r[c]);
+        }
+        if (tab.rowid_key && r[0].isNull()) {
+            r[0] = MemValue::ofInt(tab.max_key + 1);
+        }
+
+        if (tab.has_pk && (tab.findKey(r[0]) != nullptr)) {
+            fail("UNIQUE constraint failed: " + tab.name + "." + tab.cols[0]);
+            return -1;
+        }
+        if (!checkForeignKey(tab, r)) {
+            return -1;
+        }
+
+        tab.rows.push_back(std::move(r));
+        tab.alive.push_back(1);
+        ++tab.live;
+        const int64_t rowid = static_cast<int64_t>(tab.rows.size());
+        tab.indexAdd(rowid, tab.rows.back());
+        last_insert_rowid = tab.rowid_key ? tab.rows.back()[0].i : rowid;
+
+        log(Undo::Kind::INSERT, tab, rowid, MemRow());
+        return rowid;
+    } // insertRow
+
+    /**
+     * @brief replace the row, the child rows follow the changed key.
+     * @return true if success; otherwise, false.
+     */
+    bool updateRow(MemTable &tab, int64_t rowid, MemRow &&r) {
+        if (r.size() != tab.cols.size()) {
+            return fail("column count mismatch of table " + tab.name);
+        }
+        for (size_t c = 0; c < r.size(); ++c) {
+            tab.applyAffinity(c, r[c]);
+        }
+
+        MemRow &cur = tab.rows[rowid - 1];
+        const bool key_changed = (cur[0] != r[0]);
+        if (key_changed && tab.has_pk && (tab.findKey(r[0]) != nullptr)) {
+            return fail("UNIQUE constraint failed: " + tab.name + "." + tab.cols[0]);
+        }
+        if (!checkForeignKey(tab, r)) {
+            return false;
+        }
+
+        MemValue old_key = cur[0];
+        tab.indexRemove(rowid, cur);
+        log(Undo::Kind::UPDATE, tab, rowid, cur);
+        cur = std::move(r);
+        tab.indexAdd(rowid, cur);
+
+        // ON UPDATE CASCADE
+        if (key_changed) {
+            for (auto &name : tab.children) {
+                MemTable *child = table(name);
+                const std::vector<int64_t> *ids = child->findForeignKey(old_key);
+                if (ids == nullptr) continue;
+
+                const std::vector<int64_t> copy = *ids;
+                for (int64_t id : copy) {
+                    MemRow cr = child->row(id);
+                    cr[child->fk_col] = tab.rows[rowid - 1][0];
+                    if (!updateRow(*child, id, std::move(cr))) return false;
+                }
+            }
+        }
+        return true;
+    } // updateRow
+
+    /**
+     * @brief delete the row and the child rows recursively.
+     * @return true if success; otherwise, false.
+     */
+    bool deleteRow(MemTable &tab, int64_t rowid) {
+        if (!tab.isAlive(rowid)) {
+            return true;
+        }
+
+        // ON DELETE CASCADE
+        const MemValue key = tab.row(rowid)[0];
+        for (auto &name : tab.children) {
+            MemTable *child = table(name);
+            const std::vector<int64_t> *ids = child->findForeignKey(key);
+            if (ids == nullptr) continue;
+
+            const std::vector<int64_t> copy = *ids;
+            for (int64_t id : copy) {
+                if (!deleteRow(*child, id)) return false;
+            }
+        }
+
+        tab.indexRemove(rowid, tab.row(rowid));
+        tab.alive[rowid - 1] = 0;
+        --tab.live;
+        log(Undo::Kind::DELETE, tab, rowid, std::move(tab.rows[rowid - 1]));
+        tab.rows[rowid - 1].clear();
+        return true;
+    } // deleteRow
+
+
+public: // transaction
+    bool begin() {
+        if (in_txn) {
+            return fail("cannot start a transaction within a transaction");
+        }
+        in_txn = true;
+        return true;
+    }
+
+    bool commit() {
+        if (!in_txn) {
+            return fail("cannot commit - no transaction is active");
+        }
+        endTransaction();
+        return true;
+    }
+
+    bool rollback() {
+        if (!in_txn) {
+            return fail("cannot rollback - no transaction is active");
+        }
+        undoTo(0);
+        endTransaction();
+        return true;
+    }
+
+    /**
+     * @brief start the savepoint, also start a transaction if not in one.
+     */
+    bool savepoint(const std::string &name) {
+        if (!in_txn) {
+            in_txn = true;
+            implicit_txn_ = true;
+            savepoints.clear();
+        }
+        savepoints.emplace_back(name, undo_log.size());
+        return true;
+    }
+
+    /**
+     * @brief release the savepoint and the later ones,
+     *     commit if the first savepoint started the transaction.
+     */
+    bool release(const std::string &name) {
+        const int32_t s = findSavepoint(name);
+        if (s < 0) {
+            return fail("no such savepoint: " + name);
+        }
+
+        savepoints.resize(s);
+        if ((s == 0) && implicit_txn_) {
+            endTransaction();
+        }
+        return true;
+    }
+
+    /**
+     * @brief roll back to the savepoint, the savepoint remains.
+     */
+    bool rollbackTo(const std::string &name) {
+        const int32_t s = findSavepoint(name);
+        if (s < 0) {
+            return fail("no such savepoint: " + name);
+        }
+
+        undoTo(savepoints[s].second);
+        savepoints.resize(s + 1);
+        return true;
+    }
+
+private:
+    // the transaction is started by SAVEPOINT instead of BEGIN
+    bool implicit_txn_ = false;
+
+    bool fail(const std::string &msg) {
+        last_error = msg;
+        return false;
+    }
+
+    bool checkForeignKey(const MemTable &tab, const MemRow &r) {
+        if ((tab.fk_col < 0) || r[tab.fk_col].isNull()) {
+            return true;
+        }
+
+        const MemTable *parent = table(tab.ref_table);
+        if ((parent == nullptr) || (parent->findKey(r[tab.fk_col]) == nullptr)) {
+            return fail("FOREIGN KEY constraint failed: " + tab.name + "." + tab.cols[tab.fk_col]);
+        }
+        return true;
+    }
+
+    void log(typename Undo::Kind kind, MemTable &tab, int64_t rowid, MemRow old_row) {
+        if (in_txn) {
+            undo_log.push_back(Undo{kind, &tab, rowid, std::move(old_row)});
+        }
+    }
+
+    void endTransaction() {
+        in_txn = false;
+        implicit_txn_ = false;
+        undo_log.clear();
+        savepoints.clear();
+    }
+
+    int32_t findSavepoint(const std::string &name) const {
+        for (int32_t s = static_cast<int32_t>(savepoints.size()) - 1; s >= 0; --s) {
+            if (savepoints[s].first == name) return s;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief undo the log down to the size, the cascaded changes are logged one by one.
+     */
+    void undoTo(size_t size) {
+        while (undo_log.size() > size) {
+            Undo u = std::move(undo_log.back());
+            undo_log.pop_back();
+
+            MemTable &tab = *u.tab;
+            switch (u.kind) {
+            case Undo::Kind::INSERT:
+                tab.indexRemove(u.rowid, tab.row(u.rowid));
+                tab.alive[u.rowid - 1] = 0;
+                tab.rows[u.rowid - 1].clear();
+                --tab.live;
+                break;
+            case Undo::Kind::DELETE:
+                tab.rows[u.rowid - 1] = std::move(u.old_row);
+                tab.alive[u.rowid - 1] = 1;
+                tab.indexAdd(u.rowid, tab.row(u.rowid));
+                ++tab.live;
+                break;
+            case Undo::Kind::UPDATE:
+                tab.indexRemove(u.rowid, tab.row(u.rowid));
+                tab.rows[u.rowid - 1] = std::move(u.old_row);
+                tab.indexAdd(u.rowid, tab.row(u.rowid));
+                break;
+            } // switch
+        } // while
+    } // undoTo
+}; // MemDatabase
+
+} // namespace edadb
@@ -0,0 +1,268 @@
+/***
+ * @file SqlStatement4Memory.h
+ * @brief SqlStatement4Memory.h generates the plans of the memory backend for the given type.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "edadb/Config.h"
+#include "edadb/SqlStatement.h"
+#include "edadb/backend/sqlite/SqlStatement4Sqlite.h"
+
+namespace edadb {
+
+/**
+ * @class SqlStatement
+ * @brief This class generates the plans of the memory backend for the given type, @see MemPlan.
+ *     The plan names the table and the access path only, the columns are bound in the table column order,
+ *     the same order as the Sqlite3 statements. The projection statement is inherited as the schema text.
+ * @tparam T The class type.
+ */
+template<typename T>
+struct SqlStatementImpl<DbBackendType::MEMORY, T> : public SqlStatementImpl<DbBackendType::SQLITE, T> {
+private:
+    using Base = SqlStatementImpl<DbBackendType::SQLITE, T>;
+
+public:
+    // the child rows are deleted and updated by MemDatabase as ON DELETE/UPDATE CASCADE
+    static constexpr bool cascade_foreign_key = true;
+
+public:
+    /**
+     * @brief create the table plan: CREATE tab PK=0|1|ROWID [FK=col:parent] COLS=c1:TYPE,...
+     * @param this_fkc  this foreign key constraint.
+     * @param work_fkc  work foreign key constraint.
+     * @return The create table plan.
+     */
+    static std::string createTableStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        assert(this_fkc.fore_tab_name == work_fkc.prim_tab_name);
+
+        std::vector<std::string> names, types;
+        Base::collectDefinedColumns(names, types, work_fkc);
+        Base::collectPrimKeyColumns(names, types, work_fkc);
+        if (this_fkc.valid()) {
+            names.push_back(this_fkc.fore_col_name);
+            types.push_back(this_fkc.key_type);
+        }
+
+        std::string plan = "CREATE \"" + this_fkc.fore_tab_name + "\"";
+        plan += RowidKeyTrait<T>::value ? " PK=ROWID" :
+            Cpp2SqlTypeTrait<T>::hasPrimKey ? " PK=1" : " PK=0";
+        if (this_fkc.valid()) {
+            plan += " FK=" + this_fkc.fore_col_name + ":" + this_fkc.prim_tab_name;
+        }
+
+        plan += " COLS=";
+        for (size_t i = 0; i < names.size(); ++i) {
+            plan += (i > 0 ? "," : "") + names[i] + ":" + types[i];
+        }
+        return plan += ";";
+    } // createTableStatement
+
+
+    /**
+     * @brief Generate the insert plan, all columns are bound.
+     * @return The insert plan.
+     */
+    static std::string insertPlaceHolderStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return "INSERT \"" + this_fkc.fore_tab_name + "\";";
+    }
+
+    /**
+     * @brief Generate the update plan, all columns and then the key to update are bound.
+     * @return The update plan.
+     */
+    static std::string updatePlaceHolderStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return "UPDATE \"" + this_fkc.fore_tab_name + "\";";
+    }
+
+    /**
+     * @brief Generate the delete plan, the key to delete is bound.
+     * @return The delete plan.
+     */
+    static std::string deletePlaceHolderStatement(const ForeignKeyConstraint& this_fkc) {
+        return "DELETE \"" + this_fkc.fore_tab_name + "\";";
+    }
+
+
+    /**
+     * @brief Generate the scan plan of all columns
+     * @return The scan plan
+     */
+    static std::string scanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + ";";
+    }
+
+    /**
+     * @brief Generate the scan plan of the selected columns only
+     * @param tab_name The table name
+     * @param cols The selected column names
+     * @return The column scan plan
+     */
+    static std::string scanColumnsStatement(const std::string& tab_name,
+            const std::vector<std::string>& cols) {
+        assert(!cols.empty());
+
+        std::string plan = "SELECT \"" + tab_name + "\" COLS=";
+        for (size_t i = 0; i < cols.size(); ++i) {
+            plan += (i > 0 ? "," : "") + cols[i];
+        }
+        return plan += ";";
+    } // scanColumnsStatement
+
+    /**
+     * @brief Generate the scan plan on the rowid range [begin, last]
+     * @return The range scan plan
+     */
+    static std::string rangeScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + " WHERE=ROWID;";
+    }
+
+    /**
+     * @brief Generate the scan plan to dump the table to the snapshot,
+     *     the child table rows are grouped by the foreign key
+     * @return The snapshot scan plan
+     */
+    static std::string snapshotScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + " ORDER=SNAPSHOT;";
+    }
+
+    /**
+     * @brief Generate the query plan using predicate text,
+     *     only the empty predicate (scan) is supported, prepare rejects the others.
+     * @param pred The predicate text
+     * @return The query plan
+     */
+    static std::string queryPredicateStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc, const std::string& pred) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + (pred.empty() ? "" : (" WHERE=" + pred)) + ";";
+    }
+
+    /**
+     * @brief Generate the query plan using primary key
+     * @return The query plan using primary key
+     */
+    static std::string queryPrimaryKeyStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + " WHERE=KEY;";
+    }
+
+    /**
+     * @brief Generate the query plan of one column using primary key
+     * @param tab_name The table name
+     * @param col The column name
+     * @return The query plan of the column using primary key
+     */
+    static std::string queryColumnByKeyStatement(const std::string& tab_name,
+            const std::string& col) {
+        return "SELECT \"" + tab_name + "\" COLS=" + col + " WHERE=KEY;";
+    }
+
+    /**
+     * @brief Generate the query plan using a batch of primary keys
+     * @param n The number of primary keys bound
+     * @return The query plan using primary keys
+     */
+    static std::string queryPrimaryKeysStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc, size_t n) {
+        (void)work_fkc;
+        assert(n > 0);
+        return selectPlan(this_fkc) + " WHERE=KEYS:" + std::to_string(n) + ";";
+    }
+
+    /**
+     * @brief Generate the query plan using foreign key
+     * @return The query plan using foreign key
+     */
+    static std::string queryForeignKeyStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + " WHERE=FK;";
+    }
+
+    /**
+     * @brief Generate the scan plan ordered by the column, the primary key is the tie breaker
+     * @param order_col The column to order by, empty to order by primary key
+     * @param order The sort order
+     * @param with_limit If true, the limit is bound
+     * @return The ordered scan plan
+     */
+    static std::string orderedScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc,
+            const std::string& order_col, SortOrder order, bool with_limit) {
+        (void)work_fkc;
+        return selectPlan(this_fkc) + orderOption(order_col, order)
+            + (with_limit ? " LIMIT;" : ";");
+    }
+
+    /**
+     * @brief Generate the keyset pagination plan, the NULL columns come last in both orders
+     *     and are read as a separate run by the key:
+     *     WHERE=NOT_NULL|AFTER for the non NULL columns, WHERE=NULL|NULL_AFTER for the NULL ones,
+     *     the seek key (column, primary key) or (primary key) is bound and then the limit.
+     * @param order_col The column to order by, empty to order by primary key
+     * @param order The sort order
+     * @param has_after If false, generate the first page plan of the run without seek key
+     * @param null_run If true, read the NULL columns and only the primary key is bound
+     * @return The keyset pagination plan
+     */
+    static std::string keysetPageStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc,
+            const std::string& order_col, SortOrder order, bool has_after, bool null_run) {
+        (void)work_fkc;
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        std::string where;
+        if (order_col.empty() || (order_col == pk_name)) {
+            where = has_after ? " WHERE=AFTER" : "";
+        } else if (null_run) {
+            where = has_after ? " WHERE=NULL_AFTER" : " WHERE=NULL";
+        } else {
+            where = has_after ? " WHERE=AFTER" : " WHERE=NOT_NULL";
+        }
+        return selectPlan(this_fkc) + where + orderOption(order_col, order) + " LIMIT;";
+    }
+
+    /**
+     * @brief Generate the create index plan,
+     *     the key and the foreign key are hash indexed, the order is sorted on demand.
+     * @param tab_name The table name
+     * @param cols The indexed column names
+     * @return The create index plan
+     */
+    static std::string createIndexStatement(const std::string& tab_name,
+            const std::vector<std::string>& cols) {
+        assert(!cols.empty());
+        return "INDEX \"" + tab_name + "\";";
+    }
+
+private:
+    static std::string selectPlan(const ForeignKeyConstraint& this_fkc) {
+        return "SELECT \"" + this_fkc.fore_tab_name + "\"";
+    }
+
+    static std::string orderOption(const std::string& order_col, SortOrder order) {
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        return " ORDER=" + (order_col.empty() ? pk_name : order_col)
+            + ((order == SortOrder::ASC) ? ":ASC" : ":DESC");
+    }
+}; // SqlStatementImpl
+
+} // namespace edadb
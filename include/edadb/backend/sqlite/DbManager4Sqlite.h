@@ -9,27 +9,38 @@
 #include <type_traits>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <unordered_set>
+#include <cctype>
 #include <stdint.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <chrono>
 #include <sqlite3.h>
 
 #include "Macro4Sqlite.h"
 
 #include "edadb/Config.h"
 #include "edadb/Singleton.h"
+#include "edadb/SqlTrace.h"
+#include "edadb/SlowQueryLog.h"
+#include "edadb/BusyRetry.h"
 
 #include "edadb/DbBackendType.h"
 #include "edadb/DbStatement.h"
 #include "edadb/backend/sqlite/DbStatement4Sqlite.h"
 #include "edadb/DbManager.h"
 
-#define _EDADB_DEBUG_TRACE_SQL_STMT_ 1
-
 namespace edadb {
 
 /**
  * @class DbManager
  * @brief This class manages the Sqlite3 database.
- *    Since Sqlite3 use R/W lock, we define Singleton pattern for this class.
+ *    DbManager::i() is the default database of the process,
+ *    each Database handle owns another instance with its own connections.
  */
 template<>
 class DbManagerImpl<DbBackendType::SQLITE> :
@@ -40,9 +51,46 @@ private:
      */
     friend class Singleton< DbManagerImpl<DbBackendType::SQLITE> >;
 
+public:
+    // database connection handler type
+    using Connection = sqlite3 *;
+
 protected:
     std::string connect_param; // database connection parameter
     sqlite3     *db = nullptr; // database handler
+    std::atomic<uint64_t> connect_gen{0}; // bumped on close, see connectGeneration
+
+    // in-memory mode: the file loaded into memory and saved back on save()
+    std::string backing_file;
+    std::mutex  save_mtx;      // serialize the saves from the caller and the timer
+
+    // auto save timer thread
+    std::thread             autosave_thread;
+    std::mutex              autosave_mtx;
+    std::condition_variable autosave_cv;
+    bool                    autosave_stop = false;
+
+    // table names loaded from sqlite_master, reloaded after the schema may change
+    std::mutex                      table_mtx;
+    std::unordered_set<std::string> table_names;
+    bool                            table_names_loaded = false;
+
+    // WAL mode: the idle read only connections of the Readers, see connectWal
+    std::mutex             reader_mtx;
+    std::vector<sqlite3 *> idle_readers;
+    size_t                 reader_pool_size = 0; // 0 if the Readers use the main connection
+    bool                   wal_mode = false;
+
+    // the thread in the transaction of the main connection, which reads its own writes
+    std::atomic<std::thread::id> txn_thread{};
+
+    // background checkpoint thread of WAL mode, on its own connection
+    sqlite3                *ckpt_db = nullptr;
+    std::mutex              ckpt_db_mtx; // ckpt_db is opened NOMUTEX, one checkpoint at a time
+    std::thread             ckpt_thread;
+    std::mutex              ckpt_mtx;
+    std::condition_variable ckpt_cv;
+    bool                    ckpt_stop = false;
 
 public:
     // sqlite3 bind column index starts from 1
@@ -51,14 +99,21 @@ public:
     // sqlite3 fetch column index starts from 0
     static const uint32_t s_read_column_begin_index = 0; 
 
-protected:
+    // the INTEGER PRIMARY KEY left NULL on insert is assigned the rowid by sqlite3
+    static const bool s_assign_rowid_key = true;
+
+    // SAVEPOINT nests in the transaction of the caller
+    static const bool s_has_savepoint = true;
+
+public:
     /**
-     * @brief protected ctor to avoid direct instantiation, use Singleton instead.
+     * @brief ctor of the database owned by a Database handle,
+     *     the default database is the Singleton DbManager::i().
      */
     DbManagerImpl(void) = default;
 
     /**
-     * @brief protected dtor to avoid direct instantiation, use Singleton instead.
+     * @brief dtor closes the database, the DbMap bound to it must be destroyed before.
      */
     ~DbManagerImpl() {
         close();
@@ -77,6 +132,14 @@ public: // database operation
         return !connect_param.empty();
     }
 
+    /**
+     * @brief Get the generation of the connection, bumped on close,
+     *     the read connections kept across the reads are stale if opened in another generation.
+     */
+    uint64_t connectGeneration() const {
+        return connect_gen.load();
+    }
+
 
     /**
      * @brief Connect to the database using the connection parameter.
@@ -97,44 +160,188 @@ public: // database operation
             return false;
         }
 
-        // enable foreign key constraint
-        if (!exec("PRAGMA foreign_keys = ON;")) {
-            std::cerr << "DbManager4Sqlite::connect[PRAGMA foreign_keys] failed!" << std::endl;
+        return setupConnection();
+    } // connect
+
+
+    /**
+     * @brief Connect to the database file in WAL mode, the main connection is the only writer
+     *     and the Readers run on the pooled read only connections, so the reads go on while writing.
+     *     The commits leave the checkpoint to the background thread, which checkpoints passively
+     *     without waiting for the readers, so the readers never stall behind a checkpoint.
+     * @param c The database file.
+     * @param readers The number of the read only connections kept in the pool.
+     * @param checkpoint_interval The interval of the background checkpoint,
+     *     0 to checkpoint on commit by the sqlite default.
+     * @return true if connected in WAL mode; otherwise, false.
+     */
+    bool connectWal(const std::string &c = "edadb.sqlite3.db",
+            size_t readers = Config::wal_reader_connections,
+            std::chrono::milliseconds checkpoint_interval =
+                std::chrono::milliseconds(Config::wal_checkpoint_interval_ms)) {
+        if (isConnected()) {
+            return wal_mode && (connect_param == c);
+        }
+        if (!connect(c)) {
             return false;
         }
 
-        // enable sqlite trace if needed
-        #if _EDADB_DEBUG_TRACE_SQL_STMT_
-            if (!checkForeignKeyEnabled()) {
-                std::cerr << "DbManager4Sqlite::connect: foreign key constraint is not enabled!" << std::endl;
-                return false;
-            } 
-            else {
-                std::cout << "DbManager4Sqlite::connect: foreign key constraint is enabled." << std::endl;
+        // journal_mode returns the mode in effect, the memory database cannot use WAL
+        std::string mode;
+        if (!queryText("PRAGMA journal_mode = WAL;", mode) || (mode != "wal")) {
+            std::cerr << "DbManager4Sqlite::connectWal: cannot use WAL mode for " << c
+                << ", journal mode is " << mode << std::endl;
+            close();
+            return false;
+        }
+
+        const bool background = (checkpoint_interval.count() > 0);
+        const int pages = background ? Config::wal_autocheckpoint_pages : 1000;
+        if (!exec("PRAGMA wal_autocheckpoint = " + std::to_string(pages) + ";")) {
+            close();
+            return false;
+        }
+        wal_mode = true;
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            for (size_t i = 0; i < readers; ++i) {
+                sqlite3 *conn = openReadConnection();
+                if (conn == nullptr) break;
+                idle_readers.push_back(conn);
             }
+            reader_pool_size = idle_readers.size();
+        }
+        if (reader_pool_size < readers) {
+            close();
+            return false;
+        }
 
-            // register the trace callback to output the SQL statement
-            registerTrace();
-        #endif
+        return !background || startCheckpoint(checkpoint_interval);
+    } // connectWal
 
-        return true;
-    } // connect
+
+    /**
+     * @brief Check if connected by connectWal.
+     * @return true if the database is in WAL mode; otherwise, false.
+     */
+    bool isWal() const {
+        return wal_mode;
+    }
+
+
+    /**
+     * @brief Connect to an in-memory database loaded from the file,
+     *     all the DbMap traffic is served from memory until save() writes it back.
+     *     The memory database is named by the memdb vfs, so the read connections
+     *     opened by openReadConnection share it.
+     * @param file The database file, created on the first save() if not exists.
+     * @return true if connected and loaded; otherwise, false.
+     */
+    bool connectInMemory(const std::string &file = "edadb.sqlite3.db") {
+        if (isConnected()) {
+            return isInMemory() && (backing_file == file);
+        }
+
+        // the memdb name is unique per manager, so the databases in memory are independent
+        static std::atomic<uint32_t> s_memdb_seq{0};
+        connect_param = "file:/edadb-memory-" + std::to_string(s_memdb_seq.fetch_add(1)) + "?vfs=memdb";
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+            SQLITE_OPEN_FULLMUTEX | SQLITE_OPEN_URI;
+        int rc = sqlite3_open_v2(connect_param.c_str(), &db, flags, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::connectInMemory[sqlite3_open_v2] failed!" << std::endl;
+            std::cerr << "Error: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_close_v2(db);
+            db = nullptr;
+            connect_param.clear();
+            return false;
+        }
+        backing_file = file;
+
+        // load the file into memory if exists
+        sqlite3 *file_db = nullptr;
+        rc = sqlite3_open_v2(file.c_str(), &file_db, SQLITE_OPEN_READONLY, nullptr);
+        if (rc == SQLITE_OK) {
+            rc = copyDatabase(db, file_db, -1);
+        }
+        else if (rc == SQLITE_CANTOPEN) {
+            rc = SQLITE_OK; // new database: nothing to load
+        }
+        sqlite3_close_v2(file_db);
+
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::connectInMemory: failed to load " << file
+                << ": " << sqlite3_errstr(rc) << std::endl;
+            close();
+            return false;
+        }
+
+        return setupConnection();
+    } // connectInMemory
 
 
     /**
-     * @brief Execute the SQL statement directly.
-     * @param sql The SQL statement.
-     * @return true if executed; otherwise, false.
+     * @brief Check if connected by connectInMemory.
+     * @return true if the database is in memory; otherwise, false.
+     */
+    bool isInMemory() const {
+        return !backing_file.empty();
+    }
+
+
+    /**
+     * @brief Execute the SQL statements directly, one by one.
+     *     The busy statement is retried alone, such as COMMIT waiting for the readers,
+     *     the statements executed before it are not run again.
+     * @param sql The SQL statements.
+     * @return true if all executed; otherwise, false.
      */
     bool exec(const std::string &sql) {
-        char *zErrMsg = nullptr;
-        int rc = sqlite3_exec(db, sql.c_str(), 0, 0, &zErrMsg);
+        int rc = SQLITE_OK;
+        bool txn_control = false;
+        bool schema_changed = false;
+
+        const char *tail = sql.c_str();
+        while ((rc == SQLITE_OK) && (*tail != '\0')) {
+            sqlite3_stmt *s = nullptr;
+            const char *next = nullptr;
+            BusyRetry::handlerTimedOut() = false;
+            rc = sqlite3_prepare_v2(db, tail, -1, &s, &next);
+            for (int n = 0; sqliteRetryable(rc, db) && !BusyRetry::handlerTimedOut(); ++n) {
+                if (!BusyRetry::i().wait(n)) break;
+                rc = sqlite3_prepare_v2(db, tail, -1, &s, &next);
+            }
+            if (rc != SQLITE_OK) {
+                EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
+                break;
+            }
+            tail = next;
+            if (s == nullptr) {
+                continue; // white space or comment
+            }
+
+            const std::string word = firstKeyword(sqlite3_sql(s));
+            rc = stepAll(s, (word == "COMMIT") || (word == "END"));
+            if (rc != SQLITE_OK) {
+                EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to execute SQL: " + std::string(sqlite3_sql(s)));
+            }
+            sqlite3_finalize(s);
+
+            txn_control    = txn_control || isTransactionControl(word);
+            schema_changed = schema_changed || mayChangeSchema(word);
+        }
+
+        if (txn_control) {
+            txn_thread.store(sqlite3_get_autocommit(db) ? std::thread::id() : std::this_thread::get_id());
+        }
+        if (schema_changed) {
+            invalidateTableNames();
+        }
+
         bool executed = (rc == SQLITE_OK);
         if (!executed) {
-            std::cerr << "DbManager4Sqlite::exec[sqlite3_exec] failed!" << std::endl;
-            std::cerr << "Error: " << (zErrMsg ? zErrMsg : "Unknown error") << std::endl;
-            sqlite3_free(zErrMsg); // free the error message
-            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to execute SQL: " + sql);
+            std::cerr << "DbManager4Sqlite::exec failed!" << std::endl;
         } // if 
         return executed;
     } // exec
@@ -145,6 +352,17 @@ public: // database operation
      * @return true if closed; otherwise, false.
     */
     bool close() {
+        // unsaved changes of the in-memory database are discarded,
+        // wait for the running save before closing
+        stopAutoSave();
+        stopCheckpoint();
+        closeReaderPool();
+        ++connect_gen;
+        std::lock_guard<std::mutex> lock(save_mtx);
+        backing_file.clear();
+        invalidateTableNames();
+        txn_thread.store(std::thread::id());
+
         // success close if not connected 
         if ((!isConnected()) || (db == nullptr)) {
             connect_param.clear();
@@ -164,6 +382,7 @@ public: // database operation
         // close success: reset db pointer
         if (rc == SQLITE_OK) {
             db = nullptr;  
+            connect_param.clear();
             return true;
         }
 
@@ -176,23 +395,595 @@ public: // database operation
 
     /**
      * @brief Check if a table exists in the database.
+     *     The names are loaded by one query and cached until a statement executed by exec()
+     *     may change the schema, the tables created by the other connections are not seen.
      * @param name The table name.
      * @return true if exists; otherwise, false.
      */
     bool tableExists(std::string name) {
         if (name.empty()) return false;
 
-        static constexpr const char* kSQL =
-            "SELECT 1 FROM sqlite_master WHERE type='table' AND name=?1 LIMIT 1;";
+        std::lock_guard<std::mutex> lock(table_mtx);
+        if (!table_names_loaded) {
+            static constexpr const char* kSQL =
+                "SELECT name FROM sqlite_master WHERE type='table';";
+            sqlite3_stmt* s = nullptr;
+            if (sqlite3_prepare_v2(db, kSQL, -1, &s, nullptr) != SQLITE_OK)
+                return false;
+
+            table_names.clear();
+            int rc = SQLITE_OK;
+            while ((rc = sqlite3_step(s)) == SQLITE_ROW) {
+                const unsigned char *n = sqlite3_column_text(s, 0);
+                if (n != nullptr) table_names.emplace(reinterpret_cast<const char*>(n));
+            }
+            sqlite3_finalize(s);
+            if (rc != SQLITE_DONE)
+                return false;
+            table_names_loaded = true;
+        }
+
+        return table_names.count(name) > 0;
+    } // tableExists
+
+
+    /**
+     * @brief Read the schema fingerprint stored for the root table.
+     * @param name The root table name.
+     * @param fp The fingerprint.
+     * @return true if found; otherwise, false.
+     */
+    bool readSchemaFingerprint(const std::string &name, std::string &fp) {
+        if (!tableExists(Config::schema_table_name)) return false;
+
+        const std::string sql = std::string("SELECT fingerprint FROM \"") +
+            Config::schema_table_name + "\" WHERE name = ?1;";
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        sqlite3_bind_text(s, 1, name.data(), (int)name.size(), SQLITE_STATIC);
+        bool found = (sqlite3_step(s) == SQLITE_ROW) &&
+            (sqlite3_column_type(s, 0) != SQLITE_NULL);
+        if (found) {
+            fp = reinterpret_cast<const char*>(sqlite3_column_text(s, 0));
+        }
+        sqlite3_finalize(s);
+        return found;
+    } // readSchemaFingerprint
+
+
+    /**
+     * @brief Store the schema fingerprint of the root table, the metadata table is created if not exists.
+     * @param name The root table name.
+     * @param fp The fingerprint.
+     * @return true if stored; otherwise, false.
+     */
+    bool writeSchemaFingerprint(const std::string &name, const std::string &fp) {
+        const std::string tab = std::string("\"") + Config::schema_table_name + "\"";
+        if (!tableExists(Config::schema_table_name) &&
+            !exec("CREATE TABLE IF NOT EXISTS " + tab +
+                " (name TEXT PRIMARY KEY, fingerprint TEXT NOT NULL);")) {
+            return false;
+        }
+
+        const std::string sql = "INSERT OR REPLACE INTO " + tab + " (name, fingerprint) VALUES (?1, ?2);";
         sqlite3_stmt* s = nullptr;
-        if (sqlite3_prepare_v2(db, kSQL, -1, &s, nullptr) != SQLITE_OK)
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
             return false;
+        }
+
         sqlite3_bind_text(s, 1, name.data(), (int)name.size(), SQLITE_STATIC);
-        int rc = sqlite3_step(s);
+        sqlite3_bind_text(s, 2, fp.data(), (int)fp.size(), SQLITE_STATIC);
+        rc = sqlite3_step(s);
+        sqlite3_finalize(s);
+        if (rc != SQLITE_DONE) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to execute SQL: " + sql);
+            return false;
+        }
+        return true;
+    } // writeSchemaFingerprint
+
+
+    /**
+     * @brief Get the columns of the table on disk by "PRAGMA table_info".
+     * @param name The table name.
+     * @param names The column names in the table order.
+     * @param types The declared column types.
+     * @return true if the table exists; otherwise, false.
+     */
+    bool tableColumns(const std::string &name,
+            std::vector<std::string> &names, std::vector<std::string> &types) {
+        const std::string sql = "PRAGMA table_info(\"" + name + "\");";
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        // columns: cid, name, type, notnull, dflt_value, pk
+        names.clear();
+        types.clear();
+        while ((rc = sqlite3_step(s)) == SQLITE_ROW) {
+            const unsigned char *n = sqlite3_column_text(s, 1);
+            const unsigned char *t = sqlite3_column_text(s, 2);
+            names.emplace_back(n ? reinterpret_cast<const char*>(n) : "");
+            types.emplace_back(t ? reinterpret_cast<const char*>(t) : "");
+        }
+        sqlite3_finalize(s);
+        return (rc == SQLITE_DONE) && !names.empty();
+    } // tableColumns
+
+
+    /**
+     * @brief Rebuild the table by the new definition and copy the common columns,
+     *     for the changes ALTER TABLE cannot apply in place.
+     *     The foreign keys are disabled during the swap so dropping the old table
+     *     does not cascade to the child tables, and checked after.
+     *     The indexes of the old table are created again if their columns still exist.
+     * @param name The table name.
+     * @param tmp_name The name the new table is created by create_sql, renamed to name at last.
+     * @param create_sql The create table statement of the new table named tmp_name.
+     * @param copy_cols The columns copied from the old table.
+     * @return true if rebuilt; otherwise, false.
+     */
+    bool rebuildTable(const std::string &name, const std::string &tmp_name,
+            const std::string &create_sql, const std::vector<std::string> &copy_cols) {
+        // the indexes created by the user or by DbMap, not the automatic ones
+        std::vector<std::string> index_sqls;
+        {
+            static constexpr const char* kSQL =
+                "SELECT sql FROM sqlite_master WHERE type='index' AND tbl_name=?1 AND sql IS NOT NULL;";
+            sqlite3_stmt* s = nullptr;
+            int rc = sqlite3_prepare_v2(db, kSQL, -1, &s, nullptr);
+            if (rc != SQLITE_OK) {
+                EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + std::string(kSQL));
+                return false;
+            }
+            sqlite3_bind_text(s, 1, name.data(), (int)name.size(), SQLITE_STATIC);
+            while (sqlite3_step(s) == SQLITE_ROW) {
+                index_sqls.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(s, 0)));
+            }
+            sqlite3_finalize(s);
+        }
+
+        std::string cols;
+        for (size_t i = 0; i < copy_cols.size(); ++i) {
+            cols += (i > 0 ? ", " : "") + copy_cols[i];
+        }
+
+        // PRAGMA foreign_keys is a no-op in the transaction, the db config is not
+        int fk_on = 0;
+        sqlite3_db_config(db, SQLITE_DBCONFIG_ENABLE_FKEY, -1, &fk_on);
+        sqlite3_db_config(db, SQLITE_DBCONFIG_ENABLE_FKEY, 0, nullptr);
+
+        bool ok = exec("DROP TABLE IF EXISTS \"" + tmp_name + "\";") && exec(create_sql);
+        if (ok && !copy_cols.empty()) {
+            ok = exec("INSERT INTO \"" + tmp_name + "\" (" + cols + ") SELECT " + cols +
+                " FROM \"" + name + "\";");
+        }
+        ok = ok && exec("DROP TABLE \"" + name + "\";") &&
+            exec("ALTER TABLE \"" + tmp_name + "\" RENAME TO \"" + name + "\";");
+
+        if (ok) {
+            for (const auto &sql : index_sqls) {
+                if (!exec(sql + ";")) {
+                    std::cerr << "DbManager4Sqlite::rebuildTable: index dropped: " << sql << std::endl;
+                }
+            }
+        }
+
+        sqlite3_db_config(db, SQLITE_DBCONFIG_ENABLE_FKEY, fk_on, nullptr);
+        if (ok && fk_on) {
+            ok = foreignKeyCheck(name);
+        }
+        return ok;
+    } // rebuildTable
+
+
+    /**
+     * @brief Get the rowid range of the table, used to partition the table scan.
+     * @param name The table name.
+     * @param lo The min rowid.
+     * @param hi The max rowid.
+     * @param conn The connection to query, nullptr for the main connection.
+     * @return true if the table is not empty; otherwise, false.
+     */
+    bool rowidRange(const std::string &name, int64_t &lo, int64_t &hi, Connection conn = nullptr) {
+        const std::string sql = "SELECT min(rowid), max(rowid) FROM \"" + name + "\";";
+        sqlite3 *on = (conn != nullptr) ? conn : db;
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(on, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, on, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        bool found = (sqlite3_step(s) == SQLITE_ROW) &&
+            (sqlite3_column_type(s, 0) != SQLITE_NULL);
+        if (found) {
+            lo = sqlite3_column_int64(s, 0);
+            hi = sqlite3_column_int64(s, 1);
+        }
+        sqlite3_finalize(s);
+        return found;
+    } // rowidRange
+
+
+    /**
+     * @brief Get the query plan of the statement by "EXPLAIN QUERY PLAN".
+     * @param sql The statement, the place holders are left unbound.
+     * @param details The detail column of the plan rows.
+     * @return true if explained; otherwise, false.
+     */
+    bool explainQueryPlan(const std::string &sql, std::vector<std::string> &details) {
+        const std::string explain = "EXPLAIN QUERY PLAN " + sql;
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(db, explain.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + explain);
+            return false;
+        }
+
+        // columns: id, parent, notused, detail
+        details.clear();
+        while ((rc = sqlite3_step(s)) == SQLITE_ROW) {
+            const unsigned char *d = sqlite3_column_text(s, 3);
+            details.emplace_back(d ? reinterpret_cast<const char*>(d) : "");
+        }
         sqlite3_finalize(s);
+        return (rc == SQLITE_DONE);
+    } // explainQueryPlan
+
+
+public: // save the in-memory database
+    /**
+     * @brief Write the in-memory database back to the file by the online backup.
+     *     The pages are copied step by step, the connection is released between the steps,
+     *     so the other threads can still use the database while saving.
+     *     The changes made through the main connection during the save are also copied.
+     * @param pages_per_step The number of pages copied per step, -1 for all in one step.
+     * @return true if saved; otherwise, false.
+     */
+    bool save(int pages_per_step = Config::backup_pages_per_step) {
+        std::lock_guard<std::mutex> lock(save_mtx);
+        if (!isInMemory()) {
+            std::cerr << "DbManager4Sqlite::save: not connected in memory" << std::endl;
+            return false;
+        }
+
+        sqlite3 *file_db = nullptr;
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+        int rc = sqlite3_open_v2(backing_file.c_str(), &file_db, flags, nullptr);
+        if (rc == SQLITE_OK) {
+            rc = copyDatabase(file_db, db, pages_per_step);
+        }
+        sqlite3_close_v2(file_db);
+
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::save: failed to save " << backing_file
+                << ": " << sqlite3_errstr(rc) << std::endl;
+            return false;
+        }
+        return true;
+    } // save
+
+    /**
+     * @brief Save the in-memory database in the background thread.
+     * @param pages_per_step The number of pages copied per step.
+     * @return The future of the save result.
+     */
+    std::future<bool> saveAsync(int pages_per_step = Config::backup_pages_per_step) {
+        return std::async(std::launch::async,
+            [this, pages_per_step] { return save(pages_per_step); });
+    } // saveAsync
+
+    /**
+     * @brief Start the timer thread saving the in-memory database periodically,
+     *     the previous timer is stopped.
+     * @param interval The interval between the saves.
+     * @return true if started; otherwise, false.
+     */
+    bool startAutoSave(std::chrono::milliseconds interval) {
+        stopAutoSave();
+        if (!isInMemory() || (interval.count() <= 0)) {
+            std::cerr << "DbManager4Sqlite::startAutoSave: not connected in memory or invalid interval" << std::endl;
+            return false;
+        }
+
+        autosave_stop = false;
+        autosave_thread = std::thread([this, interval] {
+            std::unique_lock<std::mutex> lock(autosave_mtx);
+            while (!autosave_cv.wait_for(lock, interval, [this] { return autosave_stop; })) {
+                lock.unlock();
+                save();
+                lock.lock();
+            }
+        });
+        return true;
+    } // startAutoSave
+
+    /**
+     * @brief Stop the timer thread started by startAutoSave, wait for the running save.
+     */
+    void stopAutoSave() {
+        {
+            std::lock_guard<std::mutex> lock(autosave_mtx);
+            autosave_stop = true;
+        }
+        autosave_cv.notify_all();
+        if (autosave_thread.joinable()) {
+            autosave_thread.join();
+        }
+    } // stopAutoSave
+
+
+public: // read only connections for parallel read
+    /**
+     * @brief Check if the other connections can open the connected database.
+     *     The private in-memory database, such as ":memory:" or "file::memory:" without
+     *     the shared cache, is a new empty database for each connection opening it.
+     * @return true if the read connections can be opened; otherwise, false.
+     */
+    bool canOpenReadConnection() const {
+        if (!isConnected()) {
+            return false;
+        }
+
+        const std::string &c = connect_param;
+        if (c == ":memory:") {
+            return false;
+        }
+        if (c.rfind("file:", 0) == 0) {
+            // memdb is shared by the connections only if its name starts with "/", see connectInMemory
+            if (c.find("vfs=memdb") != std::string::npos) {
+                return c.compare(5, 1, "/") == 0;
+            }
+            if ((c.rfind("file::memory:", 0) == 0) || (c.find("mode=memory") != std::string::npos)) {
+                return c.find("cache=shared") != std::string::npos;
+            }
+        }
+        return true;
+    } // canOpenReadConnection
+
+    /**
+     * @brief Open a read only connection to the connected database.
+     *     Each connection should be used by one thread only.
+     * @return The connection handler; nullptr if failed or not shareable, see canOpenReadConnection.
+     */
+    Connection openReadConnection() {
+        if (!isConnected()) {
+            std::cerr << "DbManager4Sqlite::openReadConnection: not connected" << std::endl;
+            return nullptr;
+        }
+        if (!canOpenReadConnection()) {
+            std::cerr << "DbManager4Sqlite::openReadConnection: the private in-memory database "
+                << connect_param << " cannot be opened by another connection" << std::endl;
+            return nullptr;
+        }
+
+        sqlite3 *conn = nullptr;
+        int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI;
+        int rc = sqlite3_open_v2(connect_param.c_str(), &conn, flags, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::openReadConnection[sqlite3_open_v2] failed!" << std::endl;
+            EDADB_SQLITE_LOG_ERROR(rc, conn, "Failed to open read connection using param: " + connect_param);
+            sqlite3_close_v2(conn);
+            return nullptr;
+        }
+
+        registerTrace(conn);
+        sqlite3_busy_handler(conn, &DbManagerImpl::busyHandler, nullptr);
+        return conn;
+    } // openReadConnection
+
+    /**
+     * @brief Close the read only connection opened by openReadConnection.
+     * @param conn The connection handler.
+     * @return true if closed; otherwise, false.
+     */
+    bool closeReadConnection(Connection conn) {
+        if (conn == nullptr) return true;
+
+        int rc = sqlite3_close_v2(conn);
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::closeReadConnection[sqlite3_close_v2] failed!" << std::endl;
+            std::cerr << "Error: " << sqlite3_errmsg(conn) << std::endl;
+            return false;
+        }
+        return true;
+    } // closeReadConnection
+
+
+    /**
+     * @brief Acquire a read only connection of WAL mode for a Reader,
+     *     another connection is opened if all in the pool are in use.
+     * @return The connection to read on; nullptr for the main connection,
+     *     if not in WAL mode or the calling thread is in a transaction of the main connection.
+     */
+    Connection acquireReadConnection() {
+        if ((reader_pool_size == 0) || (txn_thread.load() == std::this_thread::get_id())) {
+            return nullptr;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            if (!idle_readers.empty()) {
+                sqlite3 *conn = idle_readers.back();
+                idle_readers.pop_back();
+                return conn;
+            }
+        }
+        return openReadConnection();
+    } // acquireReadConnection
+
+    /**
+     * @brief Release the connection acquired by acquireReadConnection,
+     *     the statements on it must be finalized.
+     * @param conn The connection handler.
+     */
+    void releaseReadConnection(Connection conn) {
+        if (conn == nullptr) return;
+
+        {
+            std::lock_guard<std::mutex> lock(reader_mtx);
+            if (idle_readers.size() < reader_pool_size) {
+                idle_readers.push_back(conn);
+                return;
+            }
+        }
+        closeReadConnection(conn);
+    } // releaseReadConnection
+
+
+public: // snapshot shared by the read connections
+    /**
+     * @brief Begin the read transactions of the read connections on the same commit,
+     *     so they read one database snapshot, such as the tables loaded in parallel.
+     *     In WAL mode, the commit is shared by sqlite3_snapshot_get/open if sqlite3 is built
+     *     with SQLITE_ENABLE_SNAPSHOT; otherwise, the commits of the main connection are held
+     *     by its mutex only while the read transactions begin, and the writer goes on after.
+     *     Not in WAL mode, the read transactions hold the commits off until endSnapshot.
+     * @param conns The read connections opened by openReadConnection, not in a transaction.
+     * @return true if begun; otherwise, false, no read transaction is left.
+     */
+    bool beginSnapshot(const std::vector<Connection> &conns) {
+        if (!isConnected()) {
+            std::cerr << "DbManager4Sqlite::beginSnapshot: not connected" << std::endl;
+            return false;
+        }
+
+#if defined(SQLITE_ENABLE_SNAPSHOT)
+        if (wal_mode && beginSharedSnapshot(conns)) {
+            return true;
+        }
+#endif
+
+        // no commit of the main connection between the read transactions,
+        // the mutex is nullptr and not entered if the connection is not serialized
+        sqlite3_mutex *mtx = sqlite3_db_mutex(db);
+        sqlite3_mutex_enter(mtx);
+        bool ok = true;
+        for (auto conn : conns) {
+            ok = ok && beginRead(conn);
+        }
+        sqlite3_mutex_leave(mtx);
+
+        if (!ok) {
+            std::cerr << "DbManager4Sqlite::beginSnapshot: begin the read transactions failed" << std::endl;
+            endSnapshot(conns);
+        }
+        return ok;
+    } // beginSnapshot
+
+    /**
+     * @brief End the read transactions begun by beginSnapshot,
+     *     the statements on the connections must be finalized or reset.
+     * @param conns The read connections.
+     * @return true if ended; otherwise, false.
+     */
+    bool endSnapshot(const std::vector<Connection> &conns) {
+        bool ok = true;
+        for (auto conn : conns) {
+            if ((conn != nullptr) && !sqlite3_get_autocommit(conn)) {
+                int rc = sqlite3_exec(conn, "COMMIT;", nullptr, nullptr, nullptr);
+                if (rc != SQLITE_OK) {
+                    EDADB_SQLITE_LOG_ERROR(rc, conn, "Failed to end the read transaction");
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    } // endSnapshot
 
-        return rc == SQLITE_ROW;
-    } // table
+
+public: // checkpoint of WAL mode
+    /**
+     * @brief Checkpoint the WAL passively: copy the frames no reader still uses back to the database,
+     *     without waiting for the readers and the writer.
+     *   The manual checkpoint and the background thread share the checkpoint connection,
+     *   so they are serialized.
+     * @return true if checkpointed or busy by another checkpoint; otherwise, false.
+     */
+    bool checkpoint() {
+        if (!wal_mode) {
+            std::cerr << "DbManager4Sqlite::checkpoint: not connected in WAL mode" << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(ckpt_db_mtx);
+        sqlite3 *conn = (ckpt_db != nullptr) ? ckpt_db : db;
+        int rc = sqlite3_wal_checkpoint_v2(conn, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+        if ((rc != SQLITE_OK) && (rc != SQLITE_BUSY)) {
+            EDADB_SQLITE_LOG_ERROR(rc, conn, "Failed to checkpoint the WAL");
+            return false;
+        }
+        return true;
+    } // checkpoint
+
+    /**
+     * @brief Start the thread checkpointing the WAL periodically on its own connection,
+     *     the previous thread is stopped.
+     * @param interval The interval between the checkpoints.
+     * @return true if started; otherwise, false.
+     */
+    bool startCheckpoint(std::chrono::milliseconds interval) {
+        stopCheckpoint();
+        if (!wal_mode || (interval.count() <= 0)) {
+            std::cerr << "DbManager4Sqlite::startCheckpoint: not connected in WAL mode or invalid interval" << std::endl;
+            return false;
+        }
+
+        sqlite3 *conn = nullptr;
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI;
+        int rc = sqlite3_open_v2(connect_param.c_str(), &conn, flags, nullptr);
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbManager4Sqlite::startCheckpoint[sqlite3_open_v2] failed!" << std::endl;
+            EDADB_SQLITE_LOG_ERROR(rc, conn, "Failed to open checkpoint connection using param: " + connect_param);
+            sqlite3_close_v2(conn);
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(ckpt_db_mtx);
+            ckpt_db = conn;
+        }
+
+        ckpt_stop = false;
+        ckpt_thread = std::thread([this, interval] {
+            std::unique_lock<std::mutex> lock(ckpt_mtx);
+            while (!ckpt_cv.wait_for(lock, interval, [this] { return ckpt_stop; })) {
+                lock.unlock();
+                checkpoint();
+                lock.lock();
+            }
+        });
+        return true;
+    } // startCheckpoint
+
+    /**
+     * @brief Stop the thread started by startCheckpoint, wait for the running checkpoint.
+     */
+    void stopCheckpoint() {
+        {
+            std::lock_guard<std::mutex> lock(ckpt_mtx);
+            ckpt_stop = true;
+        }
+        ckpt_cv.notify_all();
+        if (ckpt_thread.joinable()) {
+            ckpt_thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock(ckpt_db_mtx);
+        sqlite3_close_v2(ckpt_db);
+        ckpt_db = nullptr;
+    } // stopCheckpoint
 
 
 
@@ -200,10 +991,13 @@ public: // sqlite3 statement operation
     /**
      * @brief Initialize the SQL statement
      * @param stmt The sqlite3 statement
+     * @param conn The connection to run the statement, nullptr for the main connection
      * @return true if initialized; otherwise, false
      */
-    bool initStatement(DbStatementImpl<DbBackendType::SQLITE> &dbstmt) {
-        dbstmt.db = db;
+    bool initStatement(DbStatementImpl<DbBackendType::SQLITE> &dbstmt,
+            Connection conn = nullptr) {
+        // use the main connection if no connection specified
+        dbstmt.db = (conn != nullptr) ? conn : db;
         dbstmt.stmt = nullptr;
         dbstmt.zErrMsg = nullptr;
 
@@ -218,8 +1012,81 @@ public: // sqlite3 statement operation
         return sqlite3_changes(db);
     }
 
+    /**
+     * @brief Get the rowid of the last row inserted on the connection.
+     * @param conn The connection inserted on, nullptr for the main connection.
+     * @return The rowid, the INTEGER PRIMARY KEY of the row; 0 if none inserted.
+     */
+    int64_t lastInsertRowid(Connection conn = nullptr) {
+        return sqlite3_last_insert_rowid((conn != nullptr) ? conn : db);
+    }
+
+    /**
+     * @brief The rowid key is assigned by sqlite3 on insert, see s_assign_rowid_key.
+     * @return false.
+     */
+    bool nextRowidKey(const std::string &name, const std::string &col, int64_t &key) {
+        (void)col;
+        (void)key;
+        std::cerr << "DbManager4Sqlite::nextRowidKey: assigned on insert for " << name << std::endl;
+        return false;
+    }
+
 
 private:
+    /**
+     * @brief set up the main connection after opened.
+     * @return true if success; otherwise, false.
+     */
+    bool setupConnection(void) {
+        // wait for the locks held by the other connections with the backoff
+        sqlite3_busy_handler(db, &DbManagerImpl::busyHandler, nullptr);
+
+        // enable foreign key constraint
+        if (!exec("PRAGMA foreign_keys = ON;")) {
+            std::cerr << "DbManager4Sqlite::connect[PRAGMA foreign_keys] failed!" << std::endl;
+            return false;
+        }
+
+        if (!checkForeignKeyEnabled()) {
+            std::cerr << "DbManager4Sqlite::connect: foreign key constraint is not enabled!" << std::endl;
+            return false;
+        }
+
+        // register the trace callback, which returns at once unless SqlTrace is enabled
+        registerTrace(db);
+
+        return true;
+    } // setupConnection
+
+    /**
+     * @brief copy the main database from src to dst by the online backup API.
+     *     Sleep between the steps to release the locks of src,
+     *     and retry the step if the databases are busy or locked.
+     * @param dst The destination connection.
+     * @param src The source connection.
+     * @param pages_per_step The number of pages copied per step, -1 for all.
+     * @return SQLITE_OK if success; otherwise, the error code.
+     */
+    static int copyDatabase(sqlite3 *dst, sqlite3 *src, int pages_per_step) {
+        sqlite3_backup *bak = sqlite3_backup_init(dst, "main", src, "main");
+        if (bak == nullptr) {
+            return sqlite3_errcode(dst);
+        }
+
+        int rc = SQLITE_OK;
+        do {
+            rc = sqlite3_backup_step(bak, pages_per_step);
+            if ((rc == SQLITE_OK) || (rc == SQLITE_BUSY) || (rc == SQLITE_LOCKED)) {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(Config::backup_step_sleep_ms));
+            }
+        } while ((rc == SQLITE_OK) || (rc == SQLITE_BUSY) || (rc == SQLITE_LOCKED));
+
+        int finish_rc = sqlite3_backup_finish(bak);
+        return (rc == SQLITE_DONE) ? finish_rc : rc;
+    } // copyDatabase
+
     /**
      * @brief check if foreign key constraint is enabled.
      * @return true if enabled; otherwise, false.
@@ -242,12 +1109,30 @@ private:
     } // checkForeignKeyEnabled
 
 
+private: // sqlite3 busy handler
+    /**
+     * @brief called by sqlite3 when the database is locked by another connection.
+     * @param count The number of calls before for the same lock event.
+     * @return non-zero to retry; 0 to fail the call with SQLITE_BUSY.
+     */
+    static int busyHandler(void * /*ctx*/, int count) {
+        if (BusyRetry::i().wait(count)) {
+            return 1;
+        }
+        BusyRetry::handlerTimedOut() = true;
+        return 0;
+    } // busyHandler
+
+
 private: // sqlite3 trace API
-    void registerTrace() {
-        // only register once per db handle; you can guard with a flag if you like
+    /**
+     * @brief register the trace callback on the connection,
+     *     SqlTrace and SlowQueryLog switch it at runtime.
+     */
+    void registerTrace(sqlite3 *conn) {
         sqlite3_trace_v2(
-            db,
-            SQLITE_TRACE_STMT,
+            conn,
+            SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE,
             &DbManagerImpl::traceCallback,
             nullptr
         );
@@ -257,42 +1142,59 @@ private: // sqlite3 trace API
         unsigned   type,
         void*      /*ctx*/,
         void*      pStmt,
-        void*      /*unused*/
+        void*      x
     ) {
-        if(type != SQLITE_TRACE_STMT) 
+        if (type == SQLITE_TRACE_PROFILE) {
+            return profileCallback(reinterpret_cast<sqlite3_stmt*>(pStmt),
+                *reinterpret_cast<sqlite3_int64*>(x));
+        }
+
+        if ((type != SQLITE_TRACE_STMT) || !SqlTrace::traced())
             return 0;
 
         auto *stmt = reinterpret_cast<sqlite3_stmt*>(pStmt);
 
-        // prepared statement, with placeholders 
-        std::string raw_sql = sqlite3_sql(stmt);
-
-        std::string exp_sql;
+        // prepared statement with place holders, and the expanded one with bound values
+        char *exp = nullptr;
         #if SQLITE_VERSION_NUMBER >= 3014000
-            // exepanded SQL, with bound values
-            if(char *exp = sqlite3_expanded_sql(stmt)) {
-                exp_sql.assign(exp);
-                sqlite3_free(exp);
-            }
+            if (SqlTrace::i().getExpand())
+                exp = sqlite3_expanded_sql(stmt);
         #endif
 
-        if (!exp_sql.empty())  {
-            if (raw_sql == exp_sql) {
-                std::cout << "[EDADB DEBUG TRACE] << SQL STATEMENT: " << std::endl;
-                std::cout << "    " << raw_sql << std::endl;
-            } else {
-                std::cout << "[EDADB DEBUG TRACE] << RAW SQL STATEMENT: " << std::endl;
-                std::cout << "    " << raw_sql << std::endl;
-
-                std::cout << "[EDADB DEBUG TRACE] << EXPANDED SQL STATEMENT: " << std::endl;
-                std::cout << "    " << exp_sql << std::endl;
-            } // if
-        } // if
-        std::cout << std::endl;
+        SqlTrace::i().record(sqlite3_sql(stmt), exp);
+        sqlite3_free(exp);
 
         return 0;
     } // traceCallback
 
+    /**
+     * @brief report the finished statement to the slow query log.
+     *     The duration is the wall time from the first step to the end of the run,
+     *     so a query includes the time the caller spends between the fetches.
+     *     sqlite3 measures it by the os clock in milliseconds.
+     * @param stmt The statement.
+     * @param ns The duration in nanoseconds.
+     */
+    static int profileCallback(sqlite3_stmt *stmt, sqlite3_int64 ns) {
+        if (!SlowQueryLog::enabled())
+            return 0;
+
+        // the counters are reset on each run, so they belong to this run
+        SlowQueryRecord r;
+        r.fullscan_steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+        r.sorts          = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+        r.autoindex      = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+        r.vm_steps       = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+
+        r.duration_ns = static_cast<uint64_t>(ns);
+        if (!SlowQueryLog::mayRecord(r.duration_ns))
+            return 0;
+
+        r.sql = sqlite3_sql(stmt);
+        SlowQueryLog::i().record(stmt, std::move(r));
+        return 0;
+    } // profileCallback
+
 
 private: // utility functions
     /**
@@ -308,12 +1210,168 @@ private: // utility functions
         } // while
     } // finalize_all_stmt
 
-}; // DbManagerImpl<DbBackendType::SQLITE>
+    /**
+     * @brief get the first keyword of the statement in upper case.
+     * @param sql The statement.
+     */
+    /**
+     * @brief step the statement to the end, the rows are discarded as sqlite3_exec,
+     *     retry the step after the backoff while busy or locked, see sqliteRetryable.
+     * @param s The statement.
+     * @param commit true if the statement is COMMIT or END.
+     * @return SQLITE_OK if done; otherwise, the result code of the failed step.
+     */
+    int stepAll(sqlite3_stmt *s, bool commit) {
+        BusyRetry::handlerTimedOut() = false;
+        for (int n = 0; ; ) {
+            const int rc = sqlite3_step(s);
+            if (rc == SQLITE_ROW) {
+                continue;
+            }
+            if (rc == SQLITE_DONE) {
+                return SQLITE_OK;
+            }
+            if (!sqliteRetryable(rc, db, commit) || BusyRetry::handlerTimedOut() ||
+                    !BusyRetry::i().wait(n++)) {
+                return rc;
+            }
+        }
+    } // stepAll
+
+    static std::string firstKeyword(const std::string &sql) {
+        size_t b = 0;
+        while ((b < sql.size()) && std::isspace(static_cast<unsigned char>(sql[b]))) ++b;
+        size_t e = b;
+        while ((e < sql.size()) && std::isalpha(static_cast<unsigned char>(sql[e]))) ++e;
+
+        std::string word = sql.substr(b, e - b);
+        for (auto &c : word) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return word;
+    } // firstKeyword
+
+    static bool isTransactionControl(const std::string &word) {
+        return (word == "BEGIN") || (word == "COMMIT") || (word == "END") ||
+               (word == "ROLLBACK") || (word == "SAVEPOINT") || (word == "RELEASE");
+    }
+
+    /**
+     * @brief check if the statement may change the schema, only the transaction
+     *     statements except rollback keep the table names cached.
+     * @param word The first keyword of the statement executed.
+     */
+    static bool mayChangeSchema(const std::string &word) {
+        return !isTransactionControl(word) || (word == "ROLLBACK");
+    } // mayChangeSchema
+
+    /**
+     * @brief query the text of the first column of the first row, such as the pragma value.
+     * @param sql The statement.
+     * @param out The text queried.
+     * @return true if a row is returned; otherwise, false.
+     */
+    bool queryText(const std::string &sql, std::string &out) {
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
+            return false;
+        }
 
+        bool found = (sqlite3_step(s) == SQLITE_ROW);
+        if (found) {
+            const unsigned char *text = sqlite3_column_text(s, 0);
+            out = (text != nullptr) ? reinterpret_cast<const char *>(text) : "";
+        }
+        sqlite3_finalize(s);
+        return found;
+    } // queryText
 
+    /**
+     * @brief begin the read transaction of the connection, which reads the latest commit.
+     * @param conn The read connection.
+     * @return true if begun; otherwise, false.
+     */
+    static bool beginRead(sqlite3 *conn) {
+        // BEGIN is deferred, the read transaction starts at the first read
+        int rc = sqlite3_exec(conn, "BEGIN; SELECT count(*) FROM sqlite_master;", nullptr, nullptr, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, conn, "Failed to begin the read transaction");
+            return false;
+        }
+        return true;
+    } // beginRead
 
-// if Config::backend_type is SQLITE, use DbStatement4Sqlite as DbStatement
-using DbManager = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE, 
-        DbManagerImpl<DbBackendType::SQLITE> >;
+#if defined(SQLITE_ENABLE_SNAPSHOT)
+    /**
+     * @brief open the snapshot of the first connection on the others, WAL mode only.
+     * @param conns The read connections.
+     * @return true if opened; otherwise, false, no read transaction is left.
+     */
+    bool beginSharedSnapshot(const std::vector<Connection> &conns) {
+        if (conns.empty()) return true;
+
+        sqlite3_snapshot *snap = nullptr;
+        bool ok = beginRead(conns.front()) &&
+            (sqlite3_snapshot_get(conns.front(), "main", &snap) == SQLITE_OK);
+        for (size_t i = 1; ok && (i < conns.size()); ++i) {
+            ok = (sqlite3_exec(conns[i], "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK) &&
+                 (sqlite3_snapshot_open(conns[i], "main", snap) == SQLITE_OK);
+        }
+        if (snap != nullptr) {
+            sqlite3_snapshot_free(snap);
+        }
+
+        if (!ok) {
+            endSnapshot(conns);
+        }
+        return ok;
+    } // beginSharedSnapshot
+#endif
+
+    /**
+     * @brief close the idle read only connections of WAL mode,
+     *     the connections still acquired are closed on release.
+     */
+    void closeReaderPool(void) {
+        std::lock_guard<std::mutex> lock(reader_mtx);
+        for (auto conn : idle_readers) {
+            closeReadConnection(conn);
+        }
+        idle_readers.clear();
+        reader_pool_size = 0;
+        wal_mode = false;
+    } // closeReaderPool
+
+    /**
+     * @brief check the rows of the table refer to the existing parent rows.
+     * @param name The table name.
+     * @return true if no violation; otherwise, false.
+     */
+    bool foreignKeyCheck(const std::string &name) {
+        const std::string sql = "PRAGMA foreign_key_check(\"" + name + "\");";
+        sqlite3_stmt* s = nullptr;
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &s, nullptr);
+        if (rc != SQLITE_OK) {
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to prepare SQL: " + sql);
+            return false;
+        }
+
+        int violations = 0;
+        while (sqlite3_step(s) == SQLITE_ROW) ++violations;
+        sqlite3_finalize(s);
+        if (violations > 0) {
+            std::cerr << "DbManager4Sqlite::foreignKeyCheck: " << violations
+                << " rows of " << name << " refer to no parent row" << std::endl;
+        }
+        return violations == 0;
+    } // foreignKeyCheck
+
+    void invalidateTableNames(void) {
+        std::lock_guard<std::mutex> lock(table_mtx);
+        table_names_loaded = false;
+        table_names.clear();
+    }
+
+}; // DbManagerImpl<DbBackendType::SQLITE>
 
 } // namespace edadb
\ No newline at end of file
@@ -12,6 +12,10 @@
 
 #include "edadb/DbBackendType.h"
 #include "edadb/DbStatement.h"
+#include "edadb/TraitUtils.h"
+#include "edadb/BlobLayout.h"
+#include "edadb/SlowQueryLog.h"
+#include "edadb/BusyRetry.h"
 #include "Macro4Sqlite.h"
 
 
@@ -23,6 +27,9 @@ namespace edadb {
  */
 template <>
 struct DbStatementImpl<DbBackendType::SQLITE> {
+    // no appender, insert by the prepared statement
+    static constexpr bool has_appender = false;
+
     // sqlite3 database connection handler
     sqlite3 *db = nullptr;
 
@@ -32,6 +39,9 @@ struct DbStatementImpl<DbBackendType::SQLITE> {
     // sqlite manager error message internal, no need to free
     // @see https://www.sqlite.org/c3ref/errcode.html
     const char *zErrMsg = nullptr;
+
+    // labeled in SlowQueryLog, unlabeled on finalize
+    bool labeled = false;
     
 public:
     DbStatementImpl () = default;
@@ -65,6 +75,25 @@ public:
         return prepared;
     }
 
+    /**
+     * @brief label the prepared statement with the originating table and operation,
+     *     reported by the slow query log. Nothing is done if the log is disabled.
+     */
+    void setLabel(const std::string &table, const char *op) {
+        if (!SlowQueryLog::enabled() || stmtIsNull()) return;
+        SlowQueryLog::i().label(stmt, table, op);
+        labeled = true;
+    }
+
+    /**
+     * @brief no appender in sqlite3, use prepare with the insert statement instead
+     * @return false.
+     */
+    bool prepareAppend(const std::string &table) {
+        std::cerr << "DbStatementImpl::prepareAppend: not supported, table " << table << std::endl;
+        return false;
+    }
+
     /**
      * @brief clear all of the binding placeholder in the SQL statement
      * @return true if cleared; otherwise, false.
@@ -105,6 +134,11 @@ public:
             EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to finalize SQL statement");
         }
 
+        // the statement is profiled on finalize, unlabel after
+        if (labeled) {
+            SlowQueryLog::i().unlabel(stmt);
+            labeled = false;
+        }
         stmt = nullptr;
         return finalized;
     }
@@ -208,29 +242,91 @@ public: // insert column
     }
 
 
+    /**
+     * @brief bind vector of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        bindColumn(int index, std::vector<E, Alloc> *value) {
+        return bindBlob(index, value->data(), value->size());
+    }
+
+    /**
+     * @brief bind std::array of POD to the blob column
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        bindColumn(int index, std::array<E, N> *value) {
+        return bindBlob(index, value->data(), N);
+    }
+
+    /**
+     * @brief bind the elements to the blob column:
+     *   bind the memory directly if no byte swap needed (the object must be alive until step),
+     *   otherwise, bind the encoded copy.
+     * @return true if binded; otherwise, false.
+     */
+    template <typename E>
+    bool bindBlob(int index, const E *data, size_t n) {
+        int rc = SQLITE_OK;
+        const size_t bytes = n * sizeof(E);
+        if (n == 0) {
+            // empty blob, not null
+            rc = sqlite3_bind_zeroblob(stmt, index, 0);
+        } else if constexpr (BlobLayout::need_swap) {
+            std::vector<unsigned char> buf(bytes);
+            BlobLayout::encode(data, n, buf.data());
+            rc = sqlite3_bind_blob64(stmt, index, buf.data(), bytes, SQLITE_TRANSIENT);
+        } else {
+            rc = sqlite3_bind_blob64(stmt, index, data, bytes, SQLITE_STATIC);
+        }
+
+        if (rc != SQLITE_OK) {
+            std::cerr << "DbStatementImpl::bindBlob: sqlite3_bind_blob64 failed!" << std::endl;
+            EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to bind column at index " + std::to_string(index));
+        }
+        return (rc == SQLITE_OK);
+    }
+
+
     /**
      * @brief bind the column and execute the SQL statement.
      * @return true if inserted; otherwise, false.
      */
     bool bindStep() {
-        int rc = sqlite3_step(stmt);
+        int rc = step();
         bool stepped = (rc == SQLITE_DONE);
         if (!stepped) {
             std::cerr << "DbStatementImpl::bindStep: sqlite3_step failed!" << std::endl;
             EDADB_SQLITE_LOG_ERROR(rc, db, "Failed to step SQL statement");
         }
 
-        #if _DEADB_DEBUG_TRACE_SQL_STMT_
-            // use sqlite3_changes to check the number of rows changed
-            int changes = sqlite3_changes(db);
-            std::cout << "## [Debug EDADB] DbStatement::bindStep sqlite3_changes: "
-                    << changes << std::endl;
-        #endif
-
         return stepped;
     }
 
 
+private:
+    /**
+     * @brief step the statement, retry after the backoff while busy or locked.
+     *     The busy handler of the connection waits for the database lock first,
+     *     the retry here covers the results the handler is not called for, such as SQLITE_LOCKED.
+     *     SQLITE_BUSY_SNAPSHOT and SQLITE_BUSY inside a transaction are returned at once,
+     *     the caller must roll back the transaction, see sqliteRetryable.
+     * @return The result code of the last step.
+     */
+    int step() {
+        BusyRetry::handlerTimedOut() = false;
+        int rc = sqlite3_step(stmt);
+        for (int n = 0; sqliteRetryable(rc, db) && !BusyRetry::handlerTimedOut(); ++n) {
+            if (!BusyRetry::i().wait(n)) break;
+            rc = sqlite3_step(stmt);
+        }
+        return rc;
+    } // step
+
+
 public: // schema info
     /**
      * @brief Get the column count of the statement.
@@ -258,6 +354,15 @@ public: // schema info
         return sqlite3_column_name(stmt, index);
     }
 
+    /**
+     * @brief Get the declared column type of the statement.
+     * @param index The column index
+     * @return The declared type, such as "INTEGER"; nullptr if the column is an expression.
+     */
+    const char *getColumnDeclType(int index) {
+        return sqlite3_column_decltype(stmt, index);
+    }
+
 
 public: // fetch column
     /**
@@ -270,7 +375,7 @@ public: // fetch column
             std::cout << "DbManager::fetchStep" << std::endl;
         #endif
 
-        int rc = sqlite3_step(stmt);
+        int rc = step();
         // get one row or read done
         if ((rc != SQLITE_ROW) && (rc != SQLITE_DONE)) {
             std::cerr << "DbStatementImpl::fetchStep: sqlite3_step failed!" << std::endl;
@@ -341,6 +446,22 @@ public: // fetch column
         return true;
     }
 
+    /**
+     * @brief fetch the raw bytes of the text/blob column without copy,
+     *     the bytes are valid until the next step or finalize.
+     * @return true if fetched; otherwise, false.
+     */
+    bool fetchText(int index, const char **value, size_t *bytes) {
+        *value = (const char*)sqlite3_column_text(stmt, index);
+        *bytes = sqlite3_column_bytes(stmt, index);
+        return true;
+    }
+    bool fetchBlob(int index, const void **value, size_t *bytes) {
+        *value = sqlite3_column_blob(stmt, index);
+        *bytes = sqlite3_column_bytes(stmt, index);
+        return true;
+    }
+
     /**
      * @brief fetch wstring type
      * @return true if fetched; otherwise, false.
@@ -355,12 +476,45 @@ public: // fetch column
         *value = (const wchar_t*)sqlite3_column_text16(stmt, index);
         return true;
     }
-}; // DbStatementImpl
 
+    /**
+     * @brief fetch vector of POD from the blob column
+     * @return true if fetched; false if the blob size is not a multiple of the element size.
+     */
+    template <typename E, typename Alloc>
+    std::enable_if_t<is_blob<std::vector<E, Alloc>>::value, bool>
+        fetchColumn(int index, std::vector<E, Alloc> *value) {
+        const unsigned char *bin = (const unsigned char*)sqlite3_column_blob(stmt, index);
+        size_t bytes = sqlite3_column_bytes(stmt, index);
+        if (bytes % sizeof(E) != 0) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
+
+        value->resize(bytes / sizeof(E));
+        if (bytes > 0)
+            BlobLayout::decode(bin, value->size(), value->data());
+        return true;
+    }
 
+    /**
+     * @brief fetch std::array of POD from the blob column
+     * @return true if fetched; false if the blob size is not the array size.
+     */
+    template <typename E, std::size_t N>
+    std::enable_if_t<is_blob<std::array<E, N>>::value, bool>
+        fetchColumn(int index, std::array<E, N> *value) {
+        const unsigned char *bin = (const unsigned char*)sqlite3_column_blob(stmt, index);
+        size_t bytes = sqlite3_column_bytes(stmt, index);
+        if (bytes != N * sizeof(E)) {
+            std::cerr << "DbStatementImpl::fetchColumn: invalid blob size " << bytes << std::endl;
+            return false;
+        }
 
-// if Config::backend_type is SQLITE, use DbStatement4Sqlite as DbStatement
-using DbStatement = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE, 
-        DbStatementImpl<DbBackendType::SQLITE>>;
+        if (bytes > 0)
+            BlobLayout::decode(bin, N, value->data());
+        return true;
+    }
+}; // DbStatementImpl
 
 } // namespace edadb
\ No newline at end of file
@@ -6,24 +6,79 @@
 #pragma once
 
 #include <iostream>
+#include <string>
 #include <assert.h>
 #include <sqlite3.h>
 
+#include "edadb/DbError.h"
+
+namespace edadb {
+
+/**
+ * @brief map the sqlite3 result code to DbErrorCode.
+ * @param rc The (extended) result code.
+ */
+inline DbErrorCode sqliteErrorCode(int rc) {
+    switch (rc & 0xff) {
+    case SQLITE_OK:
+    case SQLITE_ROW:
+    case SQLITE_DONE:       return DbErrorCode::OK;
+    case SQLITE_BUSY:       return DbErrorCode::BUSY;
+    case SQLITE_LOCKED:     return DbErrorCode::LOCKED;
+    case SQLITE_CONSTRAINT: return DbErrorCode::CONSTRAINT;
+    case SQLITE_MISUSE:     return DbErrorCode::MISUSE;
+    case SQLITE_RANGE:      return DbErrorCode::RANGE;
+    case SQLITE_IOERR:
+    case SQLITE_FULL:
+    case SQLITE_CORRUPT:
+    case SQLITE_CANTOPEN:
+    case SQLITE_READONLY:   return DbErrorCode::IO;
+    default:                return DbErrorCode::ERROR;
+    }
+}
+
+/**
+ * @brief check if the result code is transient, the step can be retried after a wait.
+ *     SQLITE_BUSY_SNAPSHOT and SQLITE_BUSY inside a transaction never clear until the transaction
+ *     is rolled back, such as the read transaction upgrading to write after another writer committed,
+ *     so they are returned at once; except COMMIT, which waits for the readers to finish.
+ * @param rc The result code.
+ * @param db The connection of the statement.
+ * @param commit true if the statement is COMMIT or END.
+ */
+inline bool sqliteRetryable(int rc, sqlite3 *db, bool commit = false) {
+    if (rc == SQLITE_BUSY_SNAPSHOT) {
+        return false;
+    }
+    if ((rc & 0xff) == SQLITE_BUSY) {
+        return commit || (sqlite3_get_autocommit(db) != 0);
+    }
+    return (rc & 0xff) == SQLITE_LOCKED;
+}
+
+} // namespace edadb
+
 /**
  * @macro EDADB_SQLITE_LOG_ERROR
  * @brief Macro to log SQLite errors with error code and message
  * @param rc The return code from SQLite operation
  * @param db_handle The SQLite database handle
  * @param msg The custom message to log
- * @note This macro will print the error code, error string, and custom message to std::cerr
+ * @note This macro will print the error code, error string, and custom message to std::cerr,
+ *     and keep the error for edadb::lastError(). Only the API misuse asserts,
+ *     the busy and constraint errors are returned to the caller.
  */
 #define EDADB_SQLITE_LOG_ERROR(rc, db_handle, msg)                        \
     do {                                                            \
+        const int edadb_sqlite_rc_ = (db_handle != nullptr) ?       \
+            sqlite3_extended_errcode(db_handle) : (rc);             \
         std::cerr << "SQLite Error (" << (rc) << " "                \
                   << sqlite3_errstr(rc) << "): "                    \
                   << (msg) << ". Errmsg: "                          \
                   << sqlite3_errmsg(db_handle) << std::endl;        \
-        assert(false);                                              \
+        edadb::setLastError(edadb::sqliteErrorCode(rc),             \
+            (((edadb_sqlite_rc_ & 0xff) == ((rc) & 0xff)) ?         \
+                edadb_sqlite_rc_ : (rc)),                           \
+            std::string(msg) + ": " + sqlite3_errmsg(db_handle));   \
+        assert(((rc) & 0xff) != SQLITE_MISUSE);                     \
     } while (0)
-
-
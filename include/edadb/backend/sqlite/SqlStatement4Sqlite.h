@@ -7,6 +7,7 @@
 
 #include <assert.h>
 #include <vector>   
+#include <cctype>
 #include <iostream>
 #include <sstream>
 
@@ -30,6 +31,10 @@ namespace edadb {
  */
 template<typename T>
 struct SqlStatementImpl<DbBackendType::SQLITE, T> : public SqlStatementBase {
+public:
+    // the child rows are deleted by ON DELETE CASCADE
+    static constexpr bool cascade_foreign_key = true;
+
 public: 
     /**
      * @brief create the table statement.
@@ -54,7 +59,8 @@ public:
         std::string sql;
         sql = "CREATE TABLE IF NOT EXISTS \""+ tab_name + "\" (";
 
-        sql += def_names[0] + " " + def_types[0];
+        // the rowid alias must be declared as exactly "INTEGER PRIMARY KEY"
+        sql += def_names[0] + " " + (RowidKeyTrait<T>::value ? std::string("INTEGER") : def_types[0]);
         sql += Cpp2SqlTypeTrait<T>::hasPrimKey ? " PRIMARY KEY" : "";
         for (std::size_t i = 1; i < def_names.size(); ++i) {
             sql += ", " + def_names[i] + " " + def_types[i];
@@ -234,6 +240,51 @@ public:
     } // scanStatement
 
 
+    /**
+     * @brief Generate the scan statement of the selected columns only
+     * @param tab_name The table name
+     * @param cols The selected column names
+     * @return The column scan statement
+     */
+    static std::string scanColumnsStatement(const std::string& tab_name,
+            const std::vector<std::string>& cols) {
+        assert(!cols.empty());
+
+        std::string sql = "SELECT ";
+        for (size_t i = 0; i < cols.size(); ++i) {
+            sql += (i > 0 ? ", " : "") + cols[i];
+        }
+        sql += " FROM \"" + tab_name + "\"";
+        return sql += ";";
+    } // scanColumnsStatement
+
+
+    /**
+     * @brief Generate the scan statement on the rowid range [begin, last] with place holders
+     * @return The range scan statement, used to partition the table scan
+     */
+    static std::string rangeScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        std::string sql = projectAllStatement(this_fkc, work_fkc);
+        sql += " WHERE rowid >= ? AND rowid <= ?";
+        return sql += ";";
+    } // rangeScanStatement
+
+
+    /**
+     * @brief Generate the scan statement to dump the table to the snapshot,
+     *     the child table rows are grouped by the foreign key
+     * @return The snapshot scan statement
+     */
+    static std::string snapshotScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc) {
+        std::string sql = projectAllStatement(this_fkc, work_fkc);
+        sql += " ORDER BY ";
+        sql += this_fkc.valid() ? this_fkc.fore_col_name + ", rowid" : "rowid";
+        return sql += ";";
+    } // snapshotScanStatement
+
+
     /**
      * @brief Generate the query statement with place holders using predicate text 
      * @param fk The foreign key columns
@@ -266,6 +317,42 @@ public:
     } // queryPrimaryKeyStatement
 
 
+    /**
+     * @brief Generate the query statement of one column with place holder using primary key
+     * @param tab_name The table name
+     * @param col The column name
+     * @return The query statement of the column using primary key
+     */
+    static std::string queryColumnByKeyStatement(const std::string& tab_name,
+            const std::string& col) {
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        return "SELECT " + col + " FROM \"" + tab_name + "\" WHERE " + pk_name + " = ?;";
+    } // queryColumnByKeyStatement
+
+
+    /**
+     * @brief Generate the query statement with place holders using a batch of primary keys
+     * @param n The number of primary key place holders in "IN (?, ...)"
+     * @return The query statement using primary keys
+     */
+    static std::string queryPrimaryKeysStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc, size_t n) {
+        assert(n > 0);
+        std::string sql = projectAllStatement(this_fkc, work_fkc);
+
+        auto pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        sql += " WHERE " + pk_name + " IN (";
+        for (size_t i = 0; i < n; ++i) {
+            sql += (i > 0 ? ", ?" : "?");
+        }
+        sql += ")";
+
+        return sql += ";";
+    } // queryPrimaryKeysStatement
+
+
     /**
      * @brief Generate the query statement with place holders using foreign key
      * @param fk The foreign key columns
@@ -283,7 +370,172 @@ public:
         return sql += ";";
     } // queryForeignKeyStatement
 
+
+    /**
+     * @brief Generate the scan statement ordered by the column, with optional limit place holder
+     * @param order_col The column to order by, empty or primary key column to order by primary key
+     * @param order The sort order
+     * @param with_limit If true, append "LIMIT ?" to the statement for top-K query
+     * @return The ordered scan statement
+     */
+    static std::string orderedScanStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc,
+            const std::string& order_col, SortOrder order, bool with_limit) {
+        std::string sql = projectAllStatement(this_fkc, work_fkc);
+        sql += orderByClause(order_col, order);
+        sql += (with_limit ? " LIMIT ?" : "");
+        return sql += ";";
+    } // orderedScanStatement
+
+
+    /**
+     * @brief Generate the keyset pagination statement with place holders:
+     *     order by primary key:   [WHERE pk > ?] ORDER BY pk LIMIT ?
+     *     order by column:        WHERE col IS NOT NULL [AND (col, pk) > (?, ?)] ORDER BY col NULLS LAST, pk LIMIT ?
+     *     the NULL column run:    WHERE col IS NULL [AND pk > ?] ORDER BY col NULLS LAST, pk LIMIT ?
+     *   The primary key is the tie breaker, so the page boundary is always unique,
+     *   and the seek is served by the index instead of skipping OFFSET rows.
+     *   The NULL columns come last in both orders and are read as a separate run, so no seek needs OR;
+     *   the explicit IS NOT NULL is kept since DuckDB orders NULL inside a row value comparison.
+     * @param order_col The column to order by, empty or primary key column to order by primary key
+     * @param order The sort order, DESC uses "<" to seek the next page
+     * @param has_after If false, generate the first page statement of the run without seek key
+     * @param null_run If true, read the NULL columns and only the primary key is bound
+     * @return The keyset pagination statement
+     */
+    static std::string keysetPageStatement(
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc,
+            const std::string& order_col, SortOrder order, bool has_after, bool null_run) {
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        const std::string cmp = (order == SortOrder::ASC) ? " > " : " < ";
+
+        std::string sql = projectAllStatement(this_fkc, work_fkc);
+        if (order_col.empty() || (order_col == pk_name)) {
+            sql += (has_after ? " WHERE " + pk_name + cmp + "?" : "");
+        } else if (null_run) {
+            sql += " WHERE " + order_col + " IS NULL";
+            sql += (has_after ? " AND " + pk_name + cmp + "?" : "");
+        } else {
+            sql += " WHERE " + order_col + " IS NOT NULL";
+            sql += (has_after ? " AND (" + order_col + ", " + pk_name + ")" + cmp + "(?, ?)" : "");
+        }
+
+        sql += orderByClause(order_col, order);
+        sql += " LIMIT ?";
+        return sql += ";";
+    } // keysetPageStatement
+
+
+    /**
+     * @brief Generate the create index statement on the table columns
+     * @param tab_name The table name
+     * @param cols The indexed column names, the index name is "[table]_[cols]_idx"
+     * @return The create index statement
+     */
+    static std::string createIndexStatement(const std::string& tab_name,
+            const std::vector<std::string>& cols) {
+        assert(!cols.empty());
+
+        std::string idx_name = tab_name;
+        std::string col_list;
+        for (size_t i = 0; i < cols.size(); ++i) {
+            idx_name += "_" + cols[i];
+            col_list += (i > 0 ? ", " : "") + cols[i];
+        }
+        idx_name += "_idx";
+
+        return "CREATE INDEX IF NOT EXISTS \"" + idx_name + "\" ON \""
+            + tab_name + "\" (" + col_list + ");";
+    } // createIndexStatement
+
+    /**
+     * @brief Collect the columns of the table in the creation order:
+     *     the defined columns, the nested primary key columns and the foreign key column.
+     * @param names The column names.
+     * @param types The column SQL types.
+     * @param this_fkc this foreign key constraint.
+     * @param work_fkc work foreign key constraint.
+     * @param layouts If not nullptr, the blob layouts of the columns, empty if not a blob column.
+     */
+    static void collectTableColumns(std::vector<std::string>& names, std::vector<std::string>& types,
+            const ForeignKeyConstraint& this_fkc, ForeignKeyConstraint& work_fkc,
+            std::vector<std::string>* layouts = nullptr) {
+        collectDefinedColumns(names, types, work_fkc, layouts);
+        collectPrimKeyColumns(names, types, work_fkc);
+        if (this_fkc.valid()) {
+            names.push_back(this_fkc.fore_col_name);
+            types.push_back(this_fkc.key_type);
+        }
+        if (layouts != nullptr) {
+            layouts->resize(names.size()); // the key columns are not blobs
+        }
+    } // collectTableColumns
+
+
+    /**
+     * @brief Generate the statement adding the nullable column to the existing table.
+     * @param tab_name The table name
+     * @param col The column name
+     * @param type The column SQL type
+     * @return The alter table statement
+     */
+    static std::string addColumnStatement(const std::string& tab_name,
+            const std::string& col, const std::string& type) {
+        return "ALTER TABLE \"" + tab_name + "\" ADD COLUMN " + col + " " + type + ";";
+    } // addColumnStatement
+
+
+    /**
+     * @brief Check if the declared type of the column on disk is compatible with the generated one,
+     *     the types of the same affinity are compatible since the values are stored by affinity.
+     * @param disk_type The declared type read from the table
+     * @param def_type The type generated by SqlStatement
+     * @return true if compatible; otherwise, false.
+     */
+    static bool sameColumnType(const std::string& disk_type, const std::string& def_type) {
+        auto upper = [](std::string t) {
+            for (auto &c : t) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            return t;
+        };
+
+        // the affinity rules of https://www.sqlite.org/datatype3.html
+        auto affinity = [](const std::string &t) {
+            if (t.find("INT") != std::string::npos) return 'I';
+            if ((t.find("CHAR") != std::string::npos) || (t.find("CLOB") != std::string::npos) ||
+                (t.find("TEXT") != std::string::npos)) return 'T';
+            if (t.empty() || (t.find("BLOB") != std::string::npos)) return 'B';
+            if ((t.find("REAL") != std::string::npos) || (t.find("FLOA") != std::string::npos) ||
+                (t.find("DOUB") != std::string::npos)) return 'R';
+            return 'N';
+        };
+
+        const std::string d = upper(disk_type), g = upper(def_type);
+        return (d == g) || (affinity(d) == affinity(g));
+    } // sameColumnType
+
+
 private:
+    /**
+     * @brief Generate the order by clause, the primary key is the last sort key,
+     *     the NULL columns come last in both orders, the same on all backends
+     * @param order_col The column to order by, empty or primary key column to order by primary key
+     * @param order The sort order
+     * @return The order by clause with a leading space
+     */
+    static std::string orderByClause(const std::string& order_col, SortOrder order) {
+        const std::string &pk_name =
+            TypeMetaData<T>::column_names()[Config::fk_ref_pk_col_index];
+        const std::string dir = (order == SortOrder::ASC) ? " ASC" : " DESC";
+
+        std::string sql = " ORDER BY ";
+        if (!order_col.empty() && (order_col != pk_name)) {
+            sql += order_col + dir + " NULLS LAST, ";
+        }
+        return sql += pk_name + dir;
+    } // orderByClause
+
+protected:
     /**
      * @brief collect defined column names and types.
      * @param names The column names.
@@ -291,7 +543,7 @@ private:
      * @param work_fkc The working foreign key constraint.
      */
     static void collectDefinedColumns(std::vector<std::string>& names, std::vector<std::string>& types,
-            ForeignKeyConstraint& work_fkc) {
+            ForeignKeyConstraint& work_fkc, std::vector<std::string>* layouts = nullptr) {
         /*
          * get column name and type from TypeMetaData<T>::tuple_type_pair()
          * NOTE:
@@ -299,7 +551,7 @@ private:
          * 2. type: is the SQL type name string, such as "INTEGER", "TEXT", etc.
          */
         const auto vecs = TypeMetaData<T>::tuple_type_pair();
-        boost::fusion::for_each(vecs, ColumnNameType<T>(names, types, work_fkc));
+        boost::fusion::for_each(vecs, ColumnNameType<T>(names, types, work_fkc, layouts));
         assert(names.size() == types.size());
         assert(names.size() > 0);
     } // collectDefinedColumns
@@ -383,10 +635,4 @@ public: // debug
     } // print
 }; // SqlStatementImpl
 
-
-// if Config::backend_type == SQLITE, use SqlStatement4Sqlite as SqlStatement
-template<typename T>
-using SqlStatement = std::enable_if_t< Config::backend_type == DbBackendType::SQLITE,
-        SqlStatementImpl<DbBackendType::SQLITE, T> >;
-
 } // namespace edadb
\ No newline at end of file